@@ -1,7 +1,23 @@
 #ifndef CONSTS_H
 #define CONSTS_H
 
-static const int SAMPLE_RATE = 44100;
-static const int BUFFER_SIZE = 512;
+#include "OutputFormat.h"
 
-#endif
\ No newline at end of file
+// Output format, fixed at build time (see platformio.ini for a hi-res env)
+#ifndef EDULAB_OUTPUT_RATE
+#define EDULAB_OUTPUT_RATE 44100
+#endif
+#ifndef EDULAB_OUTPUT_BITS
+#define EDULAB_OUTPUT_BITS 16
+#endif
+#ifndef EDULAB_OUTPUT_CHANNELS
+#define EDULAB_OUTPUT_CHANNELS 2
+#endif
+
+typedef OutputFormat<EDULAB_OUTPUT_RATE, EDULAB_OUTPUT_BITS, EDULAB_OUTPUT_CHANNELS> AudioFormat;
+
+static const int SAMPLE_RATE = AudioFormat::RATE;
+static const int BLOCK_FRAMES = 256;                                // Mono frames rendered per block
+static const int BUFFER_SIZE = BLOCK_FRAMES * AudioFormat::CHANNELS; // I2S slots per write (interleaved)
+
+#endif
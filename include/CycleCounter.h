@@ -0,0 +1,46 @@
+#ifndef CYCLECOUNTER_H
+#define CYCLECOUNTER_H
+
+#include <stdint.h>
+
+/**
+ * CPU cycle counter access
+ *
+ * On the ESP32-S3 this reads the Xtensa CCOUNT register (one instruction,
+ * safe from ISRs). Each core has its own counter, so only compare values
+ * taken on the same core. Wraps every ~17.9 s at 240 MHz.
+ *
+ * On the host it falls back to a nanosecond clock so the same code can be
+ * benchmarked there.
+ */
+#if defined(__XTENSA__)
+
+#include <Arduino.h>
+
+static inline uint32_t readCycleCounter() {
+    uint32_t cycles;
+    __asm__ __volatile__("rsr %0, ccount" : "=a"(cycles));
+    return cycles;
+}
+
+// Counter ticks per microsecond
+static inline uint32_t cycleCounterMHz() {
+    return getCpuFrequencyMhz();
+}
+
+#else
+
+#include <chrono>
+
+static inline uint32_t readCycleCounter() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static inline uint32_t cycleCounterMHz() {
+    return 1000;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef OUTPUTFORMAT_H
+#define OUTPUTFORMAT_H
+
+#include <stdint.h>
+
+/**
+ * Compile-time description of the I2S output: rate, bit depth, channels
+ *
+ * Each format gets its own conversion (float -> slot word) and interleave
+ * kernel through template specialisation, so the per-sample output loop
+ * has no format branches at all. The firmware picks one format at build
+ * time (AudioFormat in Consts.h, from -D EDULAB_OUTPUT_RATE/BITS/CHANNELS).
+ *
+ * 24-bit output is sent in 32-bit slots, MSB-aligned: a 24-bit DAC clocks
+ * in the top 24 bits and ignores the rest, and the DMA buffer stays word
+ * aligned (no 3-byte packing).
+ */
+
+// ========== Conversion kernels: float [-1, 1] -> I2S slot ==========
+template<int Bits> struct SampleCodec;
+
+template<> struct SampleCodec<16> {
+    typedef int16_t Slot;
+    static inline Slot encode(float sample) { return (Slot)(sample * 32767.0f); }
+    static inline int16_t toInt16(Slot value) { return value; }
+};
+
+template<> struct SampleCodec<24> {
+    typedef int32_t Slot;
+    static inline Slot encode(float sample) { return (Slot)(sample * 8388607.0f) * 256; }
+    static inline int16_t toInt16(Slot value) { return (int16_t)(value >> 16); }
+};
+
+template<> struct SampleCodec<32> {
+    typedef int32_t Slot;
+    // Largest float below 2^31: 2147483647.0f would round up and overflow
+    static inline Slot encode(float sample) { return (Slot)(sample * 2147483520.0f); }
+    static inline int16_t toInt16(Slot value) { return (int16_t)(value >> 16); }
+};
+
+// ========== Interleave kernels: one mono sample -> one frame ==========
+template<typename Slot, int Channels> struct FrameWriter;
+
+template<typename Slot> struct FrameWriter<Slot, 1> {
+    static inline void write(Slot* frame, Slot value) { frame[0] = value; }
+};
+
+template<typename Slot> struct FrameWriter<Slot, 2> {
+    static inline void write(Slot* frame, Slot value) { frame[0] = value; frame[1] = value; }
+};
+
+// ========== Format descriptor ==========
+template<int Rate, int Bits, int Channels>
+struct OutputFormat {
+    static_assert(Rate == 44100 || Rate == 48000 || Rate == 96000, "Supported rates: 44100, 48000, 96000");
+    static_assert(Bits == 16 || Bits == 24 || Bits == 32, "Supported depths: 16, 24, 32 bits");
+    static_assert(Channels == 1 || Channels == 2, "Mono or stereo output");
+
+    typedef SampleCodec<Bits> Codec;
+    typedef typename Codec::Slot Sample;            // One I2S slot in the DMA buffer
+
+    static const int RATE = Rate;
+    static const int BITS = Bits;
+    static const int CHANNELS = Channels;
+    static const int SLOT_BITS = sizeof(Sample) * 8;
+    static const int FRAME_BYTES = sizeof(Sample) * Channels;
+
+    // 44.1 kHz-family rates don't divide the 160 MHz PLL evenly; where the
+    // chip has an audio PLL (ESP32, S2) it gives an exact clock. The S3 has
+    // none and uses the I2S fractional divider instead.
+    static const bool WANTS_APLL = (Rate % 11025) == 0;
+
+    // Sum the inputs, clip and write `frames` interleaved frames
+    static inline void write(const float* const* inputs, int inputCount, Sample* target, int frames) {
+        for (int i = 0; i < frames; i++) {
+            float sample = 0.0f;
+            for (int n = 0; n < inputCount; n++) {
+                sample += inputs[n][i];
+            }
+            writeFrame(target, i, sample);
+        }
+    }
+
+    static inline void writeFrame(Sample* target, int frame, float sample) {
+        // Feedback and reverb can push the sum past full scale
+        sample = sample > 1.0f ? 1.0f : (sample < -1.0f ? -1.0f : sample);
+        FrameWriter<Sample, Channels>::write(target + frame * Channels, Codec::encode(sample));
+    }
+
+    static inline int16_t toInt16(Sample value) { return Codec::toInt16(value); }
+};
+
+#endif
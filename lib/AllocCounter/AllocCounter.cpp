@@ -0,0 +1,85 @@
+#include "AllocCounter.h"
+#include <new>
+
+std::atomic<uint32_t> AllocCounter::total(0);
+std::atomic<uint32_t> AllocCounter::watched(0);
+std::atomic<uint32_t> AllocCounter::news(0);
+std::atomic<uint32_t> AllocCounter::frees(0);
+std::atomic<TaskHandle_t> AllocCounter::watchedTask(nullptr);
+
+// ==========================================
+// LINKER WRAPPERS (-Wl,--wrap=malloc,...)
+// ==========================================
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+
+void* __wrap_malloc(size_t size) {
+    AllocCounter::record();
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    AllocCounter::record();
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    AllocCounter::record();     // Growing a String counts as much as a new one
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void* ptr) {
+    if (ptr) {
+        AllocCounter::recordFree();
+    }
+    __real_free(ptr);
+}
+}
+
+// ==========================================
+// OPERATOR NEW (replaces the libstdc++ one)
+// ==========================================
+// Same as the default: malloc, which is counted above as well. Nothing in
+// the firmware catches bad_alloc, so running out aborts right here instead.
+void* operator new(size_t size) {
+    AllocCounter::recordNew();
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr) {
+        abort();
+    }
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    AllocCounter::recordNew();
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return operator new(size, std::nothrow);
+}
+
+// The matching deletes, so every pair goes through the same allocator
+// (the libstdc++ ones do call free(), but a sanitizer's don't)
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    free(ptr);
+}
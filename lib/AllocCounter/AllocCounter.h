@@ -0,0 +1,80 @@
+#ifndef ALLOCCOUNTER_H
+#define ALLOCCOUNTER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "Log.h"
+
+/**
+ * Heap allocation counter
+ *
+ * The linker wraps malloc/calloc/realloc (-Wl,--wrap=..., see
+ * platformio.ini), so every allocation through the C heap - including
+ * operator new and Arduino String - passes through here and is counted.
+ * Explicit heap_caps_malloc() calls (PSRAM lines, tables) are not counted:
+ * those are deliberate, one-off allocations at startup. operator new is
+ * also replaced so C++ allocations can be told apart from C ones, and
+ * free() is wrapped to see whether allocations are ever returned.
+ *
+ * One task can be watched separately, so code that must be allocation-free
+ * in steady state (the UI frame) can check itself without noise from other
+ * tasks:
+ *
+ *   uint32_t before = AllocCounter::getWatched();
+ *   ...render...
+ *   ALLOC_CHECK_NONE_SINCE(before, "[DISP] frame");
+ */
+class AllocCounter {
+private:
+    static std::atomic<uint32_t> total;
+    static std::atomic<uint32_t> watched;
+    static std::atomic<uint32_t> news;
+    static std::atomic<uint32_t> frees;
+    static std::atomic<TaskHandle_t> watchedTask;      // Set while other tasks allocate
+
+public:
+    static void watch(TaskHandle_t task) { watchedTask.store(task, std::memory_order_relaxed); }
+
+    static uint32_t getTotal() { return total.load(std::memory_order_relaxed); }
+    static uint32_t getWatched() { return watched.load(std::memory_order_relaxed); }
+    static uint32_t getNews() { return news.load(std::memory_order_relaxed); }
+    static uint32_t getFrees() { return frees.load(std::memory_order_relaxed); }
+
+    // Called by the malloc wrappers
+    static inline void record() {
+        total.fetch_add(1, std::memory_order_relaxed);
+        TaskHandle_t task = watchedTask.load(std::memory_order_relaxed);
+        if (task && xTaskGetCurrentTaskHandle() == task) {
+            watched.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    static inline void recordNew() { news.fetch_add(1, std::memory_order_relaxed); }
+    static inline void recordFree() { frees.fetch_add(1, std::memory_order_relaxed); }
+};
+
+/**
+ * Steady-state check: no allocations on the watched task since `before`.
+ * Logs every violation; with -D EDULAB_STRICT_ALLOC it also aborts, so a
+ * regression can't slip through a bench/debug build unnoticed.
+ */
+#ifdef EDULAB_STRICT_ALLOC
+#define ALLOC_CHECK_NONE_SINCE(before, what) do { \
+        uint32_t allocs_ = AllocCounter::getWatched() - (before); \
+        if (allocs_) { \
+            LOG("%s: %lu heap allocations", what, (unsigned long)allocs_); \
+            configASSERT(allocs_ == 0); \
+        } \
+    } while (0)
+#else
+#define ALLOC_CHECK_NONE_SINCE(before, what) do { \
+        uint32_t allocs_ = AllocCounter::getWatched() - (before); \
+        if (allocs_) { \
+            LOG("%s: %lu heap allocations", what, (unsigned long)allocs_); \
+        } \
+    } while (0)
+#endif
+
+#endif
@@ -3,30 +3,109 @@
 #include "Potentiometer.h"
 #include "Voice.h"
 #include <Arduino.h>
-#include "driver/i2s.h"
+#if !AUDIO_ZERO_COPY
+#include "driver/i2s.h"         // Legacy driver: IDF 5 aborts if both drivers are linked
+#endif
+#include "soc/soc_caps.h"
+#include "esp_timer.h"
+#include "Log.h"
+#include "Console.h"
+#include "LatencyTrace.h"
+#include "Profiler.h"
+#include "../../include/CycleCounter.h"
 #include "Waveforms/Waveforms.h"
 #include "../../include/Utils.h"
 #include "../../include/Consts.h"
 
 
 
+AudioEngine* AudioEngine::instance = nullptr;
+
 AudioEngine::AudioEngine(int bck, int lrck, int din)
-    : audioState(NORMAL_PLAYBACK), feedbackSamplesRemaining(0), feedbackFrequency(0),
-      I2S_BCK_PIN(bck), I2S_LRCK_PIN(lrck), I2S_DIN_PIN(din) {
+    : I2S_BCK_PIN(bck), I2S_LRCK_PIN(lrck), I2S_DIN_PIN(din),
+      i2sEvents(nullptr), dmaQueuedFrames(0), blockFrames(BLOCK_FRAMES), expectStarved(true),
+      blockRendered(false), lastBlockCycles(0), fmPatch(0), voicesSlot(-1), workerSlot(-1), blockSlot(-1),
+      sequenceEventCount(0), sequencing(false), sequenceAudible(false), sequenceBase(0.0f), sequenceRatio(1.0f),
+      renderBarrier(GROUPS), workerHandle(nullptr), workerCycles(0), uiLoadPermille(0), dualCoreActive(false),
+      controlRate(32), blockControlRate(32), baseCutoff(20000.0f), potPitchValue(0.0f), potToneValue(0.0f),
+      audioState(NORMAL_PLAYBACK), feedbackSamplesRemaining(0), feedbackFrequency(0),
+      firstBlockTimeUs(0), firstBlockLogged(false), audioTask(nullptr), silentBlocks(0), parked(false), parkCount(0) {
+    for (int i = 0; i < VOICE_COUNT; i++) {
+        baseFrequency[i] = 0.0f;
+        baseWavetablePosition[i] = 0.5f;
+    }
+    for (int i = 0; i < 4; i++) {
+        controlChanges[i].store(0.0f);
+    }
+#if AUDIO_ZERO_COPY
+    audioBuffer = nullptr;
+    txChannel = nullptr;
+#endif
 }
 
 
 void AudioEngine::begin() {
+#if AUDIO_ZERO_COPY
+    // Channel driver, TX only. auto_clear stays off: onDmaSent() clears
+    // each buffer before the task can be handed it (see DmaRing).
+    i2s_chan_config_t channelConfig = I2S_CHANNEL_DEFAULT_CONFIG(I2S_NUM_0, I2S_ROLE_MASTER);
+    channelConfig.dma_desc_num = ZC_BUFFERS;
+    channelConfig.dma_frame_num = ZC_FRAMES;
+    channelConfig.auto_clear = false;
+
+    // A plain variable: the default-config macro doesn't parenthesise its argument
+    const i2s_slot_mode_t slotMode = AudioFormat::CHANNELS == 2 ? I2S_SLOT_MODE_STEREO : I2S_SLOT_MODE_MONO;
+    i2s_std_config_t stdConfig = {
+        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(SAMPLE_RATE),
+        .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG((i2s_data_bit_width_t)AudioFormat::SLOT_BITS, slotMode),
+        .gpio_cfg = {
+            .mclk = I2S_GPIO_UNUSED,
+            .bclk = (gpio_num_t)I2S_BCK_PIN,
+            .ws = (gpio_num_t)I2S_LRCK_PIN,
+            .dout = (gpio_num_t)I2S_DIN_PIN,
+            .din = I2S_GPIO_UNUSED,
+            .invert_flags = { .mclk_inv = false, .bclk_inv = false, .ws_inv = false },
+        },
+    };
+    if (AudioFormat::CHANNELS == 1) {
+        stdConfig.slot_cfg.slot_mask = I2S_STD_SLOT_LEFT;
+    }
+
+    i2s_event_callbacks_t callbacks = {};
+    callbacks.on_sent = onDmaSent;
+
+    dmaRing.begin(ZC_BUFFERS, ZC_FRAMES * AudioFormat::FRAME_BYTES);
+    esp_err_t err = i2s_new_channel(&channelConfig, &txChannel, nullptr);
+    if (err == ESP_OK) {
+        err = i2s_channel_init_std_mode(txChannel, &stdConfig);
+    }
+    if (err == ESP_OK) {
+        err = i2s_channel_register_event_callback(txChannel, &callbacks, this);
+    }
+    if (err == ESP_OK) {
+        err = i2s_channel_enable(txChannel);
+    }
+    if (err != ESP_OK) {
+        LOG("[AUDIO] I2S channel setup failed: %s", esp_err_to_name(err));
+    }
+#else
+#ifdef SOC_I2S_SUPPORTS_APLL
+    const bool useApll = AudioFormat::WANTS_APLL;
+#else
+    const bool useApll = false;     // No audio PLL on the S3
+#endif
+    const i2s_bits_per_sample_t slotBits = (i2s_bits_per_sample_t)AudioFormat::SLOT_BITS;
+
     i2s_config_t i2s_config = {
         .mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_TX),
         .sample_rate = SAMPLE_RATE,
-        .bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT, 
-        .channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT, 
+        .bits_per_sample = slotBits, 
+        .channel_format = AudioFormat::CHANNELS == 2 ? I2S_CHANNEL_FMT_RIGHT_LEFT : I2S_CHANNEL_FMT_ONLY_LEFT, 
         .communication_format = I2S_COMM_FORMAT_STAND_I2S, 
         .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1, 
-        .dma_buf_count = 8, 
-        .dma_buf_len = 64, 
-        .use_apll = false, 
+        .dma_buf_count = DMA_BUFFERS, 
+        .dma_buf_len = DMA_FRAMES, 
+        .use_apll = useApll, 
         .tx_desc_auto_clear = true 
     };
 
@@ -37,9 +116,13 @@ void AudioEngine::begin() {
     .data_in_num = I2S_PIN_NO_CHANGE 
     };
 
-    i2s_driver_install(I2S_NUM_0, &i2s_config, 0, NULL);
+    i2s_driver_install(I2S_NUM_0, &i2s_config, DMA_EVENT_QUEUE, &i2sEvents);
     i2s_set_pin(I2S_NUM_0, &pin_config);
-    i2s_set_clk(I2S_NUM_0, SAMPLE_RATE, I2S_BITS_PER_SAMPLE_16BIT, I2S_CHANNEL_STEREO);
+    i2s_set_clk(I2S_NUM_0, SAMPLE_RATE, slotBits,
+                AudioFormat::CHANNELS == 2 ? I2S_CHANNEL_STEREO : I2S_CHANNEL_MONO);
+#endif
+
+    FmVoice::buildSineTable();
 
     waveforms[0] = new SineWave();
     waveforms[1] = new TriangleWave();
@@ -47,9 +130,65 @@ void AudioEngine::begin() {
     waveforms[3] = new SawWave();
     waveforms[4] = new NoiseWave();
 
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < VOICE_COUNT; i++) {
         voices[i] = Voice(waveforms[0], 0.0f, 0.0f);
+        wavetableOscs[i].setTable(&wavetable);
+        unisonFirst[i] = oscillatorBank.allocate(OscillatorBank::MAX_UNISON);
     }
+    for (int i = 0; i < PLUCK_VOICES; i++) {
+        if (!plucks[i].begin()) {
+            LOG("[AUDIO] No internal RAM for pluck voice %d", i);
+        }
+    }
+
+    // Mapping the sample partition is just an MMU setup, no data is read.
+    // A wavetable asset in the bank replaces the built-in shapes; tables
+    // stay in flash (PCM or ADPCM) and are decoded into the voice caches.
+    bool bankTable = false;
+    if (sampleStore.begin()) {
+        int tableIndex = sampleStore.findByKind(SAMPLE_KIND_WAVETABLE);
+        if (tableIndex >= 0) {
+            bankTable = wavetable.loadFromBank(sampleStore.getInfo(tableIndex),
+                                               sampleStore.getData(tableIndex));
+        }
+
+        int sampleIndex = sampleStore.findByKind(SAMPLE_KIND_SAMPLE);
+        for (int i = 0; i < VOICE_COUNT && sampleIndex >= 0; i++) {
+            setSample(i, sampleIndex);
+        }
+    }
+
+    // Tables take a few hundred ms to build; don't hold up the audio start
+    if (!bankTable) {
+        wavetable.buildAsync(1, 1);
+    }
+
+    // Load figures: voices, then one slot per effect, then the whole block
+    loadMeter.begin();
+    voicesSlot = loadMeter.addSlot("voices");
+    workerSlot = loadMeter.addSlot("core1");
+    effectsBus.begin(&loadMeter);
+    blockSlot = loadMeter.addSlot("block");
+
+    buildGraph();
+
+    // Renders voice group 1 when the policy splits a block over both cores.
+    // Above loop() and the pot sampler so the UI can't make it late.
+    xTaskCreatePinnedToCore(renderWorkerTask, "RenderWorker", 4096, this, 4, &workerHandle, 1);
+
+    instance = this;
+    Console::addCommand("render", "voice rendering: single|dual|auto core split", renderCommand);
+    Console::addCommand("fx", "effects bus: fx <name> on|off", fxCommand);
+    Console::addCommand("seq", "sequencer: off|steps|up|down|updown, tempo, gate, step, len, chord", seqCommand);
+    Console::addCommand("fm", "FM voice patch: fm <preset>", fmCommand);
+    Console::addCommand("mod", "modulation: routes, mod rate <samples>, mod cc <1-4> <0-127>", modCommand);
+    Console::addCommand("buf", "output buffering: level, underruns (buf auto | buf <0-4>)", bufCommand);
+
+    // Default patch: slow morph through the wavetable frames
+    lfos[0].setShape(Lfo::TRIANGLE);
+    lfos[0].setRate(0.2f);
+    lfos[1].setRate(5.0f);
+    modMatrix.setRoute(0, ModMatrix::SRC_LFO1, ModMatrix::DST_WT_POSITION, 0.5f);
 
     //test to see if polyphony works
     float freq = 440.0f; // A4
@@ -57,53 +196,117 @@ void AudioEngine::begin() {
     noteOn(1, 1.25 * freq, 1.0f); 
     noteOn(2, 1.5 * freq, 1.0f); 
 
-    Serial.println("I2S Initialized!");
+    LOG("I2S Initialized: %d Hz, %d-bit in %d-bit slots, %d ch",
+        SAMPLE_RATE, AudioFormat::BITS, AudioFormat::SLOT_BITS, AudioFormat::CHANNELS);
 }
 
 void AudioEngine::update(const StateMachine &stateMachine, const Potentiometer &potPitch, const Potentiometer &potTone) {
-    size_t bytes_written;
+    PROFILE_SCOPE("AudioEngine::update");
+
+    if (!audioTask) {
+        audioTask = xTaskGetCurrentTaskHandle();
+    }
+
+    // Nothing but silence for a while: stop producing it. A block is
+    // rendered after every wake-up; if that is silent too, park again.
+    // The sequencer's clock counts output samples, so while its voice can
+    // be heard it keeps the task awake through the rests; muted, it stops
+    // with the task and carries on from the same step.
+    if (silentBlocks >= PARK_AFTER_BLOCKS && audioState != FEEDBACK_TONE && !(sequencing && sequenceAudible)) {
+        park();
+    }
+
+#if AUDIO_ZERO_COPY
+    // Render in place: wait for the DMA to free the next buffer first, so
+    // the controls below are read as late as possible
+    if (!acquireBuffer()) {
+        return;
+    }
+#endif
+
+    // This block is the first to see any input loop() handled until now
+    LatencyTrace::beginBlock();
+
+    // Block size for this update, as the buffer controller last decided
+#if AUDIO_ZERO_COPY
+    blockFrames = ZC_FRAMES;
+#else
+    blockFrames = bufferController.getBlockFrames();
+#endif
+
     StateMachine::State currentState = stateMachine.getState();
     float vol = potTone.getValue() / 4095.0f;
+    potPitchValue = potPitch.getValue() / 4095.0f;
+    potToneValue = vol;
     setMasterVolume(vol * 0.5f); 
 
+    // Every block moves the sequencer on by its frames, rendered or not,
+    // so feedback tones and menus don't shift the pattern
+    int selectedMode = stateMachine.getMenu().getSelectedMode();
+    sequenceAudible = currentState != StateMachine::MUTE && selectedMode >= 0 && selectedMode < Menu::ITEM_COUNT;
+
     if (audioState == FEEDBACK_TONE) {
+        skipSequencer();
         fillFeedbackBuffer();
-        i2s_write(I2S_NUM_0, audioBuffer, sizeof(audioBuffer), &bytes_written, portMAX_DELAY);
+        writeBuffer();
         return;
     }
 
     if (currentState == StateMachine::MUTE) {
-        memset(audioBuffer, 0, sizeof(audioBuffer));
-        i2s_write(I2S_NUM_0, audioBuffer, sizeof(audioBuffer), &bytes_written, portMAX_DELAY);
+        skipSequencer();
+        memset(audioBuffer, 0, blockFrames * AudioFormat::FRAME_BYTES);
+        writeBuffer();
         return;
     }
 
-    int selectedMode = stateMachine.getMenu().getSelectedMode();
-
     if (selectedMode == -1) {
-        memset(audioBuffer, 0, sizeof(audioBuffer));
-        i2s_write(I2S_NUM_0, audioBuffer, sizeof(audioBuffer), &bytes_written, portMAX_DELAY);
+        skipSequencer();
+        memset(audioBuffer, 0, blockFrames * AudioFormat::FRAME_BYTES);
+        writeBuffer();
         return;
     }
 
-    if (selectedMode >= 0 && selectedMode < 5) {
+    if (selectedMode == Menu::WAVETABLE) {
+        for (int i = 0; i < 3; i++) {
+            voices[i].setWavetable(&wavetableOscs[i]);
+        }
+    } else if (selectedMode == Menu::SAMPLE) {
+        for (int i = 0; i < 3; i++) {
+            voices[i].setSamplePlayer(&samplePlayers[i]);
+        }
+    } else if (selectedMode == Menu::SUPERSAW) {
+        for (int i = 0; i < 3; i++) {
+            voices[i].setSupersaw(&oscillatorBank, unisonFirst[i]);
+        }
+    } else if (selectedMode == Menu::FM) {
+        for (int i = 0; i < 3; i++) {
+            voices[i].setFm(&fmVoices[i]);
+        }
+    } else if (selectedMode == Menu::PLUCK) {
+        for (int i = 0; i < PLUCK_VOICES; i++) {
+            voices[i].setPluck(&plucks[i]);
+        }
+    } else if (selectedMode >= 0 && selectedMode < 5) {
         //setWaveform(selectedMode, waveforms[selectedMode]);
         //test to see if polyphony works with different frequencies
         setWaveform(0, waveforms[selectedMode]);
         setWaveform(1, waveforms[selectedMode]);
         setWaveform(2, waveforms[selectedMode]);
     } else {
-        memset(audioBuffer, 0, sizeof(audioBuffer));
-        i2s_write(I2S_NUM_0, audioBuffer, sizeof(audioBuffer), &bytes_written, portMAX_DELAY);
+        skipSequencer();
+        memset(audioBuffer, 0, blockFrames * AudioFormat::FRAME_BYTES);
+        writeBuffer();
         return;
     }
 
-    int maxFreq = (selectedMode == 4) ? 5000 : 20000; // 4 is NOISE
+    // NOISE and PLUCK top out at 5 kHz (a pluck needs a few samples of loop)
+    int maxFreq = (selectedMode == Menu::NOISE || selectedMode == Menu::PLUCK) ? 5000 : 20000;
     
     
     //test to see if polyphony works with different frequencies
     float baseFreq = mapLogarithmicAsymmetric(potPitch.getValue(), 20.0f, maxFreq);
-    setFrequency(0, baseFreq);
+    sequenceBase = baseFreq;
+    setFrequency(0, sequencing ? baseFreq * sequenceRatio : baseFreq);
     setFrequency(1, 1.25 * baseFreq);
     setFrequency(2, 1.5 * baseFreq);
     
@@ -111,14 +314,151 @@ void AudioEngine::update(const StateMachine &stateMachine, const Potentiometer &
     
 
     fillBuffer();
-    i2s_write(I2S_NUM_0, audioBuffer, sizeof(audioBuffer), &bytes_written, portMAX_DELAY);
+    writeBuffer();
+}
+
+void AudioEngine::writeBuffer() {
+    PROFILE_SCOPE("AudioEngine::writeBuffer");
+
+    // Whatever reaches the DAC, including mute and feedback tones
+    scopeTap.write<AudioFormat>(audioBuffer, blockFrames);
+
+    // Silence covers mute, no mode, idle voices and a decayed effects tail alike
+    const uint32_t* words = (const uint32_t*)audioBuffer;
+    uint32_t any = 0;
+    const size_t wordCount = blockFrames * AudioFormat::CHANNELS * sizeof(AudioFormat::Sample) / 4;
+    for (size_t i = 0; i < wordCount; i++) {
+        any |= words[i];
+    }
+    if (any) {
+        if (parked) {
+            parked = false;
+            LOG("[AUDIO] Resumed");
+        }
+        silentBlocks = 0;
+    } else if (silentBlocks < PARK_AFTER_BLOCKS) {
+        silentBlocks++;
+    }
+
+#if AUDIO_ZERO_COPY
+    // Already in the DMA buffer: only the bookkeeping is left. The ring
+    // counts a block that missed its slot, or the skip after a stall, as
+    // an underrun; skipping the buffers that played out during a park is
+    // expected.
+    uint32_t underrunsBefore = dmaRing.getUnderruns();
+    dmaRing.commit(expectStarved);
+    bool underrun = dmaRing.getUnderruns() != underrunsBefore;
+    expectStarved = false;
+    uint32_t queuedAhead = dmaRing.getBuffersAhead() * ZC_FRAMES;
+    dmaQueuedFrames = queuedAhead + blockFrames;
+    LatencyTrace::endBlock(queuedAhead);
+
+    if (underrun) {
+        LOG("[AUDIO] DMA underrun (%lu)", (unsigned long)dmaRing.getUnderruns());
+    }
+    blockRendered = false;
+#else
+    // Frames still queued in the DMA: what we wrote minus what TX_DONE
+    // events report played. Wait for it to drain to the level's depth,
+    // which is what sets the output latency (the ring itself is sized
+    // for the deepest level).
+    i2s_event_t event;
+    while (i2sEvents && xQueueReceive(i2sEvents, &event, 0) == pdTRUE) {
+        if (event.type == I2S_EVENT_TX_DONE) {
+            dmaQueuedFrames -= DMA_FRAMES;
+        }
+    }
+    while (i2sEvents && dmaQueuedFrames > (int32_t)bufferController.getQueueFrames() &&
+           xQueueReceive(i2sEvents, &event, pdMS_TO_TICKS(DMA_WAIT_MS)) == pdTRUE) {
+        if (event.type == I2S_EVENT_TX_DONE) {
+            dmaQueuedFrames -= DMA_FRAMES;
+        }
+    }
+
+    // Played more than we wrote: the DMA ran dry and sent auto-cleared
+    // buffers. Expected at boot and after parking, a glitch otherwise.
+    bool underrun = dmaQueuedFrames < 0 && !expectStarved;
+    if (dmaQueuedFrames < 0) {
+        dmaQueuedFrames = 0;
+    }
+    expectStarved = false;
+    uint32_t queuedAhead = dmaQueuedFrames;
+
+    size_t bytes_written;
+    i2s_write(I2S_NUM_0, audioBuffer, blockFrames * AudioFormat::CHANNELS * sizeof(AudioFormat::Sample),
+              &bytes_written, portMAX_DELAY);
+    dmaQueuedFrames += blockFrames;
+    LatencyTrace::endBlock(queuedAhead);
+
+    // Only rendered blocks carry a meaningful load; silence would talk
+    // the controller down to a depth the next note can't hold
+    if (blockRendered) {
+        uint32_t budget = loadMeter.getBudgetCycles(blockFrames);
+        uint32_t load = (uint32_t)((uint64_t)lastBlockCycles * 1000 / budget);
+        if (bufferController.report(blockFrames, load, underrun)) {
+            const BufferController::Level& level = BufferController::level(bufferController.getLevel());
+            LOG("[AUDIO] Buffer level %d: %d-frame blocks, %d frames queued%s", bufferController.getLevel(),
+                level.blockFrames, level.queueFrames, underrun ? " (underrun)" : "");
+        }
+    } else if (underrun) {
+        bufferController.report(blockFrames, 0, true);
+    }
+    blockRendered = false;
+#endif
+
+    // Boot metric: time from reset until the first block reaches the DMA
+    if (!firstBlockLogged) {
+        firstBlockLogged = true;
+        firstBlockTimeUs = esp_timer_get_time();
+        LOG("[Boot] First audio block queued %lu us after reset", (unsigned long)firstBlockTimeUs);
+    }
 }
 
+#if AUDIO_ZERO_COPY
+bool AudioEngine::acquireBuffer() {
+    // Anything else that notifies the task (a wake() meant for park())
+    // just means checking again
+    TickType_t start = xTaskGetTickCount();
+    while (true) {
+        void* buffer = dmaRing.acquire();
+        if (!buffer) {
+            dmaRing.prepareWait();
+            buffer = dmaRing.acquire();
+            if (buffer) {
+                dmaRing.cancelWait();
+            }
+        }
+        if (buffer) {
+            audioBuffer = (AudioFormat::Sample*)buffer;
+            return true;
+        }
+        // A stalled DMA can't hang the task
+        if (xTaskGetTickCount() - start >= pdMS_TO_TICKS(DMA_WAIT_MS)) {
+            dmaRing.cancelWait();
+            return false;
+        }
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(DMA_WAIT_MS));
+    }
+}
+
+bool IRAM_ATTR AudioEngine::onDmaSent(i2s_chan_handle_t channel, i2s_event_data_t* event, void* context) {
+    AudioEngine* engine = (AudioEngine*)context;
+    // event->data points at the descriptor's buffer pointer
+    if (!engine->dmaRing.onSent(*(void**)event->data) || !engine->audioTask) {
+        return false;
+    }
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(engine->audioTask, &woken);
+    return woken == pdTRUE;
+}
+#endif
+
 void AudioEngine::setWaveform(int voiceIndex, WaveformGenerator* waveform) {
     voices[voiceIndex].setWaveform(waveform);
 }
 
 void AudioEngine::setFrequency(int voiceIndex, float freq) {
+    baseFrequency[voiceIndex] = freq;
     voices[voiceIndex].setFrequency(freq);
 }
 
@@ -126,46 +466,605 @@ void AudioEngine::setAmplitude(int voiceIndex, float amp) {
     voices[voiceIndex].setAmplitude(amp);
 }
 
+void AudioEngine::buildGraph() {
+    // Group graphs: each renders its share of the voices into a private buffer
+    for (int g = 0; g < GROUPS; g++) {
+        AudioGraph& group = voiceGraphs[g];
+        group.clear();
+        group.setLoadMeter(&loadMeter);     // Only used when rendered on Core 0
+
+        int mixerId = group.addNode(&groupMixers[g]);
+        int captureId = group.addNode(&captures[g]);
+        group.connect(mixerId, captureId);
+
+        for (int i = 0; i < VOICE_COUNT; i++) {
+            if (RenderPolicy::groupOf(i) != g) {
+                continue;
+            }
+            voiceNodes[i].setVoice(&voices[i]);
+            int voiceId = group.addNode(&voiceNodes[i]);
+            int envelopeId = group.addNode(&envelopes[i]);
+            group.connect(voiceId, envelopeId);
+            group.connect(envelopeId, mixerId);
+            group.setMeterSlot(voiceId, voicesSlot);
+            group.setMeterSlot(envelopeId, voicesSlot);
+        }
+        group.compile();
+    }
+
+    // Main graph: sum of the groups through the shared processing
+    graph.clear();
+    graph.setLoadMeter(&loadMeter);
+
+    effectNode.setBus(&effectsBus);     // Meters its own effects
+    outputNode.setTarget(audioBuffer);
+
+    int inputId = graph.addNode(&busInput);
+    int filterId = graph.addNode(&filter);
+    int effectId = graph.addNode(&effectNode);
+    int outputId = graph.addNode(&outputNode);
+    graph.connect(inputId, filterId);
+    graph.connect(filterId, effectId);
+    graph.connect(effectId, outputId);
+
+    graph.compile();
+}
+
+void AudioEngine::setUnison(int count, float detune, float mix) {
+    for (int i = 0; i < VOICE_COUNT; i++) {
+        voices[i].setUnison(count, detune, mix);
+    }
+}
+
+bool AudioEngine::setFmPatch(int preset) {
+    if (preset < 0 || preset >= FmVoice::PRESET_COUNT) {
+        return false;
+    }
+    // The voices read their patch while rendering, so the audio task
+    // swaps it between blocks (applyFmPatch). False if the queue is full.
+    return fmPatchRequests.push((int8_t)preset);
+}
+
+void AudioEngine::applyFmPatch() {
+    int8_t preset;
+    while (fmPatchRequests.pop(preset)) {
+        // Notes keep their envelopes and phases
+        for (int i = 0; i < VOICE_COUNT; i++) {
+            fmVoices[i].setPatch(FmVoice::PRESETS[preset]);
+        }
+        fmPatch.store(preset, std::memory_order_relaxed);
+    }
+}
+
+void AudioEngine::setPluckDecay(float amount) {
+    for (int i = 0; i < PLUCK_VOICES; i++) {
+        plucks[i].setDecay(amount);     // Retunes on the next block
+    }
+}
+
+void AudioEngine::setWavetablePosition(int voiceIndex, float position) {
+    baseWavetablePosition[voiceIndex] = position;
+    voices[voiceIndex].setWavetablePosition(position);
+}
+
+bool AudioEngine::setControlRate(int samples) {
+    // Must split a block into whole slices
+    if (samples < 8 || samples > BLOCK_FRAMES || (samples & (samples - 1)) != 0) {
+        return false;
+    }
+    controlRate = samples;
+    return true;
+}
+
+void AudioEngine::setControlChange(int slot, int value) {
+    if (slot >= 0 && slot < 4) {
+        controlChanges[slot].store(constrain(value, 0, 127) / 127.0f, std::memory_order_relaxed);
+    }
+}
+
+void AudioEngine::prepareControl(int slices) {
+    // LFOs advance once per slice on Core 0; both cores read these values
+    for (int s = 0; s < slices; s++) {
+        sliceLfo[s][0] = lfos[0].advance(blockControlRate);
+        sliceLfo[s][1] = lfos[1].advance(blockControlRate);
+    }
+}
+
+void AudioEngine::modulateVoices(int group, int slice) {
+    float sources[ModMatrix::SOURCE_COUNT];
+    sources[ModMatrix::SRC_LFO1] = sliceLfo[slice][0];
+    sources[ModMatrix::SRC_LFO2] = sliceLfo[slice][1];
+    sources[ModMatrix::SRC_POT_PITCH] = potPitchValue;
+    sources[ModMatrix::SRC_POT_TONE] = potToneValue;
+    for (int i = 0; i < 4; i++) {
+        sources[ModMatrix::SRC_CC1 + i] = controlChanges[i].load(std::memory_order_relaxed);
+    }
+
+    uint32_t mask = modMatrix.getDestinationMask();
+    float offsets[ModMatrix::DESTINATION_COUNT];
+    float loudestEnvelope = 0.0f;
+
+    for (int i = 0; i < VOICE_COUNT; i++) {
+        if (RenderPolicy::groupOf(i) != group || !voices[i].getIsActive()) {
+            continue;
+        }
+        loudestEnvelope = max(loudestEnvelope, envelopes[i].getLevel());
+
+        // Unrouted destinations fall back to their base values (pitch is
+        // reset by setFrequency() every block anyway)
+        sources[ModMatrix::SRC_ENVELOPE] = envelopes[i].getLevel();
+        if (mask != 0) {
+            modMatrix.evaluate(sources, offsets);
+        }
+
+        if (mask & (1UL << ModMatrix::DST_PITCH)) {
+            voices[i].setFrequency(baseFrequency[i] * exp2f(offsets[ModMatrix::DST_PITCH]));
+        }
+
+        float gain = 1.0f;
+        if (mask & (1UL << ModMatrix::DST_AMPLITUDE)) {
+            gain = constrain(1.0f + offsets[ModMatrix::DST_AMPLITUDE], 0.0f, 2.0f);
+        }
+        voiceNodes[i].setGain(gain);
+
+        float position = baseWavetablePosition[i];
+        if (mask & (1UL << ModMatrix::DST_WT_POSITION)) {
+            position = constrain(position + offsets[ModMatrix::DST_WT_POSITION], 0.0f, 1.0f);
+        }
+        voices[i].setWavetablePosition(position);
+    }
+
+    sliceEnvelope[group][slice] = loudestEnvelope;
+}
+
+void AudioEngine::modulateFilter(int slice) {
+    // One filter for the whole mix: its envelope source is the loudest voice
+    float cutoff = baseCutoff;
+    if (modMatrix.getDestinationMask() & (1UL << ModMatrix::DST_CUTOFF)) {
+        float sources[ModMatrix::SOURCE_COUNT];
+        float offsets[ModMatrix::DESTINATION_COUNT];
+        sources[ModMatrix::SRC_LFO1] = sliceLfo[slice][0];
+        sources[ModMatrix::SRC_LFO2] = sliceLfo[slice][1];
+        sources[ModMatrix::SRC_ENVELOPE] = max(sliceEnvelope[0][slice], sliceEnvelope[1][slice]);
+        sources[ModMatrix::SRC_POT_PITCH] = potPitchValue;
+        sources[ModMatrix::SRC_POT_TONE] = potToneValue;
+        for (int i = 0; i < 4; i++) {
+            sources[ModMatrix::SRC_CC1 + i] = controlChanges[i].load(std::memory_order_relaxed);
+        }
+        modMatrix.evaluate(sources, offsets);
+        cutoff *= exp2f(offsets[ModMatrix::DST_CUTOFF]);
+    }
+    filter.setCutoff(cutoff);
+}
+
+void AudioEngine::renderGroup(int group) {
+    PROFILE_SCOPE("AudioEngine::renderGroup");
+    int slice = blockControlRate;
+    bool sequenced = RenderPolicy::groupOf(SEQUENCED_VOICE) == group;
+    int nextEvent = 0;
+
+    for (int offset = 0, s = 0; offset < blockFrames; offset += slice, s++) {
+        modulateVoices(group, s);
+
+        // Sequencer events split the slice on their exact sample
+        int done = 0;
+        while (sequenced && nextEvent < sequenceEventCount &&
+               sequenceEvents[nextEvent].offset < offset + slice) {
+            int at = sequenceEvents[nextEvent].offset - offset;
+            if (at > done) {
+                captures[group].setTarget(groupBuffers[group] + offset + done);
+                voiceGraphs[group].render(at - done);
+                done = at;
+            }
+            applySequenceEvent(sequenceEvents[nextEvent++]);
+        }
+
+        captures[group].setTarget(groupBuffers[group] + offset + done);
+        voiceGraphs[group].render(slice - done);
+    }
+}
+
+void AudioEngine::runSequencer() {
+    bool wasSequencing = sequencing;
+    sequenceEventCount = sequencer.process(blockFrames, sequenceEvents, Sequencer::MAX_EVENTS);
+    sequencing = sequencer.isRunning();
+
+    if (sequencing && !wasSequencing) {
+        // The sequence takes over: the drone voices fade out, voice 0 waits for its first step
+        for (int i = 0; i < 3; i++) {
+            noteOff(i);
+        }
+    } else if (!sequencing && wasSequencing) {
+        // Back to the pot-controlled drone
+        sequenceEventCount = 0;
+        sequenceRatio = 1.0f;
+        for (int i = 0; i < 3; i++) {
+            voices[i].noteOn(baseFrequency[i], 1.0f);
+            envelopes[i].gate(true);
+        }
+    }
+}
+
+void AudioEngine::skipSequencer() {
+    runSequencer();
+    // Nothing renders this block: its steps take effect at once, so the
+    // voice is in the right state when rendering resumes
+    for (int i = 0; i < sequenceEventCount; i++) {
+        applySequenceEvent(sequenceEvents[i]);
+    }
+    sequenceEventCount = 0;
+}
+
+void AudioEngine::applySequenceEvent(const Sequencer::Event& event) {
+    if (event.noteOn) {
+        sequenceRatio = exp2f(event.semitones / 12.0f);
+        float freq = sequenceBase * sequenceRatio;
+        baseFrequency[SEQUENCED_VOICE] = freq;
+        voices[SEQUENCED_VOICE].noteOn(freq, event.velocity / 127.0f);  // Retriggers pluck/FM too
+        envelopes[SEQUENCED_VOICE].gate(true);
+    } else {
+        noteOff(SEQUENCED_VOICE);
+    }
+}
+
+void AudioEngine::renderWorkerTask(void* parameter) {
+    AudioEngine* self = static_cast<AudioEngine*>(parameter);
+
+    while (true) {
+        // Woken by fillBuffer() once per dual-core block
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        uint32_t start = readCycleCounter();
+        self->renderGroup(1);
+        self->workerCycles = readCycleCounter() - start;   // Same core: valid difference
+
+        self->renderBarrier.arriveAndWait();
+    }
+}
+
+/**
+ * Console: "render" - voice rendering over the cores (see RenderPolicy)
+ *
+ * render                   mode, and whether the last block was split
+ * render single|dual|auto  set the mode; applies from the next block
+ */
+void AudioEngine::renderCommand(int argc, char** argv) {
+    static const char* const MODE_NAMES[] = {"single", "dual", "auto"};
+    RenderPolicy& policy = instance->renderPolicy;
+
+    if (argc >= 2) {
+        int mode = 0;
+        while (mode <= RenderPolicy::AUTO && strcmp(argv[1], MODE_NAMES[mode]) != 0) {
+            mode++;
+        }
+        if (mode > RenderPolicy::AUTO) {
+            Serial.println("render: single, dual or auto");
+            return;
+        }
+        policy.request((RenderPolicy::Mode)mode);
+    }
+
+    Serial.printf("render: %s, last block on %s\n", MODE_NAMES[policy.getMode()],
+                  instance->dualCoreActive ? "both cores" : "Core 0");
+}
+
+/**
+ * Console: "fx" - effects on the bus (see EffectsBus)
+ *
+ * fx                   each effect and whether it is on
+ * fx <name> on|off     switch one; applies from the next rendered block
+ */
+void AudioEngine::fxCommand(int argc, char** argv) {
+    EffectsBus& bus = instance->effectsBus;
+
+    if (argc >= 3) {
+        int index = 0;
+        while (index < bus.getEffectCount() && strcmp(bus.getEffect(index)->getName(), argv[1]) != 0) {
+            index++;
+        }
+        bool on = strcmp(argv[2], "on") == 0;
+        if ((!on && strcmp(argv[2], "off") != 0) || !bus.requestBypass(index, !on)) {
+            Serial.println("fx: <name> on|off (or queue full)");
+            return;
+        }
+        instance->wake();        // A parked audio task wouldn't read the request
+        Serial.println("ok");
+        return;
+    }
+
+    for (int i = 0; i < bus.getEffectCount(); i++) {
+        Serial.printf("fx: %s %s\n", bus.getEffect(i)->getName(), bus.getEffect(i)->isBypassed() ? "off" : "on");
+    }
+}
+
+/**
+ * Console: "seq" - sequencer and arpeggiator (see Sequencer)
+ *
+ * seq                          status
+ * seq off|steps|up|down|updown mode
+ * seq tempo <bpm> [steps/beat]
+ * seq gate <percent>
+ * seq step <index> <semitones> [velocity, 0 = rest]
+ * seq len <steps>
+ * seq chord <semitones>...     arpeggiator notes
+ *
+ * Changes are posted to the audio task and apply on its next block.
+ */
+void AudioEngine::seqCommand(int argc, char** argv) {
+    Sequencer& sequencer = instance->sequencer;
+    bool ok = true;
+
+    if (argc < 2) {
+        Serial.printf("seq: %s, %lu steps played, %llu samples\n",
+                      sequencer.isRunning() ? "running" : "off",
+                      (unsigned long)sequencer.getStepsPlayed(),
+                      (unsigned long long)sequencer.getElapsedSamples());
+        return;
+    } else if (strcmp(argv[1], "tempo") == 0 && argc >= 3) {
+        ok = sequencer.setTempo((uint32_t)lrintf(atof(argv[2]) * 1000.0f), argc >= 4 ? atoi(argv[3]) : 4);
+    } else if (strcmp(argv[1], "gate") == 0 && argc >= 3) {
+        ok = sequencer.setGate(constrain(atoi(argv[2]), 1, 100) * 10);
+    } else if (strcmp(argv[1], "step") == 0 && argc >= 4) {
+        ok = sequencer.setStep(atoi(argv[2]), atoi(argv[3]), argc >= 5 ? atoi(argv[4]) : 100);
+    } else if (strcmp(argv[1], "len") == 0 && argc >= 3) {
+        ok = sequencer.setLength(atoi(argv[2]));
+    } else if (strcmp(argv[1], "chord") == 0 && argc >= 3) {
+        int8_t notes[Sequencer::MAX_CHORD];
+        int count = 0;
+        for (int i = 2; i < argc && count < Sequencer::MAX_CHORD; i++) {
+            notes[count++] = (int8_t)constrain(atoi(argv[i]), -48, 48);
+        }
+        ok = sequencer.setChord(notes, count);
+    } else {
+        int mode = 0;
+        while (mode < Sequencer::MODE_COUNT && strcmp(argv[1], Sequencer::modeName((Sequencer::Mode)mode)) != 0) {
+            mode++;
+        }
+        ok = sequencer.setMode((Sequencer::Mode)mode);     // MODE_COUNT is rejected
+    }
+
+    if (!ok) {
+        Serial.println("seq: invalid (or queue full)");
+        return;
+    }
+    instance->wake();      // A parked audio task wouldn't read the message
+    Serial.println("ok");
+}
+
+/**
+ * Console: "fm" - patch of the FM voices (see FmVoice::PRESETS)
+ *
+ * fm               presets, the current one marked
+ * fm <name|index>  select one; applies from the next rendered block
+ */
+void AudioEngine::fmCommand(int argc, char** argv) {
+    if (argc >= 2) {
+        int preset = 0;
+        while (preset < FmVoice::PRESET_COUNT && strcasecmp(argv[1], FmVoice::PRESETS[preset].name) != 0) {
+            preset++;
+        }
+        if (preset == FmVoice::PRESET_COUNT && argv[1][0] >= '0' && argv[1][0] <= '9') {
+            preset = atoi(argv[1]);
+        }
+        if (!instance->setFmPatch(preset)) {
+            Serial.println("fm: unknown preset (or queue full)");
+            return;
+        }
+        Serial.println("ok");
+        return;
+    }
+
+    for (int i = 0; i < FmVoice::PRESET_COUNT; i++) {
+        const FmVoice::Patch& patch = FmVoice::PRESETS[i];
+        Serial.printf("fm: %c%d %-6s %s\n", i == instance->getFmPatch() ? '*' : ' ', i, patch.name,
+                      FmVoice::algorithmName(patch.algorithm));
+    }
+}
+
+/**
+ * Console: "mod" - modulation matrix inputs (see ModMatrix)
+ *
+ * mod                      control rate, routes and CC values
+ * mod rate <samples>       control rate: power of two, 8 - BLOCK_FRAMES
+ * mod cc <1-4> <0-127>     set a CC source, until a MIDI input feeds them
+ *
+ * Both are single stores the audio task picks up on its next block.
+ */
+void AudioEngine::modCommand(int argc, char** argv) {
+    if (argc >= 3 && strcmp(argv[1], "rate") == 0) {
+        if (!instance->setControlRate(atoi(argv[2]))) {
+            Serial.printf("mod: rate is a power of two, 8 - %d\n", BLOCK_FRAMES);
+            return;
+        }
+    } else if (argc >= 4 && strcmp(argv[1], "cc") == 0) {
+        int slot = atoi(argv[2]) - 1;
+        if (slot < 0 || slot >= 4) {
+            Serial.println("mod: cc 1 - 4");
+            return;
+        }
+        instance->setControlChange(slot, atoi(argv[3]));
+    } else if (argc >= 2) {
+        Serial.println("mod: rate <samples> | cc <1-4> <0-127>");
+        return;
+    }
+
+    Serial.printf("mod: control rate %d samples, cc %d %d %d %d\n", instance->getControlRate(),
+                  (int)lrintf(instance->controlChanges[0].load() * 127.0f),
+                  (int)lrintf(instance->controlChanges[1].load() * 127.0f),
+                  (int)lrintf(instance->controlChanges[2].load() * 127.0f),
+                  (int)lrintf(instance->controlChanges[3].load() * 127.0f));
+    const ModMatrix& matrix = instance->modMatrix;
+    for (int i = 0; i < ModMatrix::MAX_ROUTES; i++) {
+        const ModMatrix::Route& route = matrix.getRoute(i);
+        if (route.source != ModMatrix::SRC_NONE) {
+            Serial.printf("mod: %d %s -> %s %+.3f\n", i, ModMatrix::getSourceName(route.source),
+                          ModMatrix::getDestinationName(route.destination), (double)route.depth);
+        }
+    }
+}
+
+/**
+ * Console: "buf" - output buffering (see BufferController)
+ *
+ * buf              current level, block and queue, latency, underruns
+ * buf auto         let the controller pick the level (default)
+ * buf <0-4>        pin a level: 0 = shortest latency
+ *
+ * Zero-copy builds have no levels: the DMA ring is the buffering.
+ */
+void AudioEngine::bufCommand(int argc, char** argv) {
+#if AUDIO_ZERO_COPY
+    // Latency as the header and "lat" define it: a block is acquired
+    // ZC_BUFFERS - 1 buffers before it plays
+    const DmaRing& ring = instance->dmaRing;
+    const uint32_t latencyFrames = (ZC_BUFFERS - 1) * ZC_FRAMES;
+    uint32_t latencyUs = (uint32_t)((uint64_t)latencyFrames * 1000000 / SAMPLE_RATE);
+    if (argc >= 2) {
+        Serial.println("buf: no levels in zero-copy mode");
+    }
+    Serial.printf("buf: zero-copy, %d DMA buffers of %d frames, %lu frames ahead of each block, ~%lu.%lu ms\n",
+                  ring.getCount(), ZC_FRAMES, (unsigned long)latencyFrames,
+                  (unsigned long)(latencyUs / 1000), (unsigned long)(latencyUs % 1000 / 100));
+    Serial.printf("     %lu underruns\n", (unsigned long)ring.getUnderruns());
+#else
+    BufferController& controller = instance->bufferController;
+
+    if (argc >= 2) {
+        if (strcmp(argv[1], "auto") == 0) {
+            controller.request(BufferController::AUTO);
+        } else if (argv[1][0] >= '0' && argv[1][0] <= '9' && atoi(argv[1]) < BufferController::LEVEL_COUNT) {
+            controller.request(atoi(argv[1]));
+        } else {
+            Serial.println("buf: auto or 0-4");
+            return;
+        }
+        instance->wake();      // Applies on the next rendered block
+    }
+
+    int level = controller.getLevel();
+    const BufferController::Level& l = BufferController::level(level);
+    uint32_t latencyUs = (uint32_t)((uint64_t)(l.blockFrames + l.queueFrames) * 1000000 / SAMPLE_RATE);
+    Serial.printf("buf: level %d (%s), %u-frame blocks, %u frames queued, ~%lu.%lu ms\n", level,
+                  controller.getRequest() == BufferController::AUTO ? "auto" : "fixed",
+                  (unsigned)l.blockFrames, (unsigned)l.queueFrames,
+                  (unsigned long)(latencyUs / 1000), (unsigned long)(latencyUs % 1000 / 100));
+    Serial.printf("     %lu underruns, %lu level changes\n", (unsigned long)controller.getUnderruns(),
+                  (unsigned long)controller.getChanges());
+#endif
+}
+
+bool AudioEngine::setSample(int voiceIndex, int sampleIndex) {
+    const SampleInfo* info = sampleStore.getInfo(sampleIndex);
+    if (!info || info->kind != SAMPLE_KIND_SAMPLE) {
+        return false;
+    }
+    samplePlayers[voiceIndex].setSample(info, sampleStore.getData(sampleIndex));
+    return true;
+}
+
 void AudioEngine::noteOn(int voiceIndex, float freq, float amp) {
     voices[voiceIndex].noteOn(freq, amp);
+    envelopes[voiceIndex].gate(true);
+    wake();
 }
 
 void AudioEngine::noteOff(int voiceIndex) {
-    voices[voiceIndex].noteOff();
+    // The voice keeps running through the release; fillBuffer() stops it
+    envelopes[voiceIndex].gate(false);
+    fmVoices[voiceIndex].noteOff();
 }
 
 void AudioEngine::setMasterVolume(float vol) {
     masterVolume = vol;
+    // Same headroom as the original 4-voice mix, whichever group a voice is in
+    for (int g = 0; g < GROUPS; g++) {
+        groupMixers[g].setGain(vol / 4);
+    }
 }
 
 void AudioEngine::fillBuffer() {
-    bool anyActive = false;
-    for (int i=0; i < BUFFER_SIZE / 2; i++) {
-        float mixedSample = 0.0f;
-        for(Voice &voice : voices) {
-            if (voice.getIsActive()) {
-                anyActive = true;
-                float sample = voice.getNextSample();
-                mixedSample += sample;
-            }
-        }
-        mixedSample *= masterVolume;
-        mixedSample /= sizeof(voices) / sizeof(Voice);
+    PROFILE_SCOPE("AudioEngine::fillBuffer");
+    uint32_t blockStart = readCycleCounter();
+
+    // The block is rendered in control-rate slices with modulation applied
+    // in between. Voices run in two groups, on one core or split over both;
+    // the summed groups then go through filter, effects and the int16
+    // conversion in the main graph, which writes audioBuffer.
+    blockControlRate = min((int)controlRate, blockFrames);
+    int slices = blockFrames / blockControlRate;
+    applyFmPatch();
+    prepareControl(slices);
+    runSequencer();             // Before the worker starts: it reads the events
+
+    int activeVoices = 0;
+    for (int i = 0; i < VOICE_COUNT; i++) {
+        activeVoices += voices[i].getIsActive() ? 1 : 0;
+    }
+
+    bool dual = workerHandle && renderPolicy.decide(activeVoices, uiLoadPermille.load(std::memory_order_relaxed),
+                                                      blockFrames);
+    dualCoreActive = dual;
+
+    // The LoadMeter is Core 0 only; the worker reports its total instead
+    voiceGraphs[1].setLoadMeter(dual ? nullptr : &loadMeter);
+
+    if (dual) {
+        xTaskNotifyGive(workerHandle);
+        renderGroup(0);
+
+        uint32_t waitStart = readCycleCounter();
+        renderBarrier.arriveAndWait();
+        uint32_t waited = readCycleCounter() - waitStart;
 
-        int16_t sampleValue = (int16_t)(mixedSample * 32767);
+        loadMeter.add(workerSlot, workerCycles);
+        renderPolicy.reportWorker(waited > loadMeter.getBudgetCycles(blockFrames) / 2);
+    } else {
+        renderGroup(0);
+        renderGroup(1);
+    }
+
+    for (int offset = 0, s = 0; offset < blockFrames; offset += blockControlRate, s++) {
+        const float* groups[GROUPS] = { groupBuffers[0] + offset, groupBuffers[1] + offset };
+        busInput.setSources(groups, GROUPS);
+        modulateFilter(s);
+        outputNode.setTarget(audioBuffer + offset * AudioFormat::CHANNELS);
+        graph.render(blockControlRate);
+    }
 
-        audioBuffer[i * 2] = sampleValue;      
-        audioBuffer[i * 2 + 1] = sampleValue;
+    // Voices whose release has finished stop rendering
+    for (int i = 0; i < VOICE_COUNT; i++) {
+        if (voices[i].getIsActive() && envelopes[i].getStage() == EnvelopeNode::IDLE) {
+            voices[i].noteOff();
+        }
     }
 
+    lastBlockCycles = readCycleCounter() - blockStart;
+    blockRendered = true;
+    loadMeter.add(blockSlot, lastBlockCycles);
+    loadMeter.endBlock(blockFrames);
+
     if (audioState == FEEDBACK_TONE) {
         fillFeedbackBuffer();  
         return;
     }
-    
-    if (!anyActive) {
-        memset(audioBuffer, 0, sizeof(audioBuffer));
-        return;
+}
+
+void AudioEngine::park() {
+    if (!parked) {
+        parked = true;
+        parkCount++;
+        LOG("[AUDIO] Silent - parked (%lu)", (unsigned long)parkCount);
+    }
+    expectStarved = true;       // The ring will have run dry by the next write
+
+    // The DMA ring drains within a few ms and auto-clear keeps it at zero
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(PARK_RECHECK_MS));
+}
+
+void AudioEngine::wake() {
+    // Notifications count, so a wake that races with park() isn't lost
+    if (audioTask) {
+        xTaskNotifyGive(audioTask);
     }
 }
 
@@ -176,17 +1075,17 @@ void AudioEngine::playFeedbackTone(float frequency, int durationMs) {
     for (int i = 0; i < sizeof(voices) / sizeof(Voice); i++) {
         setFrequency(i, frequency);
     }
+    wake();
 }
 
 void AudioEngine::fillFeedbackBuffer() {
     static float feedbackPhase = 0;  
     
-    for (int i = 0; i < BUFFER_SIZE / 2; i++) {
+    for (int i = 0; i < blockFrames; i++) {
         if (feedbackSamplesRemaining <= 0) {
             audioState = NORMAL_PLAYBACK;
             feedbackPhase = 0;  
-            audioBuffer[i * 2] = 0;
-            audioBuffer[i * 2 + 1] = 0;
+            AudioFormat::writeFrame(audioBuffer, i, 0.0f);
             continue;
         }
 
@@ -197,10 +1096,7 @@ void AudioEngine::fillFeedbackBuffer() {
         float feedbackAmplitude = min(masterVolume * 0.5f, 0.15f);  // Max 15% even if volume is high
         float sample = sin(feedbackPhase) * feedbackAmplitude;
         
-        int16_t sampleValue = (int16_t)(sample * 32767);
-
-        audioBuffer[i * 2] = sampleValue;
-        audioBuffer[i * 2 + 1] = sampleValue;
+        AudioFormat::writeFrame(audioBuffer, i, sample);
 
         feedbackPhase += 2 * PI * feedbackFrequency / SAMPLE_RATE;
         if (feedbackPhase >= 2*PI) {
@@ -2,23 +2,92 @@
 #define AUDIOENGINE_H
 
 #include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "esp_idf_version.h"
 #include "Waveforms/WaveformGenerator.h"
 #include "Voice.h"
+#include "Wavetable/Wavetable.h"
+#include "Wavetable/WavetableOscillator.h"
+#include "Sampler/SampleStore.h"
+#include "Sampler/SamplePlayer.h"
+#include "Effects/EffectsBus.h"
+#include "LoadMeter.h"
+#include "Graph/AudioGraph.h"
+#include "Graph/Nodes.h"
+#include "Modulation/Lfo.h"
+#include "Modulation/ModMatrix.h"
+#include "Parallel/SpinBarrier.h"
+#include "Parallel/RenderPolicy.h"
+#include "Parallel/BufferController.h"
+#include "Output/DmaRing.h"
+#include "Scope/ScopeTap.h"
+#include "Sequencer/Sequencer.h"
 #include "../../include/Consts.h"
 
+// Zero-copy output (-D EDULAB_I2S_ZERO_COPY): blocks are rendered straight
+// into the DMA buffer the I2S channel driver just sent. Needs that driver,
+// i.e. ESP-IDF 5 (Arduino core 3); older cores keep the legacy driver.
+#if defined(EDULAB_I2S_ZERO_COPY) && ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+#define AUDIO_ZERO_COPY 1
+#include "driver/i2s_std.h"
+#else
+#define AUDIO_ZERO_COPY 0
+#ifdef EDULAB_I2S_ZERO_COPY
+#warning "EDULAB_I2S_ZERO_COPY needs ESP-IDF 5: building the legacy I2S output"
+#endif
+#endif
+
 class StateMachine;  // Forward declaration
 class Potentiometer; // Forward declaration
 
 class AudioEngine {
     ;
+public:
+    static const int VOICE_COUNT = 8;
+    static const int PLUCK_VOICES = 3;                  // update() only plucks voices 0-2
+    static const int GROUPS = RenderPolicy::GROUPS;
+    static const int MAX_SLICES = BLOCK_FRAMES / 8;     // Smallest control rate
+
 private:
     // I2S Configuration
     int I2S_BCK_PIN;
     int I2S_LRCK_PIN;
     int I2S_DIN_PIN;
 
-    // Audio buffer
-    int16_t audioBuffer[BUFFER_SIZE];
+#if AUDIO_ZERO_COPY
+    // The DMA buffer being rendered, acquired from dmaRing by update().
+    // Blocks are one DMA buffer long, so the ring is also the latency:
+    // ZC_BUFFERS - 1 buffers (~8.7 ms) from acquiring one to playing it,
+    // of which ZC_BUFFERS - 2 are for rendering. The buffer controller
+    // has nothing to adjust here and is left idle.
+    static const int ZC_BUFFERS = 4;
+    static const int ZC_FRAMES = 128;
+    AudioFormat::Sample* audioBuffer;
+    i2s_chan_handle_t txChannel;
+    DmaRing dmaRing;
+#else
+    // Audio buffer, one I2S write in the build's output format
+    AudioFormat::Sample audioBuffer[BUFFER_SIZE];
+#endif
+
+    // I2S DMA ring. TX_DONE events (one per DMA buffer played) give the
+    // depth still queued ahead of the next write: it sets the output
+    // latency and shows underruns.
+    static const int DMA_BUFFERS = 8;
+    static const int DMA_FRAMES = 64;           // Frames per DMA buffer
+    static const int DMA_EVENT_QUEUE = 16;
+    static const uint32_t DMA_WAIT_MS = 20;     // Per event; a stalled DMA can't hang the task
+    QueueHandle_t i2sEvents;
+    int32_t dmaQueuedFrames;
+
+    // Adaptive block size and DMA depth (see BufferController). Blocks
+    // are blockFrames long, at most BLOCK_FRAMES; buffers keep that size.
+    BufferController bufferController;
+    int blockFrames;                            // Latched at the start of each update()
+    bool expectStarved;                         // Boot or park: the next underrun is expected
+    bool blockRendered;                         // This block went through fillBuffer()
+    uint32_t lastBlockCycles;
 
     // Waveform synthesis
     //WaveformGenerator* currentWaveform;
@@ -30,7 +99,81 @@ private:
 
     WaveformGenerator* waveforms[5]; // ← Array to hold different waveform generators
 
-    Voice voices[4]; // ← Array of voices for polyphony
+    Voice voices[VOICE_COUNT]; // ← Array of voices for polyphony
+
+    Wavetable wavetable;                                // Mipmapped tables in PSRAM
+    WavetableOscillator wavetableOscs[VOICE_COUNT];     // One SRAM cache per voice
+
+    SampleStore sampleStore;                    // "samples" flash partition, mmapped
+    SamplePlayer samplePlayers[VOICE_COUNT];
+
+    OscillatorBank oscillatorBank;              // SoA saws for the supersaw voices
+    int unisonFirst[VOICE_COUNT];               // Each voice's MAX_UNISON range
+
+    FmVoice fmVoices[VOICE_COUNT];
+    MessageQueue<int8_t, 4> fmPatchRequests;    // PRESETS indices, applied by the audio task
+    std::atomic<int> fmPatch;                   // Preset the voices play
+    PluckString plucks[PLUCK_VOICES];           // 8 KB ring each, internal RAM
+
+    EffectsBus effectsBus;                      // Delay + reverb, lines in PSRAM
+    LoadMeter loadMeter;
+    int voicesSlot;                             // LoadMeter slots
+    int workerSlot;
+    int blockSlot;
+
+    // Signal flow, in two stages:
+    //   group graphs (one per core): voice -> envelope (x4) -> mixer -> capture
+    //   main graph (Core 0):         bus input -> filter -> effects -> output
+    // Group g holds the voices with RenderPolicy::groupOf(voice) == g.
+    AudioGraph voiceGraphs[GROUPS];
+    VoiceNode voiceNodes[VOICE_COUNT];
+    EnvelopeNode envelopes[VOICE_COUNT];
+    MixerNode groupMixers[GROUPS];
+    CaptureNode captures[GROUPS];
+    float groupBuffers[GROUPS][BLOCK_FRAMES];   // Private mix buffer per group
+
+    AudioGraph graph;
+    BusInputNode busInput;
+    FilterNode filter;
+    EffectNode effectNode;
+    OutputNode outputNode;
+
+    ScopeTap scopeTap;                          // Decimated output for the OLED scope
+
+    // Sequencer/arpeggiator: plays SEQUENCED_VOICE, with voices 1 and 2
+    // released while it runs. Its events are computed once per block on
+    // Core 0 and only read by the group that renders that voice.
+    static const int SEQUENCED_VOICE = 0;
+    Sequencer sequencer;
+    Sequencer::Event sequenceEvents[Sequencer::MAX_EVENTS];
+    int sequenceEventCount;
+    bool sequencing;
+    bool sequenceAudible;                       // Not muted, a mode selected
+    float sequenceBase;                         // Pot pitch the steps transpose
+    float sequenceRatio;                        // Current step's transposition
+
+    // Dual-core rendering: group 1 on a Core 1 worker, joined per block
+    RenderPolicy renderPolicy;
+    SpinBarrier renderBarrier;
+    TaskHandle_t workerHandle;
+    volatile uint32_t workerCycles;             // Worker's render time, published before the barrier
+    std::atomic<uint32_t> uiLoadPermille;
+    volatile bool dualCoreActive;
+
+    // Control-rate modulation: the block is rendered in controlRate-sized
+    // slices and the matrix is evaluated once before each slice
+    ModMatrix modMatrix;
+    Lfo lfos[2];
+    volatile int controlRate;                   // Samples per control tick
+    int blockControlRate;                       // controlRate latched for the current block
+    float sliceLfo[MAX_SLICES][2];              // LFO values per slice, shared by both cores
+    float sliceEnvelope[GROUPS][MAX_SLICES];    // Loudest envelope per group and slice
+    float baseFrequency[VOICE_COUNT];           // Before pitch modulation
+    float baseWavetablePosition[VOICE_COUNT];
+    float baseCutoff;
+    float potPitchValue;                        // Pots as mod sources (0 - 1)
+    float potToneValue;
+    std::atomic<float> controlChanges[4];       // MIDI CC slots (0 - 1)
 
     // Audio state (for feedback tone)
     enum AudioState {
@@ -41,6 +184,23 @@ private:
     volatile int feedbackSamplesRemaining;   
     volatile float feedbackFrequency;        
 
+    volatile int64_t firstBlockTimeUs;       // esp_timer time of the first i2s_write (boot metric)
+    bool firstBlockLogged;                   // The time can be 0 (the simulator starts there)
+
+    // Idle parking: after PARK_AFTER_BLOCKS silent blocks the audio task
+    // stops writing and sleeps until wake(). The I2S driver keeps clocking
+    // and, with tx_desc_auto_clear (onDmaSent() in zero-copy mode), plays
+    // zeros from the drained DMA ring, so the DAC sees continuous silence
+    // and resuming is a normal write.
+    static const int PARK_AFTER_BLOCKS = 8;             // ~46 ms of silence
+    static const uint32_t PARK_RECHECK_MS = 200;        // Upper bound if a wake is missed
+    TaskHandle_t audioTask;                             // Set by the first update()
+    int silentBlocks;
+    bool parked;
+    uint32_t parkCount;
+
+    static AudioEngine* instance;                       // For the console commands
+
 public:
     AudioEngine(int bck, int lrck, int din);  // ← Constructor
 
@@ -50,14 +210,71 @@ public:
     void setWaveform(int voiceIndex, WaveformGenerator* waveform);
     void setFrequency(int voiceIndex, float freq);     
     void setAmplitude(int voiceIndex, float amp);      
+    void setWavetablePosition(int voiceIndex, float position);
+    bool setSample(int voiceIndex, int sampleIndex);   // From the flash sample bank
+    void setUnison(int count, float detune, float mix);    // All supersaw voices
+    bool setFmPatch(int preset);                // FmVoice::PRESETS index, all voices (any task)
+    int getFmPatch() const { return fmPatch.load(std::memory_order_relaxed); }
+    void setPluckDecay(float amount);           // 0 - 1, all plucked-string voices
     void setMasterVolume(float vol);   
     void noteOn(int voiceIndex, float freq, float amp);
     void noteOff(int voiceIndex);
+
+    ModMatrix& getModMatrix() { return modMatrix; }
+    Lfo& getLfo(int index) { return lfos[index]; }
+    bool setControlRate(int samples);           // Power of two, 8 - BLOCK_FRAMES
+    int getControlRate() const { return controlRate; }
+    void setCutoff(float hz) { baseCutoff = hz; }
+    void setControlChange(int slot, int value); // 0 - 127 ("mod cc", later a MIDI input)
     
     void playFeedbackTone(float frequency, int durationMs);
 
+    void wake();                                // Resume a parked audio task (any task)
+    bool isParked() const { return parked; }
+    uint32_t getParkCount() const { return parkCount; }
+    uint32_t getDmaQueuedFrames() const { return dmaQueuedFrames; }   // After the last write
+    BufferController& getBufferController() { return bufferController; }
+#if AUDIO_ZERO_COPY
+    const DmaRing& getDmaRing() const { return dmaRing; }
+#endif
+
+    int64_t getFirstBlockTimeUs() const { return firstBlockTimeUs; }
+    EffectsBus& getEffectsBus() { return effectsBus; }
+    const LoadMeter& getLoadMeter() const { return loadMeter; }
+    AudioGraph& getGraph() { return graph; }
+    ScopeTap& getScopeTap() { return scopeTap; }
+    Sequencer& getSequencer() { return sequencer; }   // UI setters post messages; call wake() after
+
+    void setRenderMode(RenderPolicy::Mode mode) { renderPolicy.request(mode); }    // Any task
+    RenderPolicy::Mode getRenderMode() const { return renderPolicy.getMode(); }
+    bool isDualCoreActive() const { return dualCoreActive; }
+    TaskHandle_t getWorkerTask() const { return workerHandle; }
+    void setUiLoad(uint32_t permille) { uiLoadPermille.store(permille, std::memory_order_relaxed); }
+
 private:
+    void buildGraph();
+    void prepareControl(int slices);
+    void modulateVoices(int group, int slice);
+    void modulateFilter(int slice);
+    void renderGroup(int group);
+    void runSequencer();
+    void skipSequencer();          // Advances it through a block that isn't rendered
+    void applySequenceEvent(const Sequencer::Event& event);
+    void applyFmPatch();
+    static void renderWorkerTask(void* parameter);
+    static void renderCommand(int argc, char** argv);
+    static void fxCommand(int argc, char** argv);
+    static void seqCommand(int argc, char** argv);
+    static void fmCommand(int argc, char** argv);
+    static void modCommand(int argc, char** argv);
+    static void bufCommand(int argc, char** argv);
     void fillBuffer();             
+    void writeBuffer();            // DMA depth wait + i2s_write + buffer level, boot timing, silence detection
+#if AUDIO_ZERO_COPY
+    bool acquireBuffer();          // Waits for the DMA to free the next buffer
+    static bool IRAM_ATTR onDmaSent(i2s_chan_handle_t channel, i2s_event_data_t* event, void* context);
+#endif
+    void park();
     //void updatePhaseIncrement();  
     void fillFeedbackBuffer(); 
 };
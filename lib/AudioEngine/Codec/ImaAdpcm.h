@@ -0,0 +1,138 @@
+#ifndef IMAADPCM_H
+#define IMAADPCM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * IMA-ADPCM codec (4 bits per sample), block-based for random access
+ *
+ * Block layout (BLOCK_BYTES):
+ *   int16  predictor   - decoder state before the first sample (little-endian)
+ *   uint8  stepIndex
+ *   uint8  reserved
+ *   BLOCK_SAMPLES / 2 bytes of nibbles, low nibble first
+ *
+ * Every block carries its own decoder state, so playback can start, loop
+ * or seek at any block boundary. 256 samples -> 132 bytes (3.9:1).
+ *
+ * Header-only and free of Arduino dependencies: the firmware decodes with
+ * it and tools/pack_samples encodes with it.
+ */
+class ImaAdpcm {
+public:
+    static const int BLOCK_SAMPLES = 256;
+    static const int HEADER_BYTES = 4;
+    static const int BLOCK_BYTES = HEADER_BYTES + BLOCK_SAMPLES / 2;
+
+    struct State {
+        int32_t predictor;
+        int32_t stepIndex;
+    };
+
+    static size_t encodedBytes(uint32_t samples) {
+        return (size_t)((samples + BLOCK_SAMPLES - 1) / BLOCK_SAMPLES) * BLOCK_BYTES;
+    }
+
+    static inline int16_t decodeNibble(State& state, uint8_t nibble) {
+        static const int8_t indexTable[16] = {
+            -1, -1, -1, -1, 2, 4, 6, 8,
+            -1, -1, -1, -1, 2, 4, 6, 8
+        };
+
+        int32_t step = stepSize(state.stepIndex);
+        int32_t diff = step >> 3;
+        if (nibble & 1) diff += step >> 2;
+        if (nibble & 2) diff += step >> 1;
+        if (nibble & 4) diff += step;
+
+        state.predictor += (nibble & 8) ? -diff : diff;
+        if (state.predictor > 32767) state.predictor = 32767;
+        if (state.predictor < -32768) state.predictor = -32768;
+
+        state.stepIndex += indexTable[nibble & 15];
+        if (state.stepIndex < 0) state.stepIndex = 0;
+        if (state.stepIndex > 88) state.stepIndex = 88;
+
+        return (int16_t)state.predictor;
+    }
+
+    static inline uint8_t encodeSample(State& state, int16_t sample) {
+        int32_t step = stepSize(state.stepIndex);
+        int32_t diff = sample - state.predictor;
+        uint8_t nibble = 0;
+
+        if (diff < 0) {
+            nibble = 8;
+            diff = -diff;
+        }
+        if (diff >= step) { nibble |= 4; diff -= step; }
+        step >>= 1;
+        if (diff >= step) { nibble |= 2; diff -= step; }
+        step >>= 1;
+        if (diff >= step) { nibble |= 1; }
+
+        // Run the decoder so encoder and decoder states stay in lockstep
+        decodeNibble(state, nibble);
+        return nibble;
+    }
+
+    /**
+     * Decode one block
+     *
+     * @param block: BLOCK_BYTES of encoded data
+     * @param out: Destination for `count` samples (max BLOCK_SAMPLES)
+     */
+    static void decodeBlock(const uint8_t* block, int16_t* out, int count = BLOCK_SAMPLES) {
+        State state;
+        state.predictor = (int16_t)(block[0] | (block[1] << 8));
+        state.stepIndex = block[2] > 88 ? 88 : block[2];
+
+        const uint8_t* nibbles = block + HEADER_BYTES;
+        for (int i = 0; i < count; i += 2) {
+            uint8_t byte = nibbles[i >> 1];
+            out[i] = decodeNibble(state, byte & 0x0F);
+            if (i + 1 < count) {
+                out[i + 1] = decodeNibble(state, byte >> 4);
+            }
+        }
+    }
+
+    /**
+     * Encode one block, continuing from `state`
+     *
+     * @param in: Up to BLOCK_SAMPLES samples; a short final block is padded
+     * @param count: Number of valid samples in `in`
+     * @param state: Encoder state, carried from block to block
+     * @param block: Destination, BLOCK_BYTES
+     */
+    static void encodeBlock(const int16_t* in, int count, State& state, uint8_t* block) {
+        block[0] = (uint8_t)(state.predictor & 0xFF);
+        block[1] = (uint8_t)((state.predictor >> 8) & 0xFF);
+        block[2] = (uint8_t)state.stepIndex;
+        block[3] = 0;
+
+        uint8_t* nibbles = block + HEADER_BYTES;
+        int16_t last = count > 0 ? in[count - 1] : 0;
+        for (int i = 0; i < BLOCK_SAMPLES; i += 2) {
+            uint8_t low = encodeSample(state, i < count ? in[i] : last);
+            uint8_t high = encodeSample(state, i + 1 < count ? in[i + 1] : last);
+            nibbles[i >> 1] = low | (high << 4);
+        }
+    }
+
+private:
+    static inline int32_t stepSize(int32_t index) {
+        static const int16_t stepTable[89] = {
+            7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
+            34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143,
+            157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+            724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024,
+            3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+            15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+        };
+        return stepTable[index];
+    }
+};
+
+#endif
@@ -0,0 +1,80 @@
+#include "DelayLine.h"
+#include "esp_heap_caps.h"
+#include "../../../include/Consts.h"
+
+DelayLine::DelayLine()
+    : buffer(nullptr), length(0), writePos(0), written(0), delay(BLOCK_FRAMES) {
+}
+
+DelayLine::~DelayLine() {
+    if (buffer) {
+        heap_caps_free(buffer);
+    }
+}
+
+bool DelayLine::allocate(int samples) {
+    if (buffer || samples < BLOCK_FRAMES * 2) {
+        return false;
+    }
+
+    size_t bytes = (size_t)samples * sizeof(float);
+    buffer = (float*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+    if (!buffer) {
+        buffer = (float*)heap_caps_malloc(bytes, MALLOC_CAP_8BIT);
+    }
+    if (!buffer) {
+        return false;
+    }
+
+    memset(buffer, 0, bytes);
+    length = samples;
+    clear();
+    setDelay(delay);
+    return true;
+}
+
+void DelayLine::clear() {
+    written = 0;
+}
+
+void DelayLine::setDelay(int samples) {
+    // At least one block (read-before-write), at most the buffer minus one
+    // block so the read never overlaps the block about to be written
+    delay = constrain(samples, BLOCK_FRAMES, max(length - BLOCK_FRAMES, BLOCK_FRAMES));
+}
+
+void DelayLine::read(float* dst, int frames) const {
+    // Sample i was written delay - i samples ago; older than the last
+    // clear() it is stale and reads as silence
+    int stale = constrain(delay - written, 0, frames);
+    if (stale > 0) {
+        memset(dst, 0, stale * sizeof(float));
+        dst += stale;
+        frames -= stale;
+    }
+
+    int readPos = writePos - delay + stale;
+    if (readPos < 0) {
+        readPos += length;
+    }
+
+    int first = min(frames, length - readPos);
+    memcpy(dst, buffer + readPos, first * sizeof(float));
+    if (first < frames) {
+        memcpy(dst + first, buffer, (frames - first) * sizeof(float));
+    }
+}
+
+void DelayLine::write(const float* src, int frames) {
+    int first = min(frames, length - writePos);
+    memcpy(buffer + writePos, src, first * sizeof(float));
+    if (first < frames) {
+        memcpy(buffer, src + first, (frames - first) * sizeof(float));
+    }
+
+    writePos += frames;
+    if (writePos >= length) {
+        writePos -= length;
+    }
+    written = min(written + frames, length);
+}
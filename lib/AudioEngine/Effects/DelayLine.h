@@ -0,0 +1,47 @@
+#ifndef DELAYLINE_H
+#define DELAYLINE_H
+
+#include <Arduino.h>
+
+/**
+ * Long circular delay line in PSRAM, accessed a block at a time
+ *
+ * Instead of one random PSRAM access per sample, read() copies the whole
+ * delayed block into SRAM and write() appends a whole block, each as at
+ * most two contiguous memcpy runs (split only at the wrap point). That
+ * keeps PSRAM traffic to sequential bursts the cache handles well.
+ *
+ * Because a block is read before it is written, the delay must be at
+ * least one block long (setDelay clamps to that).
+ *
+ * clear() doesn't touch the buffer: it only forgets how much has been
+ * written, and read() returns silence for anything older than that. A
+ * 1 s line is ~176 KB of PSRAM, far too much to zero inside one block.
+ */
+class DelayLine {
+private:
+    float* buffer;              // PSRAM (internal RAM fallback)
+    int length;                 // Allocated samples
+    int writePos;
+    int written;                // Samples written since clear(), up to length
+    int delay;                  // Samples
+
+public:
+    DelayLine();
+    ~DelayLine();
+
+    bool allocate(int samples);
+    bool isAllocated() const { return buffer != nullptr; }
+    void clear();
+
+    void setDelay(int samples);
+    int getDelay() const { return delay; }
+
+    // Copy the next `frames` delayed samples to dst (SRAM)
+    void read(float* dst, int frames) const;
+
+    // Append `frames` samples and advance
+    void write(const float* src, int frames);
+};
+
+#endif
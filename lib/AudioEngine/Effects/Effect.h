@@ -0,0 +1,48 @@
+#ifndef EFFECT_H
+#define EFFECT_H
+
+#include <Arduino.h>
+#include <atomic>
+
+/**
+ * Base class for effects on the global bus
+ *
+ * Effects work on whole mono blocks in place (float, -1.0 - 1.0 nominal).
+ * A bypassed effect is skipped entirely by the bus: process() is not
+ * called, its delay lines are not touched and it costs nothing.
+ *
+ * setBypassed() clears the lines, so it belongs to the audio task; other
+ * tasks go through EffectsBus::requestBypass().
+ */
+class Effect {
+private:
+    const char* name;
+    std::atomic<bool> bypassed;     // Read by any task, written by the audio task
+
+public:
+    Effect(const char* effectName) : name(effectName), bypassed(true) {}
+    virtual ~Effect() {}
+
+    /**
+     * Process one block in place
+     *
+     * @param block: Mono samples
+     * @param frames: Block length (max BLOCK_FRAMES)
+     */
+    virtual void process(float* block, int frames) = 0;
+
+    // Forget the tail, e.g. when re-enabled after a bypass. Runs inside a
+    // block, so it must be cheap: no sweeping over the delay lines
+    virtual void clear() {}
+
+    const char* getName() const { return name; }
+    bool isBypassed() const { return bypassed.load(std::memory_order_relaxed); }
+    void setBypassed(bool bypass) {
+        if (isBypassed() && !bypass) {
+            clear();    // Don't replay a stale tail from before the bypass
+        }
+        bypassed.store(bypass, std::memory_order_relaxed);
+    }
+};
+
+#endif
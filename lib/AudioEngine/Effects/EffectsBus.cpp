@@ -0,0 +1,76 @@
+#include "EffectsBus.h"
+#include "../LoadMeter.h"
+#include "Log.h"
+#include "../../../include/CycleCounter.h"
+
+EffectsBus::EffectsBus()
+    : effectCount(0), meter(nullptr) {
+    for (int i = 0; i < MAX_EFFECTS; i++) {
+        effects[i] = nullptr;
+        meterSlots[i] = -1;
+    }
+}
+
+void EffectsBus::begin(LoadMeter* loadMeter) {
+    meter = loadMeter;
+
+    // Both start bypassed ("fx" turns them on); an effect whose lines
+    // don't fit is left out
+    if (delay.begin()) {
+        addEffect(&delay);
+    } else {
+        LOG("[FX] Delay: allocation failed");
+    }
+
+    if (reverb.begin()) {
+        addEffect(&reverb);
+    } else {
+        LOG("[FX] Reverb: allocation failed");
+    }
+}
+
+void EffectsBus::addEffect(Effect* effect) {
+    if (effectCount >= MAX_EFFECTS) {
+        return;
+    }
+    effects[effectCount] = effect;
+    meterSlots[effectCount] = meter ? meter->addSlot(effect->getName()) : -1;
+    effectCount++;
+}
+
+Effect* EffectsBus::findEffect(const char* name) const {
+    for (int i = 0; i < effectCount; i++) {
+        if (strcmp(effects[i]->getName(), name) == 0) {
+            return effects[i];
+        }
+    }
+    return nullptr;
+}
+
+bool EffectsBus::requestBypass(int index, bool bypass) {
+    if (index < 0 || index >= effectCount) {
+        return false;
+    }
+    BypassRequest request = { (int8_t)index, bypass };
+    return requests.push(request);
+}
+
+void EffectsBus::process(float* block, int frames) {
+    BypassRequest request;
+    while (requests.pop(request)) {
+        effects[request.index]->setBypassed(request.bypass);
+    }
+
+    for (int i = 0; i < effectCount; i++) {
+        Effect* effect = effects[i];
+        if (effect->isBypassed()) {
+            continue;
+        }
+
+        uint32_t start = readCycleCounter();
+        effect->process(block, frames);
+        if (meter) {
+            meter->add(meterSlots[i], readCycleCounter() - start);
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef EFFECTSBUS_H
+#define EFFECTSBUS_H
+
+#include "Effect.h"
+#include "FeedbackDelay.h"
+#include "FdnReverb.h"
+#include "../Sequencer/MessageQueue.h"
+
+class LoadMeter;
+
+/**
+ * Global effects bus, after the voice mix and before the output stage
+ *
+ * Effects run in series, in the order they were added. Bypassed effects
+ * are skipped completely. The cycles each active effect takes are
+ * recorded in its own LoadMeter slot.
+ *
+ * Every effect starts bypassed. Bypass changes from other tasks are
+ * posted with requestBypass() and applied by the audio task at the start
+ * of its next process(), so clearing the lines never races the render.
+ */
+class EffectsBus {
+public:
+    static const int MAX_EFFECTS = 4;
+
+private:
+    Effect* effects[MAX_EFFECTS];
+    int meterSlots[MAX_EFFECTS];
+    int effectCount;
+    LoadMeter* meter;
+
+    struct BypassRequest {
+        int8_t index;
+        bool bypass;
+    };
+    MessageQueue<BypassRequest, 8> requests;
+
+public:
+    FeedbackDelay delay;
+    FdnReverb reverb;
+
+    EffectsBus();
+
+    // Allocates the delay lines (PSRAM) and registers meter slots
+    void begin(LoadMeter* loadMeter);
+    void process(float* block, int frames);     // Audio task
+
+    // Any task: applies from the next block. False if the queue is full.
+    bool requestBypass(int index, bool bypass);
+
+    int getEffectCount() const { return effectCount; }
+    Effect* getEffect(int index) const { return effects[index]; }
+    Effect* findEffect(const char* name) const;
+
+private:
+    void addEffect(Effect* effect);
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "FdnReverb.h"
+
+// Mutually prime, ~32-42 ms at 44.1 kHz
+const int FdnReverb::BASE_LENGTHS[LINES] = {1427, 1583, 1693, 1867};
+
+static const float MAX_SIZE = 2.0f;
+
+FdnReverb::FdnReverb()
+    : Effect("reverb"), size(1.0f), decay(1.8f), damping(0.4f), mix(0.2f) {
+    for (int i = 0; i < LINES; i++) {
+        gains[i] = 0.0f;
+        lowpassState[i] = 0.0f;
+    }
+}
+
+bool FdnReverb::begin() {
+    for (int i = 0; i < LINES; i++) {
+        if (!lines[i].allocate((int)(BASE_LENGTHS[i] * MAX_SIZE) + BLOCK_FRAMES)) {
+            return false;
+        }
+    }
+    setSize(size);
+    return true;
+}
+
+void FdnReverb::clear() {
+    for (int i = 0; i < LINES; i++) {
+        lines[i].clear();
+        lowpassState[i] = 0.0f;
+    }
+}
+
+void FdnReverb::setSize(float roomSize) {
+    size = constrain(roomSize, 0.5f, MAX_SIZE);
+    for (int i = 0; i < LINES; i++) {
+        lines[i].setDelay((int)(BASE_LENGTHS[i] * size));
+    }
+    updateGains();
+}
+
+void FdnReverb::setDecay(float seconds) {
+    decay = constrain(seconds, 0.1f, 10.0f);
+    updateGains();
+}
+
+void FdnReverb::setDamping(float amount) {
+    damping = constrain(amount, 0.0f, 1.0f);
+}
+
+void FdnReverb::setMix(float amount) {
+    mix = constrain(amount, 0.0f, 1.0f);
+}
+
+void FdnReverb::updateGains() {
+    // -60 dB after `decay` seconds: g = 10^(-3 * length / (decay * fs))
+    for (int i = 0; i < LINES; i++) {
+        float length = (float)lines[i].getDelay();
+        gains[i] = powf(10.0f, -3.0f * length / (decay * SAMPLE_RATE));
+    }
+}
+
+void FdnReverb::process(float* block, int frames) {
+    if (!lines[0].isAllocated()) {
+        return;
+    }
+
+    for (int l = 0; l < LINES; l++) {
+        lines[l].read(taps[l], frames);
+    }
+
+    float coefficient = 1.0f - damping * 0.8f;
+    float lp0 = lowpassState[0], lp1 = lowpassState[1];
+    float lp2 = lowpassState[2], lp3 = lowpassState[3];
+
+    for (int i = 0; i < frames; i++) {
+        float input = block[i];
+
+        lp0 += coefficient * (taps[0][i] - lp0);
+        lp1 += coefficient * (taps[1][i] - lp1);
+        lp2 += coefficient * (taps[2][i] - lp2);
+        lp3 += coefficient * (taps[3][i] - lp3);
+
+        float y0 = lp0 * gains[0], y1 = lp1 * gains[1];
+        float y2 = lp2 * gains[2], y3 = lp3 * gains[3];
+
+        // Normalised 4x4 Hadamard
+        float a = y0 + y1, b = y0 - y1, c = y2 + y3, d = y2 - y3;
+        taps[0][i] = input + 0.5f * (a + c);
+        taps[1][i] = input + 0.5f * (b + d);
+        taps[2][i] = input + 0.5f * (a - c);
+        taps[3][i] = input + 0.5f * (b - d);
+
+        float wet = (y0 - y1 + y2 - y3) * 0.5f;
+        block[i] = input + mix * wet;
+    }
+
+    lowpassState[0] = lp0; lowpassState[1] = lp1;
+    lowpassState[2] = lp2; lowpassState[3] = lp3;
+
+    for (int l = 0; l < LINES; l++) {
+        lines[l].write(taps[l], frames);
+    }
+}
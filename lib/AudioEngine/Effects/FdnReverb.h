@@ -0,0 +1,51 @@
+#ifndef FDNREVERB_H
+#define FDNREVERB_H
+
+#include "Effect.h"
+#include "DelayLine.h"
+#include "../../../include/Consts.h"
+
+/**
+ * Feedback delay network reverb (4 lines, Hadamard feedback matrix)
+ *
+ * Each line has a mutually prime length, a one-pole lowpass (high
+ * frequencies die first) and a gain set from the decay time so every line
+ * loses 60 dB in `decay` seconds. The lines are mixed back through a 4x4
+ * Hadamard matrix, which is lossless and spreads energy across all lines.
+ *
+ * The shortest line is longer than a block, so all four lines are read and
+ * written block-wise (see DelayLine).
+ */
+class FdnReverb : public Effect {
+public:
+    static const int LINES = 4;
+
+private:
+    static const int BASE_LENGTHS[LINES];
+
+    DelayLine lines[LINES];
+    float taps[LINES][BLOCK_FRAMES];    // SRAM scratch, reused as write blocks
+    float gains[LINES];
+    float lowpassState[LINES];
+    float size;                         // 0.5 - 2.0, scales the line lengths
+    float decay;                        // RT60 in seconds
+    float damping;
+    float mix;
+
+public:
+    FdnReverb();
+
+    bool begin();                       // Allocates the lines in PSRAM
+    void process(float* block, int frames) override;
+    void clear() override;
+
+    void setSize(float roomSize);       // 0.5 - 2.0
+    void setDecay(float seconds);       // 0.1 - 10.0
+    void setDamping(float amount);      // 0.0 - 1.0
+    void setMix(float amount);          // 0.0 - 1.0
+
+private:
+    void updateGains();
+};
+
+#endif
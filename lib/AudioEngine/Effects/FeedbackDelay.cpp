@@ -0,0 +1,56 @@
+#include "FeedbackDelay.h"
+
+FeedbackDelay::FeedbackDelay()
+    : Effect("delay"), feedback(0.35f), mix(0.3f), damping(0.3f), lowpassState(0.0f) {
+}
+
+bool FeedbackDelay::begin() {
+    if (!line.allocate(SAMPLE_RATE * MAX_DELAY_MS / 1000 + BLOCK_FRAMES)) {
+        return false;
+    }
+    setTime(350);
+    return true;
+}
+
+void FeedbackDelay::clear() {
+    line.clear();
+    lowpassState = 0.0f;
+}
+
+void FeedbackDelay::setTime(int milliseconds) {
+    line.setDelay((int)((int64_t)milliseconds * SAMPLE_RATE / 1000));
+}
+
+void FeedbackDelay::setFeedback(float amount) {
+    feedback = constrain(amount, 0.0f, 0.95f);
+}
+
+void FeedbackDelay::setMix(float amount) {
+    mix = constrain(amount, 0.0f, 1.0f);
+}
+
+void FeedbackDelay::setDamping(float amount) {
+    damping = constrain(amount, 0.0f, 1.0f);
+}
+
+void FeedbackDelay::process(float* block, int frames) {
+    if (!line.isAllocated()) {
+        return;
+    }
+
+    line.read(tap, frames);
+
+    float lp = lowpassState;
+    float coefficient = 1.0f - damping * 0.9f;
+    for (int i = 0; i < frames; i++) {
+        float input = block[i];
+        float delayed = tap[i];
+        lp += coefficient * (delayed - lp);
+
+        block[i] = input + mix * delayed;
+        tap[i] = input + feedback * lp;     // Reuse the scratch as the write block
+    }
+    lowpassState = lp;
+
+    line.write(tap, frames);
+}
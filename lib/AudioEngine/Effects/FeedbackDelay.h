@@ -0,0 +1,39 @@
+#ifndef FEEDBACKDELAY_H
+#define FEEDBACKDELAY_H
+
+#include "Effect.h"
+#include "DelayLine.h"
+#include "../../../include/Consts.h"
+
+/**
+ * Feedback (echo) delay
+ *
+ * out = in + mix * tap,  line <- in + feedback * lowpass(tap)
+ * The one-pole lowpass in the loop makes each repeat a little darker.
+ */
+class FeedbackDelay : public Effect {
+public:
+    static const int MAX_DELAY_MS = 1000;
+
+private:
+    DelayLine line;
+    float tap[BLOCK_FRAMES];        // SRAM scratch for the delayed block
+    float feedback;
+    float mix;
+    float damping;                  // 0 = bright, 1 = dark
+    float lowpassState;
+
+public:
+    FeedbackDelay();
+
+    bool begin();                   // Allocates the line in PSRAM
+    void process(float* block, int frames) override;
+    void clear() override;
+
+    void setTime(int milliseconds);
+    void setFeedback(float amount);     // 0.0 - 0.95
+    void setMix(float amount);          // 0.0 - 1.0
+    void setDamping(float amount);      // 0.0 - 1.0
+};
+
+#endif
@@ -0,0 +1,220 @@
+#include "FmVoice.h"
+#include "../../../include/Consts.h"
+#include <math.h>
+#include <string.h>
+
+int16_t FmVoice::sine[SINE_SIZE];
+bool FmVoice::sineReady = false;
+
+// ratio, level, attack, decay, sustain, release
+const FmVoice::Patch FmVoice::PRESETS[PRESET_COUNT] = {
+    { "EPIANO", ALG_4OP_PAIRS, 0.0f, {
+        { 1.0f,  0.8f, 2.0f, 1500.0f, 0.3f, 400.0f },
+        { 1.0f,  0.35f, 1.0f, 800.0f, 0.1f, 300.0f },
+        { 1.0f,  0.4f, 2.0f, 1200.0f, 0.2f, 400.0f },
+        { 14.0f, 0.15f, 1.0f, 150.0f, 0.0f, 100.0f } } },
+    { "BELL", ALG_2OP_STACK, 0.0f, {
+        { 1.0f,  0.9f, 1.0f, 4000.0f, 0.0f, 2000.0f },
+        { 3.5f,  0.5f, 1.0f, 3000.0f, 0.0f, 2000.0f },
+        { 1.0f,  0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+        { 1.0f,  0.0f, 0.0f, 0.0f, 0.0f, 0.0f } } },
+    { "BASS", ALG_3OP_STACK, 0.4f, {
+        { 1.0f,  0.9f, 1.0f, 600.0f, 0.6f, 80.0f },
+        { 1.0f,  0.5f, 1.0f, 300.0f, 0.2f, 80.0f },
+        { 2.0f,  0.3f, 1.0f, 150.0f, 0.0f, 80.0f },
+        { 1.0f,  0.0f, 0.0f, 0.0f, 0.0f, 0.0f } } },
+    { "BRASS", ALG_4OP_BRANCH, 0.6f, {
+        { 1.0f,  0.8f, 60.0f, 300.0f, 0.8f, 150.0f },
+        { 1.0f,  0.45f, 80.0f, 400.0f, 0.6f, 150.0f },
+        { 2.0f,  0.2f, 40.0f, 300.0f, 0.4f, 150.0f },
+        { 1.0f,  0.25f, 100.0f, 500.0f, 0.5f, 150.0f } } },
+};
+
+int FmVoice::operatorCount(Algorithm algorithm) {
+    switch (algorithm) {
+        case ALG_2OP_STACK:
+        case ALG_2OP_PARALLEL:  return 2;
+        case ALG_3OP_STACK:
+        case ALG_3OP_BRANCH:    return 3;
+        default:                return 4;
+    }
+}
+
+const char* FmVoice::algorithmName(Algorithm algorithm) {
+    static const char* names[ALG_COUNT] = {
+        "2op-stack", "2op-parallel", "3op-stack", "3op-branch",
+        "4op-stack", "4op-pairs", "4op-branch", "4op-parallel"
+    };
+    return (algorithm >= 0 && algorithm < ALG_COUNT) ? names[algorithm] : "?";
+}
+
+void FmVoice::buildSineTable() {
+    if (sineReady) {
+        return;
+    }
+    for (int i = 0; i < SINE_SIZE; i++) {
+        sine[i] = (int16_t)lrintf(32767.0f * sinf(2.0f * (float)M_PI * i / SINE_SIZE));
+    }
+    sineReady = true;
+}
+
+FmVoice::FmVoice() : feedbackShift(0) {
+    memset(ops, 0, sizeof(ops));
+    feedback[0] = feedback[1] = 0;
+    setPatch(PRESETS[0]);
+}
+
+void FmVoice::setPatch(const Patch& p) {
+    patch = p;
+    if (patch.algorithm < 0 || patch.algorithm >= ALG_COUNT) {
+        patch.algorithm = ALG_2OP_STACK;
+    }
+
+    // 0 -> off, 1 -> sum of the last two outputs >> 2 (about 2 pi)
+    float amount = patch.feedback < 0.0f ? 0.0f : (patch.feedback > 1.0f ? 1.0f : patch.feedback);
+    feedbackShift = amount > 0.0f ? (int32_t)lrintf(2.0f + (1.0f - amount) * 6.0f) : 0;
+}
+
+void FmVoice::noteOn() {
+    for (int k = 0; k < MAX_OPERATORS; k++) {
+        ops[k].phase = 0;
+        ops[k].stage = ATTACK;
+    }
+    feedback[0] = feedback[1] = 0;
+}
+
+void FmVoice::noteOff() {
+    for (int k = 0; k < MAX_OPERATORS; k++) {
+        if (ops[k].stage != IDLE) {
+            ops[k].stage = RELEASE;
+        }
+    }
+}
+
+bool FmVoice::isActive() const {
+    // The carriers decide; operator 0 is always one
+    return ops[0].stage != IDLE;
+}
+
+float FmVoice::advanceEnvelope(Operator& op, const OperatorPatch& p, int frames) {
+    // Linear segments, advanced one control slice at a time
+    const float msPerSlice = frames * 1000.0f / SAMPLE_RATE;
+    float& e = op.envelope;
+
+    switch (op.stage) {
+        case ATTACK:
+            e += (p.attackMs > 0.0f) ? msPerSlice / p.attackMs : 1.0f;
+            if (e >= 1.0f) {
+                e = 1.0f;
+                op.stage = DECAY;
+            }
+            break;
+        case DECAY:
+            e -= (p.decayMs > 0.0f) ? (1.0f - p.sustain) * msPerSlice / p.decayMs : 1.0f;
+            if (e <= p.sustain) {
+                e = p.sustain;
+                op.stage = SUSTAIN;
+            }
+            break;
+        case RELEASE:
+            e -= (p.releaseMs > 0.0f) ? msPerSlice / p.releaseMs : 1.0f;
+            if (e <= 0.0f) {
+                e = 0.0f;
+                op.stage = IDLE;
+            }
+            break;
+        default:
+            break;
+    }
+    return e;
+}
+
+void FmVoice::prepare(float frequency, int frames) {
+    const float cyclesToPhase = 4294967296.0f / SAMPLE_RATE;
+    int count = operatorCount(patch.algorithm);
+
+    for (int k = 0; k < count; k++) {
+        Operator& op = ops[k];
+        const OperatorPatch& p = patch.ops[k];
+
+        op.increment = (uint32_t)(frequency * p.ratio * cyclesToPhase);
+
+        // Ramp from the current amplitude to this slice's end value
+        float target = advanceEnvelope(op, p, frames) * p.level;
+        int32_t targetAmp = (int32_t)(target * 8388607.0f);
+        op.ampStep = (targetAmp - op.amp) / frames;
+    }
+}
+
+void FmVoice::render(float* output, int frames, float gain) {
+    if (!sineReady) {
+        memset(output, 0, frames * sizeof(float));
+        return;
+    }
+
+    Operator& op0 = ops[0];
+    Operator& op1 = ops[1];
+    Operator& op2 = ops[2];
+    Operator& op3 = ops[3];
+    const float scale = gain / 32768.0f;
+
+    switch (patch.algorithm) {
+        case ALG_2OP_STACK:
+            for (int i = 0; i < frames; i++) {
+                int32_t m = tickFeedback(op1);
+                output[i] = tick(op0, m) * scale;
+            }
+            break;
+
+        case ALG_2OP_PARALLEL:
+            for (int i = 0; i < frames; i++) {
+                output[i] = (tick(op0, 0) + tickFeedback(op1)) * (scale * 0.5f);
+            }
+            break;
+
+        case ALG_3OP_STACK:
+            for (int i = 0; i < frames; i++) {
+                int32_t m = tick(op1, tickFeedback(op2));
+                output[i] = tick(op0, m) * scale;
+            }
+            break;
+
+        case ALG_3OP_BRANCH:
+            for (int i = 0; i < frames; i++) {
+                int32_t m = tick(op1, 0) + tickFeedback(op2);
+                output[i] = tick(op0, m) * scale;
+            }
+            break;
+
+        case ALG_4OP_STACK:
+            for (int i = 0; i < frames; i++) {
+                int32_t m = tick(op2, tickFeedback(op3));
+                m = tick(op1, m);
+                output[i] = tick(op0, m) * scale;
+            }
+            break;
+
+        case ALG_4OP_PAIRS:
+            for (int i = 0; i < frames; i++) {
+                int32_t a = tick(op0, tick(op1, 0));
+                int32_t b = tick(op2, tickFeedback(op3));
+                output[i] = (a + b) * (scale * 0.5f);
+            }
+            break;
+
+        case ALG_4OP_BRANCH:
+            for (int i = 0; i < frames; i++) {
+                int32_t m = tick(op1, 0) + tick(op2, 0) + tickFeedback(op3);
+                output[i] = tick(op0, m) * scale;
+            }
+            break;
+
+        case ALG_4OP_PARALLEL:
+        default:
+            for (int i = 0; i < frames; i++) {
+                int32_t sum = tick(op0, 0) + tick(op1, 0) + tick(op2, 0) + tickFeedback(op3);
+                output[i] = sum * (scale * 0.25f);
+            }
+            break;
+    }
+}
@@ -0,0 +1,120 @@
+#ifndef FMVOICE_H
+#define FMVOICE_H
+
+#include <stdint.h>
+
+/**
+ * 2-4 operator FM (phase modulation) voice in integer arithmetic
+ *
+ * Every operator is a 32-bit phase accumulator reading a shared Q15 sine
+ * table; a modulator's output is added to its target's phase. Operator
+ * envelopes and levels are evaluated once per control slice (prepare())
+ * and ramped linearly in Q23 across it, so the per-sample work is integer
+ * adds, one table read and one multiply per operator.
+ *
+ * Operator 0 is always a carrier; higher numbers modulate lower ones.
+ * The highest operator of the algorithm can feed back into itself.
+ * Each algorithm has its own sample loop, picked once per block.
+ *
+ * No Arduino dependency: tools/bench_fm.cpp runs it on the host.
+ */
+class FmVoice {
+public:
+    static const int MAX_OPERATORS = 4;
+    static const int SINE_BITS = 11;                        // 2048-entry table
+    static const int SINE_SIZE = 1 << SINE_BITS;
+    static const int MOD_SHIFT = 18;                        // Full-scale modulator = 4 pi index
+
+    enum Algorithm {
+        ALG_2OP_STACK,      // 1 -> 0
+        ALG_2OP_PARALLEL,   // 0 + 1
+        ALG_3OP_STACK,      // 2 -> 1 -> 0
+        ALG_3OP_BRANCH,     // (1 + 2) -> 0
+        ALG_4OP_STACK,      // 3 -> 2 -> 1 -> 0
+        ALG_4OP_PAIRS,      // (1 -> 0) + (3 -> 2)
+        ALG_4OP_BRANCH,     // (1 + 2 + 3) -> 0
+        ALG_4OP_PARALLEL,   // 0 + 1 + 2 + 3 (organ)
+        ALG_COUNT
+    };
+
+    struct OperatorPatch {
+        float ratio;        // Frequency multiple of the note
+        float level;        // 0 - 1: output level (carrier) or mod depth (modulator)
+        float attackMs;
+        float decayMs;
+        float sustain;      // 0 - 1
+        float releaseMs;
+    };
+
+    struct Patch {
+        const char* name;
+        Algorithm algorithm;
+        float feedback;     // 0 - 1 on the top operator
+        OperatorPatch ops[MAX_OPERATORS];
+    };
+
+    static const int PRESET_COUNT = 4;
+    static const Patch PRESETS[PRESET_COUNT];
+
+    static int operatorCount(Algorithm algorithm);
+    static const char* algorithmName(Algorithm algorithm);
+
+private:
+    enum Stage { IDLE, ATTACK, DECAY, SUSTAIN, RELEASE };
+
+    struct Operator {
+        uint32_t phase;
+        uint32_t increment;
+        int32_t amp;        // Q23 envelope x level, ramped per sample
+        int32_t ampStep;
+        float envelope;     // 0 - 1, control rate
+        Stage stage;
+    };
+
+    static int16_t sine[SINE_SIZE];
+    static bool sineReady;
+
+    Operator ops[MAX_OPERATORS];
+    Patch patch;
+    int32_t feedbackShift;  // 0 = off
+    int32_t feedback[2];    // Last two outputs of the top operator
+
+public:
+    FmVoice();
+
+    static void buildSineTable();                   // Once, before the first render
+
+    void setPatch(const Patch& p);
+    const Patch& getPatch() const { return patch; }
+
+    void noteOn();
+    void noteOff();
+    bool isActive() const;
+
+    // Control rate: pitch and envelopes for the next `frames` samples
+    void prepare(float frequency, int frames);
+
+    // `frames` samples as float, scaled by `gain`
+    void render(float* output, int frames, float gain);
+
+private:
+    inline int32_t tick(Operator& op, int32_t modulation) {
+        uint32_t index = (op.phase + ((uint32_t)modulation << MOD_SHIFT)) >> (32 - SINE_BITS);
+        int32_t out = ((int32_t)sine[index] * (op.amp >> 8)) >> 15;
+        op.phase += op.increment;
+        op.amp += op.ampStep;
+        return out;
+    }
+
+    inline int32_t tickFeedback(Operator& op) {
+        int32_t modulation = feedbackShift ? ((feedback[0] + feedback[1]) >> feedbackShift) : 0;
+        int32_t out = tick(op, modulation);
+        feedback[1] = feedback[0];
+        feedback[0] = out;
+        return out;
+    }
+
+    float advanceEnvelope(Operator& op, const OperatorPatch& p, int frames);
+};
+
+#endif
@@ -0,0 +1,158 @@
+#include "AudioGraph.h"
+#include "../LoadMeter.h"
+#include "Log.h"
+#include "../../../include/CycleCounter.h"
+
+AudioGraph::AudioGraph()
+    : nodeCount(0), buffersUsed(0), compiled(false), dirty(false), meter(nullptr) {
+    clear();
+}
+
+void AudioGraph::clear() {
+    for (int i = 0; i < MAX_NODES; i++) {
+        nodes[i] = nullptr;
+        inputCounts[i] = 0;
+        meterSlots[i] = -1;
+        order[i] = -1;
+        buffers[i] = NO_BUFFER;
+    }
+    nodeCount = 0;
+    buffersUsed = 0;
+    compiled = false;
+}
+
+int AudioGraph::addNode(AudioNode* node) {
+    if (!node || nodeCount >= MAX_NODES) {
+        return -1;
+    }
+    nodes[nodeCount] = node;
+    compiled = false;
+    return nodeCount++;
+}
+
+bool AudioGraph::connect(int from, int to) {
+    if (from < 0 || from >= nodeCount || to < 0 || to >= nodeCount ||
+        !nodes[from]->hasOutput() || inputCounts[to] >= MAX_INPUTS) {
+        return false;
+    }
+    inputs[to][inputCounts[to]++] = from;
+    compiled = false;
+    return true;
+}
+
+void AudioGraph::setMeterSlot(int node, int slot) {
+    if (node >= 0 && node < nodeCount) {
+        meterSlots[node] = slot;
+    }
+}
+
+bool AudioGraph::compile() {
+    compiled = false;
+    dirty = false;
+
+    // ---- Topological order (Kahn) ----
+    // The ready set is a stack, so a chain (voice -> envelope) runs to its
+    // end before the next one starts; that keeps fewer outputs live at once
+    // than a breadth-first order would.
+    int pending[MAX_NODES];                 // Unprocessed inputs per node
+    int ready[MAX_NODES];
+    int readyCount = 0;
+    for (int n = nodeCount - 1; n >= 0; n--) {
+        pending[n] = inputCounts[n];
+        if (pending[n] == 0) {
+            ready[readyCount++] = n;
+        }
+    }
+
+    int ordered = 0;
+    while (readyCount > 0) {
+        int n = ready[--readyCount];
+        order[ordered++] = n;
+        for (int m = 0; m < nodeCount; m++) {
+            for (int i = 0; i < inputCounts[m]; i++) {
+                if (inputs[m][i] == n && --pending[m] == 0) {
+                    ready[readyCount++] = m;
+                }
+            }
+        }
+    }
+    if (ordered != nodeCount) {
+        LOG("[GRAPH] Patch has a cycle");
+        return false;
+    }
+
+    // ---- Liveness: position of the last reader of each output ----
+    int position[MAX_NODES];
+    int lastUse[MAX_NODES];
+    for (int k = 0; k < nodeCount; k++) {
+        position[order[k]] = k;
+    }
+    for (int n = 0; n < nodeCount; n++) {
+        lastUse[n] = position[n];           // Unread outputs die immediately
+    }
+    for (int m = 0; m < nodeCount; m++) {
+        for (int i = 0; i < inputCounts[m]; i++) {
+            int source = inputs[m][i];
+            lastUse[source] = max(lastUse[source], position[m]);
+        }
+    }
+
+    // ---- Buffer assignment: lowest free buffer, released after last use ----
+    bool inUse[MAX_BUFFERS] = {};
+    buffersUsed = 0;
+    for (int n = 0; n < nodeCount; n++) {
+        buffers[n] = NO_BUFFER;
+    }
+    for (int k = 0; k < nodeCount; k++) {
+        int n = order[k];
+        if (nodes[n]->hasOutput()) {
+            int b = 0;
+            while (b < MAX_BUFFERS && inUse[b]) {
+                b++;
+            }
+            if (b == MAX_BUFFERS) {
+                LOG("[GRAPH] Needs more than %d buffers", MAX_BUFFERS);
+                return false;
+            }
+            inUse[b] = true;
+            buffers[n] = b;
+            buffersUsed = max(buffersUsed, b + 1);
+        }
+
+        // Outputs whose last reader is this node (or nobody) are free again.
+        // Done after the output is assigned so it never aliases an input.
+        for (int s = 0; s < nodeCount; s++) {
+            if (buffers[s] != NO_BUFFER && lastUse[s] == k) {
+                inUse[buffers[s]] = false;
+            }
+        }
+    }
+
+    compiled = true;
+    LOG("[GRAPH] %d nodes, %d of %d buffers", nodeCount, buffersUsed, MAX_BUFFERS);
+    return true;
+}
+
+void AudioGraph::render(int frames) {
+    if (dirty) {
+        compile();
+    }
+    if (!compiled) {
+        return;
+    }
+
+    const float* sources[MAX_INPUTS];
+    for (int k = 0; k < nodeCount; k++) {
+        int n = order[k];
+        for (int i = 0; i < inputCounts[n]; i++) {
+            sources[i] = arena[buffers[inputs[n][i]]];
+        }
+        float* output = (buffers[n] != NO_BUFFER) ? arena[buffers[n]] : nullptr;
+
+        uint32_t start = readCycleCounter();
+        nodes[n]->process(sources, inputCounts[n], output, frames);
+        if (meter && meterSlots[n] >= 0) {
+            meter->add(meterSlots[n], readCycleCounter() - start);
+        }
+    }
+}
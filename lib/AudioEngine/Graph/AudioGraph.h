@@ -0,0 +1,69 @@
+#ifndef AUDIOGRAPH_H
+#define AUDIOGRAPH_H
+
+#include <Arduino.h>
+#include "AudioNode.h"
+#include "../../../include/Consts.h"
+
+class LoadMeter;
+
+/**
+ * Fixed-size audio processing graph
+ *
+ * Nodes and connections are registered up front (addNode/connect). When
+ * the patch changes, compile() orders the nodes topologically (Kahn) and
+ * assigns every node output a buffer from a fixed arena by liveness: a
+ * buffer is returned to the pool right after its last reader ran, and the
+ * next output takes the lowest free one. Greedy assignment over these
+ * live intervals uses the fewest buffers the ordering allows.
+ *
+ * Nothing allocates: nodes, edges, the order and the arena are all fixed
+ * arrays. Patch edits from another task must go through markDirty(); the
+ * graph then recompiles at the start of the next render(), on the audio
+ * task, so the render never sees a half-built order.
+ */
+class AudioGraph {
+public:
+    static const int MAX_NODES = 16;
+    static const int MAX_INPUTS = 8;
+    static const int MAX_BUFFERS = 6;
+    static const int NO_BUFFER = -1;
+
+private:
+    AudioNode* nodes[MAX_NODES];
+    int inputs[MAX_NODES][MAX_INPUTS];      // Source node ids
+    int inputCounts[MAX_NODES];
+    int meterSlots[MAX_NODES];
+    int nodeCount;
+
+    // Compiled state
+    int order[MAX_NODES];
+    int buffers[MAX_NODES];                 // Arena buffer per node output
+    int buffersUsed;
+    bool compiled;
+    volatile bool dirty;
+
+    float arena[MAX_BUFFERS][BLOCK_FRAMES];
+    LoadMeter* meter;
+
+public:
+    AudioGraph();
+
+    // Patch building (setup time, or followed by markDirty())
+    int addNode(AudioNode* node);                   // Node id, -1 if full
+    bool connect(int from, int to);
+    void clear();
+    void setLoadMeter(LoadMeter* loadMeter) { meter = loadMeter; }
+    void setMeterSlot(int node, int slot);          // Several nodes may share a slot
+
+    bool compile();                                 // false: cycle or arena too small
+    void markDirty() { dirty = true; }
+    bool isCompiled() const { return compiled; }
+    int getBuffersUsed() const { return buffersUsed; }
+    int getNodeCount() const { return nodeCount; }
+
+    // Audio task
+    void render(int frames);
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef AUDIONODE_H
+#define AUDIONODE_H
+
+#include <Arduino.h>
+
+/**
+ * One processing step in an AudioGraph
+ *
+ * A node reads any number of mono input blocks and writes one mono output
+ * block (sinks such as OutputNode write nowhere and return false from
+ * hasOutput()). Buffers belong to the graph's arena: a node must not keep
+ * the pointers between calls, and its output never aliases an input.
+ */
+class AudioNode {
+public:
+    virtual ~AudioNode() {}
+
+    /**
+     * Render one block
+     *
+     * @param inputs: Input blocks, in connection order
+     * @param inputCount: Number of inputs
+     * @param output: Output block (nullptr for sinks)
+     * @param frames: Block length (max BLOCK_FRAMES)
+     */
+    virtual void process(const float* const* inputs, int inputCount, float* output, int frames) = 0;
+
+    virtual bool hasOutput() const { return true; }
+};
+
+#endif
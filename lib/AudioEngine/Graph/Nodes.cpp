@@ -0,0 +1,220 @@
+#include "Nodes.h"
+#include "../../../include/Consts.h"
+
+// Sum all inputs into `output` (zeros if there are none)
+static void sumInputs(const float* const* inputs, int inputCount, float* output, int frames) {
+    if (inputCount == 0) {
+        memset(output, 0, frames * sizeof(float));
+        return;
+    }
+    memcpy(output, inputs[0], frames * sizeof(float));
+    for (int n = 1; n < inputCount; n++) {
+        for (int i = 0; i < frames; i++) {
+            output[i] += inputs[n][i];
+        }
+    }
+}
+
+// ========== VoiceNode ==========
+void VoiceNode::process(const float* const*, int, float* output, int frames) {
+    if (!voice || !voice->getIsActive()) {
+        memset(output, 0, frames * sizeof(float));
+        return;
+    }
+
+    voice->prepareBlock(frames);    // Control-rate work (cache refills, ADPCM decode, unison tuning)
+    voice->render(output, frames);
+
+    // Amplitude modulation: linear ramp from the last control value so
+    // steps every control tick don't click
+    if (gain != targetGain) {
+        float step = (targetGain - gain) / frames;
+        float g = gain;
+        for (int i = 0; i < frames; i++) {
+            g += step;
+            output[i] *= g;
+        }
+        gain = targetGain;
+    } else if (gain != 1.0f) {
+        for (int i = 0; i < frames; i++) {
+            output[i] *= gain;
+        }
+    }
+}
+
+// ========== EnvelopeNode ==========
+EnvelopeNode::EnvelopeNode()
+    : stage(IDLE), level(0.0f), sustainLevel(1.0f) {
+    setAttack(5.0f);
+    setDecay(100.0f);
+    setRelease(200.0f);
+}
+
+float EnvelopeNode::stepFor(float ms) {
+    float samples = max(1.0f, ms * SAMPLE_RATE / 1000.0f);
+    return 1.0f / samples;
+}
+
+void EnvelopeNode::setAttack(float ms)  { attackStep = stepFor(ms); }
+void EnvelopeNode::setDecay(float ms)   { decayStep = stepFor(ms); }
+void EnvelopeNode::setRelease(float ms) { releaseStep = stepFor(ms); }
+void EnvelopeNode::setSustain(float value) { sustainLevel = constrain(value, 0.0f, 1.0f); }
+
+void EnvelopeNode::gate(bool on) {
+    if (on) {
+        stage = ATTACK;             // Retrigger from the current level (no click)
+    } else if (stage != IDLE) {
+        stage = RELEASE;
+    }
+}
+
+void EnvelopeNode::process(const float* const* inputs, int inputCount, float* output, int frames) {
+    sumInputs(inputs, inputCount, output, frames);
+
+    if (stage == IDLE) {
+        memset(output, 0, frames * sizeof(float));
+        return;
+    }
+    if (stage == SUSTAIN && sustainLevel >= 1.0f) {
+        return;                     // Unity gain: input passes through
+    }
+
+    for (int i = 0; i < frames; i++) {
+        switch (stage) {
+            case ATTACK:
+                level += attackStep;
+                if (level >= 1.0f) { level = 1.0f; stage = DECAY; }
+                break;
+            case DECAY:
+                level -= decayStep;
+                if (level <= sustainLevel) { level = sustainLevel; stage = SUSTAIN; }
+                break;
+            case RELEASE:
+                level -= releaseStep;
+                if (level <= 0.0f) { level = 0.0f; stage = IDLE; }
+                break;
+            default:
+                break;
+        }
+        output[i] *= level;
+    }
+}
+
+// ========== FilterNode ==========
+FilterNode::FilterNode()
+    : cutoff(20000.0f), resonance(0.0f), ic1eq(0.0f), ic2eq(0.0f) {
+    g = targetG = tanf(PI * cutoff / SAMPLE_RATE);
+}
+
+void FilterNode::setCutoff(float hz) {
+    cutoff = constrain(hz, 20.0f, SAMPLE_RATE * 0.45f);
+    targetG = tanf(PI * cutoff / SAMPLE_RATE);      // Once per control tick
+}
+
+void FilterNode::setResonance(float amount) {
+    resonance = constrain(amount, 0.0f, 1.0f);
+}
+
+void FilterNode::process(const float* const* inputs, int inputCount, float* output, int frames) {
+    sumInputs(inputs, inputCount, output, frames);
+
+    // Cytomic TPT state-variable filter
+    float k = 2.0f - 1.9f * resonance;          // 1/Q: 2 (no peak) down to 0.1
+    float s1 = ic1eq, s2 = ic2eq;
+
+    if (g == targetG) {
+        // Static cutoff: coefficients once per render
+        float a1 = 1.0f / (1.0f + g * (g + k));
+        float a2 = g * a1;
+        float a3 = g * a2;
+        for (int i = 0; i < frames; i++) {
+            float v3 = output[i] - s2;
+            float v1 = a1 * s1 + a2 * v3;
+            float v2 = s2 + a2 * s1 + a3 * v3;
+            s1 = 2.0f * v1 - s1;
+            s2 = 2.0f * v2 - s2;
+            output[i] = v2;                     // Lowpass
+        }
+    } else {
+        // Modulated cutoff: interpolate g to audio rate (no zipper steps)
+        float step = (targetG - g) / frames;
+        float gi = g;
+        for (int i = 0; i < frames; i++) {
+            gi += step;
+            float a1 = 1.0f / (1.0f + gi * (gi + k));
+            float a2 = gi * a1;
+            float a3 = gi * a2;
+            float v3 = output[i] - s2;
+            float v1 = a1 * s1 + a2 * v3;
+            float v2 = s2 + a2 * s1 + a3 * v3;
+            s1 = 2.0f * v1 - s1;
+            s2 = 2.0f * v2 - s2;
+            output[i] = v2;
+        }
+        g = targetG;
+    }
+    ic1eq = s1;
+    ic2eq = s2;
+}
+
+// ========== MixerNode ==========
+MixerNode::MixerNode()
+    : masterGain(1.0f) {
+    for (int i = 0; i < 8; i++) {
+        gains[i] = 1.0f;
+    }
+}
+
+void MixerNode::setInputGain(int input, float gain) {
+    if (input >= 0 && input < 8) {
+        gains[input] = gain;
+    }
+}
+
+void MixerNode::process(const float* const* inputs, int inputCount, float* output, int frames) {
+    memset(output, 0, frames * sizeof(float));
+    for (int n = 0; n < inputCount; n++) {
+        float gain = gains[n] * masterGain;
+        const float* input = inputs[n];
+        for (int i = 0; i < frames; i++) {
+            output[i] += gain * input[i];
+        }
+    }
+}
+
+// ========== EffectNode ==========
+void EffectNode::process(const float* const* inputs, int inputCount, float* output, int frames) {
+    sumInputs(inputs, inputCount, output, frames);
+    if (bus) {
+        bus->process(output, frames);
+    }
+}
+
+// ========== CaptureNode ==========
+void CaptureNode::process(const float* const* inputs, int inputCount, float*, int frames) {
+    if (target) {
+        sumInputs(inputs, inputCount, target, frames);
+    }
+}
+
+// ========== BusInputNode ==========
+void BusInputNode::setSources(const float* const* buffers, int count) {
+    sourceCount = count < MAX_SOURCES ? count : MAX_SOURCES;
+    for (int i = 0; i < sourceCount; i++) {
+        sources[i] = buffers[i];
+    }
+}
+
+void BusInputNode::process(const float* const*, int, float* output, int frames) {
+    sumInputs(sources, sourceCount, output, frames);
+}
+
+// ========== OutputNode ==========
+void OutputNode::process(const float* const* inputs, int inputCount, float*, int frames) {
+    if (!target) {
+        return;
+    }
+
+    // Conversion and interleave are specialised for the build's format
+    AudioFormat::write(inputs, inputCount, target, frames);
+}
@@ -0,0 +1,138 @@
+#ifndef NODES_H
+#define NODES_H
+
+#include "AudioNode.h"
+#include "../Voice.h"
+#include "../Effects/EffectsBus.h"
+#include "../../../include/Consts.h"
+
+// ========== Oscillator: renders one Voice ==========
+class VoiceNode : public AudioNode {
+private:
+    Voice* voice;
+    float gain;             // Modulation gain, ramped to targetGain over one render
+    float targetGain;
+
+public:
+    VoiceNode(Voice* v = nullptr) : voice(v), gain(1.0f), targetGain(1.0f) {}
+    void setVoice(Voice* v) { voice = v; }
+    void setGain(float g) { targetGain = g; }   // Control rate
+    void process(const float* const* inputs, int inputCount, float* output, int frames) override;
+};
+
+// ========== Envelope: ADSR applied to its (summed) inputs ==========
+class EnvelopeNode : public AudioNode {
+public:
+    enum Stage { IDLE, ATTACK, DECAY, SUSTAIN, RELEASE };
+
+private:
+    Stage stage;
+    float level;
+    float attackStep;       // Per-sample increments (linear segments)
+    float decayStep;
+    float sustainLevel;
+    float releaseStep;
+
+public:
+    EnvelopeNode();
+
+    void setAttack(float ms);
+    void setDecay(float ms);
+    void setSustain(float level);       // 0.0 - 1.0
+    void setRelease(float ms);
+    void gate(bool on);
+    Stage getStage() const { return stage; }
+    float getLevel() const { return level; }
+
+    void process(const float* const* inputs, int inputCount, float* output, int frames) override;
+
+private:
+    static float stepFor(float ms);
+};
+
+// ========== Filter: 2-pole state-variable lowpass ==========
+class FilterNode : public AudioNode {
+private:
+    float cutoff;           // Hz
+    float resonance;        // 0.0 - 1.0
+    float g;                // tan(pi * fc / fs), ramped to targetG over one render
+    float targetG;
+    float ic1eq;            // Integrator states (TPT SVF)
+    float ic2eq;
+
+public:
+    FilterNode();
+
+    void setCutoff(float hz);           // Control rate; the next render glides to it
+    void setResonance(float amount);
+    float getCutoff() const { return cutoff; }
+
+    void process(const float* const* inputs, int inputCount, float* output, int frames) override;
+};
+
+// ========== Mixer: weighted sum of all inputs ==========
+class MixerNode : public AudioNode {
+private:
+    float gains[8];         // Per input (AudioGraph::MAX_INPUTS)
+    float masterGain;
+
+public:
+    MixerNode();
+
+    void setInputGain(int input, float gain);
+    void setGain(float gain) { masterGain = gain; }
+
+    void process(const float* const* inputs, int inputCount, float* output, int frames) override;
+};
+
+// ========== Effect: runs the effects bus on its input ==========
+class EffectNode : public AudioNode {
+private:
+    EffectsBus* bus;
+
+public:
+    EffectNode(EffectsBus* effectsBus = nullptr) : bus(effectsBus) {}
+    void setBus(EffectsBus* effectsBus) { bus = effectsBus; }
+    void process(const float* const* inputs, int inputCount, float* output, int frames) override;
+};
+
+// ========== Capture: copy the (summed) inputs out of the graph ==========
+class CaptureNode : public AudioNode {
+private:
+    float* target;          // Outside the arena, e.g. a per-core mix buffer
+
+public:
+    CaptureNode() : target(nullptr) {}
+    void setTarget(float* buffer) { target = buffer; }
+    bool hasOutput() const override { return false; }
+    void process(const float* const* inputs, int inputCount, float* output, int frames) override;
+};
+
+// ========== Bus input: sums external buffers into the graph ==========
+class BusInputNode : public AudioNode {
+public:
+    static const int MAX_SOURCES = 4;
+
+private:
+    const float* sources[MAX_SOURCES];
+    int sourceCount;
+
+public:
+    BusInputNode() : sourceCount(0) {}
+    void setSources(const float* const* buffers, int count);
+    void process(const float* const* inputs, int inputCount, float* output, int frames) override;
+};
+
+// ========== Output: clip, convert to int16, write stereo interleaved ==========
+class OutputNode : public AudioNode {
+private:
+    AudioFormat::Sample* target;        // BLOCK_FRAMES * CHANNELS slots
+
+public:
+    OutputNode(AudioFormat::Sample* buffer = nullptr) : target(buffer) {}
+    void setTarget(AudioFormat::Sample* buffer) { target = buffer; }
+    bool hasOutput() const override { return false; }
+    void process(const float* const* inputs, int inputCount, float* output, int frames) override;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#include "LoadMeter.h"
+#include "Log.h"
+#include "../../include/CycleCounter.h"
+
+LoadMeter::LoadMeter()
+    : slotCount(0), budgetCycles(1), windowFrames(1), framesInWindow(0), logReports(false) {
+    for (int i = 0; i < MAX_SLOTS; i++) {
+        names[i] = nullptr;
+        blockCycles[i] = 0;
+        windowCycles[i] = 0;
+        windowPeak[i] = 0;
+        averagePermille[i].store(0);
+        peakPermille[i].store(0);
+    }
+}
+
+void LoadMeter::begin(uint32_t reportMs, bool log) {
+    budgetCycles = (uint32_t)((uint64_t)cycleCounterMHz() * 1000000ULL * BLOCK_FRAMES / SAMPLE_RATE);
+    windowFrames = max(1UL, (unsigned long)((uint64_t)reportMs * SAMPLE_RATE / 1000));
+    logReports = log;
+}
+
+int LoadMeter::addSlot(const char* name) {
+    if (slotCount >= MAX_SLOTS) {
+        return -1;
+    }
+    names[slotCount] = name;
+    return slotCount++;
+}
+
+void LoadMeter::endBlock(int frames) {
+    uint32_t budget = max(1UL, (unsigned long)getBudgetCycles(frames));
+    for (int i = 0; i < slotCount; i++) {
+        windowCycles[i] += blockCycles[i];
+        uint32_t permille = (uint32_t)((uint64_t)blockCycles[i] * 1000 / budget);
+        if (permille > windowPeak[i]) {
+            windowPeak[i] = permille;
+        }
+        blockCycles[i] = 0;
+    }
+
+    if ((framesInWindow += frames) >= windowFrames) {
+        publish();
+    }
+}
+
+void LoadMeter::publish() {
+    for (int i = 0; i < slotCount; i++) {
+        uint32_t average = (uint32_t)(windowCycles[i] * 1000 * BLOCK_FRAMES / ((uint64_t)budgetCycles * framesInWindow));
+        uint32_t peak = windowPeak[i];
+        averagePermille[i].store(average, std::memory_order_relaxed);
+        peakPermille[i].store(peak, std::memory_order_relaxed);
+
+        if (logReports) {
+            LOG("[LOAD] %-8s avg %3u.%u%% peak %3u%%", names[i],
+                (unsigned)(average / 10), (unsigned)(average % 10), (unsigned)(peak / 10));
+        }
+
+        windowCycles[i] = 0;
+        windowPeak[i] = 0;
+    }
+    framesInWindow = 0;
+}
@@ -0,0 +1,68 @@
+#ifndef LOADMETER_H
+#define LOADMETER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "../../include/Consts.h"
+
+/**
+ * Per-block DSP load meter for the audio task
+ *
+ * Each stage of the render (voices, every effect, the whole block) owns a
+ * slot. The audio task adds the cycles it spent in a slot with add(), and
+ * calls endBlock() once per block. Load is expressed in permille of the
+ * block budget (the cycles one block of audio lasts), averaged and peaked
+ * over a report window. Blocks may be shorter than BLOCK_FRAMES (see
+ * BufferController): budgets and windows scale with each block's frames.
+ *
+ * At the end of each window the figures are published through atomics
+ * (readable from the UI core) and, if enabled, logged via LOG.
+ */
+class LoadMeter {
+public:
+    static const int MAX_SLOTS = 8;
+    static const uint32_t DEFAULT_REPORT_MS = 5000;
+
+private:
+    const char* names[MAX_SLOTS];
+    uint32_t blockCycles[MAX_SLOTS];        // Current block
+    uint64_t windowCycles[MAX_SLOTS];       // Current window, summed
+    uint32_t windowPeak[MAX_SLOTS];         // Current window, worst block (permille)
+    std::atomic<uint32_t> averagePermille[MAX_SLOTS];
+    std::atomic<uint32_t> peakPermille[MAX_SLOTS];
+    int slotCount;
+
+    uint32_t budgetCycles;                  // One BLOCK_FRAMES block at the CPU clock
+    uint32_t windowFrames;
+    uint32_t framesInWindow;
+    bool logReports;
+
+public:
+    LoadMeter();
+
+    // Setup time only (not thread-safe against the audio task)
+    void begin(uint32_t reportMs = DEFAULT_REPORT_MS, bool log = true);
+    int addSlot(const char* name);          // -1 if full
+
+    // Audio task
+    inline void add(int slot, uint32_t cycles) {
+        if (slot >= 0) {
+            blockCycles[slot] += cycles;
+        }
+    }
+    void endBlock(int frames = BLOCK_FRAMES);
+
+    // Any core
+    int getSlotCount() const { return slotCount; }
+    const char* getSlotName(int slot) const { return names[slot]; }
+    uint32_t getAveragePermille(int slot) const { return averagePermille[slot].load(std::memory_order_relaxed); }
+    uint32_t getPeakPermille(int slot) const { return peakPermille[slot].load(std::memory_order_relaxed); }
+    uint32_t getBudgetCycles(int frames = BLOCK_FRAMES) const {
+        return (uint32_t)((uint64_t)budgetCycles * frames / BLOCK_FRAMES);
+    }
+
+private:
+    void publish();
+};
+
+#endif
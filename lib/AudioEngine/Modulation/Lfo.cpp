@@ -0,0 +1,29 @@
+#include "Lfo.h"
+#include "../../../include/Consts.h"
+
+Lfo::Lfo(Shape lfoShape, float hz)
+    : shape(lfoShape), rate(hz), phase(0.0f), held(0.0f) {
+}
+
+void Lfo::setRate(float hz) {
+    rate = constrain(hz, 0.01f, 50.0f);
+}
+
+float Lfo::advance(int samples) {
+    phase += rate * samples / SAMPLE_RATE;
+    if (phase >= 1.0f) {
+        phase -= (int)phase;
+        if (shape == SAMPLE_HOLD) {
+            held = random(-32767, 32767) / 32767.0f;    // New step once per cycle
+        }
+    }
+
+    switch (shape) {
+        case SINE:        return sinf(TWO_PI * phase);
+        case TRIANGLE:    return (phase < 0.5f) ? 4.0f * phase - 1.0f : 3.0f - 4.0f * phase;
+        case SAW:         return 2.0f * phase - 1.0f;
+        case SQUARE:      return (phase < 0.5f) ? 1.0f : -1.0f;
+        case SAMPLE_HOLD: return held;
+    }
+    return 0.0f;
+}
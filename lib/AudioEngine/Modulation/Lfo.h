@@ -0,0 +1,33 @@
+#ifndef LFO_H
+#define LFO_H
+
+#include <Arduino.h>
+
+/**
+ * Low-frequency oscillator, advanced at control rate
+ *
+ * advance(samples) moves the phase on by that many audio samples and
+ * returns the new value (-1.0 - 1.0). It is called once per control tick,
+ * never per audio sample.
+ */
+class Lfo {
+public:
+    enum Shape { SINE, TRIANGLE, SAW, SQUARE, SAMPLE_HOLD };
+
+private:
+    Shape shape;
+    float rate;             // Hz
+    float phase;            // 0.0 - 1.0
+    float held;             // SAMPLE_HOLD value
+
+public:
+    Lfo(Shape lfoShape = SINE, float hz = 1.0f);
+
+    void setShape(Shape lfoShape) { shape = lfoShape; }
+    void setRate(float hz);
+    void reset() { phase = 0.0f; }
+
+    float advance(int samples);
+};
+
+#endif
@@ -0,0 +1,63 @@
+#include "ModMatrix.h"
+
+static const char* const SOURCE_NAMES[ModMatrix::SOURCE_COUNT] = {
+    "lfo1", "lfo2", "env", "pot1", "pot2", "cc1", "cc2", "cc3", "cc4"
+};
+
+static const char* const DESTINATION_NAMES[ModMatrix::DESTINATION_COUNT] = {
+    "pitch", "amp", "cutoff", "wtpos"
+};
+
+ModMatrix::ModMatrix() {
+    for (int i = 0; i < MAX_ROUTES; i++) {
+        routes[i].source = SRC_NONE;
+        routes[i].destination = DST_PITCH;
+        routes[i].depth = 0.0f;
+    }
+}
+
+bool ModMatrix::setRoute(int slot, Source source, Destination destination, float depth) {
+    if (slot < 0 || slot >= MAX_ROUTES || source < SRC_NONE || source >= SOURCE_COUNT ||
+        destination < 0 || destination >= DESTINATION_COUNT) {
+        return false;
+    }
+
+    // Disable first so the audio task never pairs the new source with the old target
+    routes[slot].source = SRC_NONE;
+    routes[slot].destination = destination;
+    routes[slot].depth = depth;
+    routes[slot].source = source;
+    return true;
+}
+
+uint32_t ModMatrix::getDestinationMask() const {
+    uint32_t mask = 0;
+    for (int i = 0; i < MAX_ROUTES; i++) {
+        if (routes[i].source != SRC_NONE) {
+            mask |= 1UL << routes[i].destination;
+        }
+    }
+    return mask;
+}
+
+void ModMatrix::evaluate(const float* sources, float* offsets) const {
+    for (int d = 0; d < DESTINATION_COUNT; d++) {
+        offsets[d] = 0.0f;
+    }
+
+    for (int i = 0; i < MAX_ROUTES; i++) {
+        int source = routes[i].source;
+        if (source == SRC_NONE) {
+            continue;
+        }
+        offsets[routes[i].destination] += routes[i].depth * sources[source];
+    }
+}
+
+const char* ModMatrix::getSourceName(int source) {
+    return (source >= 0 && source < SOURCE_COUNT) ? SOURCE_NAMES[source] : "-";
+}
+
+const char* ModMatrix::getDestinationName(int destination) {
+    return (destination >= 0 && destination < DESTINATION_COUNT) ? DESTINATION_NAMES[destination] : "-";
+}
@@ -0,0 +1,82 @@
+#ifndef MODMATRIX_H
+#define MODMATRIX_H
+
+#include <Arduino.h>
+
+/**
+ * Modulation matrix, evaluated at control rate
+ *
+ * Each route adds depth * source to one destination. Sources are plain
+ * values the engine collects once per control tick (LFOs -1..1, envelopes,
+ * pots and MIDI CCs 0..1); destinations come out as offsets the engine
+ * applies to its base values:
+ *   PITCH        octaves            freq  = base * 2^offset
+ *   AMPLITUDE    linear             gain  = 1 + offset (0 - 2)
+ *   CUTOFF       octaves            freq  = base * 2^offset
+ *   WT_POSITION  morph units        pos   = base + offset (0 - 1)
+ *
+ * Routes may be edited from the UI core while the audio task evaluates;
+ * each field is a single aligned store, so the worst case is one tick
+ * with a half-updated route.
+ */
+class ModMatrix {
+public:
+    enum Source {
+        SRC_NONE = -1,
+        SRC_LFO1,
+        SRC_LFO2,
+        SRC_ENVELOPE,       // The voice's own amp envelope
+        SRC_POT_PITCH,
+        SRC_POT_TONE,
+        SRC_CC1,            // MIDI CC slots, set from the console for now
+        SRC_CC2,
+        SRC_CC3,
+        SRC_CC4,
+        SOURCE_COUNT
+    };
+
+    enum Destination {
+        DST_PITCH,
+        DST_AMPLITUDE,
+        DST_CUTOFF,
+        DST_WT_POSITION,
+        DESTINATION_COUNT
+    };
+
+    static const int MAX_ROUTES = 8;
+
+    struct Route {
+        volatile int source;        // Source, SRC_NONE = unused
+        volatile int destination;
+        volatile float depth;
+    };
+
+private:
+    Route routes[MAX_ROUTES];
+
+public:
+    ModMatrix();
+
+    /**
+     * Set (or clear, with SRC_NONE) one route
+     *
+     * @param slot: 0 - MAX_ROUTES-1
+     * @param source: Source
+     * @param destination: Destination
+     * @param depth: Scale, in destination units per unit of source
+     */
+    bool setRoute(int slot, Source source, Destination destination, float depth);
+    void clearRoute(int slot) { setRoute(slot, SRC_NONE, DST_PITCH, 0.0f); }
+    const Route& getRoute(int slot) const { return routes[slot]; }
+
+    // Bit per destination with at least one active route
+    uint32_t getDestinationMask() const;
+
+    // offsets[DESTINATION_COUNT] = sum of depth * sources[source]
+    void evaluate(const float* sources, float* offsets) const;
+
+    static const char* getSourceName(int source);
+    static const char* getDestinationName(int destination);
+};
+
+#endif
@@ -0,0 +1,62 @@
+#include "OscillatorBank.h"
+#include "../../../include/Consts.h"
+#include <math.h>
+#include <string.h>
+
+OscillatorBank::OscillatorBank() : used(0), noise(0x12345678) {
+    memset(phases, 0, sizeof(phases));
+    memset(increments, 0, sizeof(increments));
+    memset(gains, 0, sizeof(gains));
+}
+
+int OscillatorBank::allocate(int count) {
+    if (count <= 0 || used + count > MAX_OSCILLATORS) {
+        return -1;
+    }
+    int first = used;
+    used += count;
+    return first;
+}
+
+void OscillatorBank::setUnison(int first, int count, float frequency, float detune, float mix) {
+    // Detune offsets: evenly spaced in [-1, 1]; the centre one (odd counts)
+    // keeps the played pitch and its own level
+    const float cyclesToPhase = 4294967296.0f / SAMPLE_RATE;
+    const float spread = detune * MAX_DETUNE_SEMITONES / 12.0f;     // Octaves
+    const float norm = 1.0f / sqrtf((float)count);                  // Uncorrelated saws add in power
+    const float scale = 1.0f / 2147483648.0f;                       // int32 phase -> [-1, 1)
+
+    for (int k = 0; k < count; k++) {
+        float offset = (count > 1) ? (2.0f * k / (count - 1) - 1.0f) : 0.0f;
+        float ratio = exp2f(offset * spread);
+        increments[first + k] = (uint32_t)(frequency * ratio * cyclesToPhase);
+
+        bool centre = (count & 1) && (k == count / 2);
+        float level = centre ? 1.0f : mix;
+        gains[first + k] = level * norm * scale;
+    }
+}
+
+void OscillatorBank::randomizePhases(int first, int count) {
+    for (int k = 0; k < count; k++) {
+        noise = noise * 1664525u + 1013904223u;     // LCG: start phases only
+        phases[first + k] = noise;
+    }
+}
+
+void OscillatorBank::render(int first, int count, float* output, int frames) {
+    memset(output, 0, frames * sizeof(float));
+
+    for (int o = first; o < first + count; o++) {
+        uint32_t phase = phases[o];
+        const uint32_t increment = increments[o];
+        const float gain = gains[o];
+
+        // Saw: the phase read as signed is already a ramp from -2^31 to 2^31
+        for (int i = 0; i < frames; i++) {
+            output[i] += (float)(int32_t)phase * gain;
+            phase += increment;
+        }
+        phases[o] = phase;
+    }
+}
@@ -0,0 +1,135 @@
+#ifndef DMARING_H
+#define DMARING_H
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+/**
+ * Hands out the I2S DMA buffers for rendering in place (zero-copy output)
+ *
+ * The DMA plays a fixed ring of buffers round and round; after each one
+ * its "sent" interrupt reports it with onSent(). Event k is always for
+ * the k-th buffer played, so the buffer to render block s into is the
+ * one reported by event s, and it is free from then until the ring comes
+ * back round to it. Buffer addresses are learnt from the events (the
+ * driver keeps its own list private).
+ *
+ *   event s  ->  [ render block s ]  ...  event s+N-1  ->  block s plays
+ *
+ * A ring of N buffers leaves N-2 periods to render a block in. The last
+ * period before the buffer comes round is kept as margin, since the DMA
+ * fetches the next descriptor before it reports the current one, so a
+ * block is late once sent - s reaches N-1. A block whose buffer is
+ * already that close when the task comes to it is skipped: it resyncs to
+ * the buffer sent last, which is an underrun unless the task was away on
+ * purpose (a park).
+ *
+ * onSent() also clears the buffer. A skipped block then plays silence,
+ * like the legacy driver's tx_desc_auto_clear, and the clear can't race
+ * the task: the driver's own auto_clear runs after the callback, by
+ * which time the task may already be rendering into it from the other
+ * core.
+ *
+ * One writer per side: onSent() from the DMA interrupt, everything else
+ * from the audio task. tools/dma_ring_sim.cpp runs it against a modelled
+ * DMA.
+ */
+class DmaRing {
+public:
+    static const int MAX_BUFFERS = 8;
+
+private:
+    int count;
+    size_t bufferBytes;
+    void* buffers[MAX_BUFFERS];         // buffers[k % count]: the buffer of event k
+    std::atomic<uint32_t> sent;         // Events so far
+    std::atomic<bool> waiting;          // The task is blocked until the next event
+
+    // Audio task
+    uint32_t next;                      // Block to render next
+    uint32_t current;                   // Block acquired and not yet committed
+    bool skipped;                       // acquire() resynced past stale buffers
+    bool behind;                        // The last block was late
+    uint32_t underruns;                 // Unexpected late or skipped runs, each counted once
+    uint32_t skippedBlocks;
+
+public:
+    DmaRing() : count(0), bufferBytes(0), sent(0), waiting(false),
+                next(0), current(0), skipped(false), behind(false), underruns(0), skippedBlocks(0) {
+        for (int i = 0; i < MAX_BUFFERS; i++) {
+            buffers[i] = nullptr;
+        }
+    }
+
+    // Before the DMA starts; 3 to MAX_BUFFERS buffers of `bytes` each
+    bool begin(int bufferCount, size_t bytes) {
+        if (bufferCount < 3 || bufferCount > MAX_BUFFERS) {
+            return false;
+        }
+        count = bufferCount;
+        bufferBytes = bytes;
+        return true;
+    }
+
+    // DMA interrupt: `buffer` has just been played. Returns true when the
+    // audio task is waiting for it (notify it).
+    inline bool onSent(void* buffer) {
+        uint32_t k = sent.load(std::memory_order_relaxed);
+        memset(buffer, 0, bufferBytes);
+        buffers[k % count] = buffer;
+        sent.store(k + 1);
+        return waiting.exchange(false);
+    }
+
+    // The buffer for the next block, or nullptr until the DMA has freed
+    // one (prepareWait(), try again, then block)
+    void* acquire() {
+        uint32_t s = sent.load(std::memory_order_acquire);
+        if (s <= next) {
+            return nullptr;
+        }
+        skipped = false;
+        if (s - next >= (uint32_t)count - 1) {
+            skippedBlocks += s - 1 - next;
+            next = s - 1;
+            skipped = true;
+        }
+        current = next;
+        return buffers[current % count];
+    }
+
+    // Before blocking on the notification: the next onSent() sends one.
+    // Call acquire() again after this, it may have happened already.
+    void prepareWait() { waiting.store(true); }
+    void cancelWait() { waiting.store(false); }
+
+    // The acquired block is rendered. Returns false if it missed its
+    // slot: buffers were skipped to reach it, or it may have started
+    // playing before this. A late block and the skip after it are one
+    // underrun; with `expected` (after a park) a skip is none.
+    bool commit(bool expected = false) {
+        uint32_t s = sent.load(std::memory_order_relaxed);
+        bool late = s - current >= (uint32_t)count - 1;
+        next = current + 1;
+        if ((late || (skipped && !expected)) && !behind) {
+            underruns++;
+        }
+        behind = late;
+        return !late && !skipped;
+    }
+
+    // Buffers to play before the committed block, the playing one included
+    uint32_t getBuffersAhead() const {
+        uint32_t s = sent.load(std::memory_order_relaxed);
+        uint32_t starts = current + count;          // Sent count when it starts playing
+        return starts > s ? starts - s : 0;
+    }
+
+    int getCount() const { return count; }
+    uint32_t getSent() const { return sent.load(std::memory_order_relaxed); }
+    uint32_t getUnderruns() const { return underruns; }
+    uint32_t getSkippedBlocks() const { return skippedBlocks; }
+};
+
+#endif
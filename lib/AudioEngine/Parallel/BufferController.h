@@ -0,0 +1,188 @@
+#ifndef BUFFERCONTROLLER_H
+#define BUFFERCONTROLLER_H
+
+#include <stdint.h>
+#include <atomic>
+#include "../../../include/Consts.h"
+
+/**
+ * Picks the render block size and DMA queue depth from recent history
+ *
+ * Output latency is roughly the frames queued in the I2S DMA ahead of a
+ * block plus the block itself. Each LEVEL is one such pair; level 0 is
+ * the shortest. In AUTO mode, once per block:
+ * - an underrun (the DMA ran dry) grows one level at once. The level that
+ *   failed, and every shallower one, takes a strike and is barred for a
+ *   hold time that doubles with each strike (all cleared after
+ *   FORGIVE_FRAMES without an underrun), so a unit that can't sustain a
+ *   level soon stops retrying it;
+ * - GROW_AFTER_BLOCKS blocks in a row above GROW_PERMILLE of their time
+ *   budget also grow one level, before an underrun happens;
+ * - a whole SHRINK_AFTER_FRAMES window in which every block rendered in
+ *   under DEADLINE_PERMILLE of the next level down's deadline (its queue
+ *   + block), and the average load stayed under SHRINK_PERMILLE, shrinks
+ *   one level. The per-block deadline test keeps occasional stalls from
+ *   shrinking the depth below what covers them; the gap between the
+ *   two load thresholds is the hysteresis that stops the level flapping.
+ * Any change restarts the windows, so every decision is based on blocks
+ * rendered at the current level.
+ *
+ * Transitions are glitch-free by construction: every sample is still
+ * rendered in order, only the size of the next block and how far ahead
+ * of the DMA it is written change.
+ *
+ * Only the grow run is counted in blocks; the shrink, hold and forgive
+ * windows are in frames, because the block size is what the level sets.
+ * tools/buffer_sim.cpp replays load traces through it.
+ */
+class BufferController {
+public:
+    struct Level {
+        uint16_t blockFrames;       // Render block (power of two, divides BLOCK_FRAMES)
+        uint16_t queueFrames;       // Most frames left queued in the DMA when a block is written
+    };
+
+    static const int LEVEL_COUNT = 5;
+    static const int AUTO = -1;
+
+    static const uint32_t GROW_PERMILLE = 850;
+    static const int GROW_AFTER_BLOCKS = 3;
+    static const uint32_t SHRINK_PERMILLE = 700;
+    static const uint32_t DEADLINE_PERMILLE = 800;
+    static const uint32_t SHRINK_AFTER_FRAMES = SAMPLE_RATE * 2;
+    static const uint32_t HOLD_FRAMES = SAMPLE_RATE * 10;   // Doubles per repeated failure...
+    static const int MAX_HOLD_SHIFT = 8;                    // ...up to ~43 min
+    static const uint32_t FORGIVE_FRAMES = SAMPLE_RATE * 3600;  // An hour clean: back to 10 s
+
+    static const Level& level(int index) {
+        static const Level LEVELS[LEVEL_COUNT] = {
+            {  64,  64 },       // ~2.9 ms at 44.1 kHz
+            {  64, 128 },
+            { 128, 128 },
+            { 128, 256 },
+            { 256, 256 },       // ~11.6 ms: the fixed-size engine's depth
+        };
+        return LEVELS[index];
+    }
+
+private:
+    int current;
+    uint32_t holdFrames[LEVEL_COUNT];   // Level barred while > 0 (it underran)
+    int strikes[LEVEL_COUNT];           // Underruns at or deeper than each level
+    uint32_t cleanFrames;               // Since the last underrun
+    uint32_t calmFrames;            // Shrink window: frames, all in time one level down...
+    uint32_t calmRenderFrames;      // ...and the time spent rendering them
+    int busyBlocks;
+    uint32_t underruns;
+    uint32_t changes;
+    std::atomic<int> requested;     // AUTO or a fixed level, from the UI
+
+public:
+    BufferController()
+        : current(LEVEL_COUNT - 1), cleanFrames(0), calmFrames(0), calmRenderFrames(0),
+          busyBlocks(0), underruns(0), changes(0), requested(AUTO) {
+        for (int i = 0; i < LEVEL_COUNT; i++) {
+            holdFrames[i] = 0;
+            strikes[i] = 0;
+        }
+    }
+
+    // Any task: AUTO, or pin a level (0 - LEVEL_COUNT-1)
+    void request(int mode) {
+        requested.store(mode < AUTO || mode >= LEVEL_COUNT ? AUTO : mode, std::memory_order_relaxed);
+    }
+    int getRequest() const { return requested.load(std::memory_order_relaxed); }
+
+    /**
+     * Audio task, after each block has been written
+     *
+     * @param frames: Size of the block just rendered
+     * @param loadPermille: Its render time, in permille of its own duration
+     * @param underrun: The DMA played out of data since the last block
+     * @return true if the level changed
+     */
+    bool report(uint32_t frames, uint32_t loadPermille, bool underrun) {
+        int previous = current;
+        int fixed = requested.load(std::memory_order_relaxed);
+        if (underrun) {
+            underruns++;
+        }
+
+        if (fixed != AUTO) {
+            current = fixed;
+        } else {
+            for (int i = 0; i < LEVEL_COUNT; i++) {
+                holdFrames[i] = holdFrames[i] > frames ? holdFrames[i] - frames : 0;
+            }
+
+            if (underrun) {
+                // Bar the level that failed, and every shallower one (it
+                // would fail too); repeat offenders wait longer
+                for (int i = 0; i <= current; i++) {
+                    int shift = strikes[i] < MAX_HOLD_SHIFT ? strikes[i] : MAX_HOLD_SHIFT;
+                    uint32_t hold = HOLD_FRAMES << shift;
+                    holdFrames[i] = holdFrames[i] > hold ? holdFrames[i] : hold;
+                    strikes[i]++;
+                }
+                if (current < LEVEL_COUNT - 1) {
+                    current++;
+                }
+            } else if (loadPermille > GROW_PERMILLE) {
+                if (++busyBlocks >= GROW_AFTER_BLOCKS && current < LEVEL_COUNT - 1) {
+                    current++;
+                }
+            } else {
+                busyBlocks = 0;
+            }
+
+            // Would this block still have been in time one level down?
+            uint32_t renderFrames = loadPermille * frames / 1000;
+            bool fitsBelow = false;
+            if (current > 0) {
+                const Level& below = level(current - 1);
+                fitsBelow = renderFrames * 1000 < DEADLINE_PERMILLE * (uint32_t)(below.queueFrames + below.blockFrames);
+            }
+            if (fitsBelow && !underrun) {
+                calmFrames += frames;
+                calmRenderFrames += renderFrames;
+            } else {
+                calmFrames = 0;
+                calmRenderFrames = 0;
+            }
+            if (calmFrames >= SHRINK_AFTER_FRAMES && current == previous) {
+                if (holdFrames[current - 1] == 0 && calmRenderFrames * 1000 < SHRINK_PERMILLE * calmFrames) {
+                    current--;
+                }
+                calmFrames = 0;
+                calmRenderFrames = 0;
+            }
+
+            // Long enough without an underrun and every level starts over
+            if (underrun) {
+                cleanFrames = 0;
+            } else if ((cleanFrames += frames) >= FORGIVE_FRAMES) {
+                for (int i = 0; i < LEVEL_COUNT; i++) {
+                    strikes[i] = 0;
+                }
+                cleanFrames = 0;
+            }
+        }
+
+        if (current != previous) {
+            changes++;
+            calmFrames = 0;
+            calmRenderFrames = 0;
+            busyBlocks = 0;
+            return true;
+        }
+        return false;
+    }
+
+    int getLevel() const { return current; }
+    uint32_t getBlockFrames() const { return level(current).blockFrames; }
+    uint32_t getQueueFrames() const { return level(current).queueFrames; }
+    uint32_t getUnderruns() const { return underruns; }
+    uint32_t getChanges() const { return changes; }
+};
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef RENDERPOLICY_H
+#define RENDERPOLICY_H
+
+#include <stdint.h>
+#include <atomic>
+#include "../../../include/Consts.h"
+
+/**
+ * Decides, block by block, whether voices render on one core or two
+ *
+ * The voice pool is split statically into two interleaved groups
+ * (groupOf): even voices on Core 0, odd voices on the Core 1 worker, so
+ * voices started in order spread evenly. In AUTO mode the split is used
+ * only when:
+ * - enough voices are active to be worth a barrier, and
+ * - the UI (loop() on Core 1) is not busy; its load has hysteresis so the
+ *   mode doesn't flap, and
+ * - the worker has been keeping up; after a run of late blocks it backs
+ *   off to single-core for a while.
+ *
+ * BACKOFF_FRAMES is audio time, so the fallback lasts 2 s at any buffer
+ * level. The mode is requested from any task and taken up by the next
+ * decide(). tools/render_split.cpp drives it from two threads.
+ */
+class RenderPolicy {
+public:
+    enum Mode {
+        SINGLE_CORE,
+        DUAL_CORE,
+        AUTO
+    };
+
+    static const int GROUPS = 2;
+    static const int MIN_VOICES = 3;                // Fewer: the barrier costs more than it saves
+    static const uint32_t UI_BUSY_PERMILLE = 300;   // Fall back above this UI load...
+    static const uint32_t UI_IDLE_PERMILLE = 150;   // ...and only return below this
+    static const int MAX_LATE_BLOCKS = 4;           // Consecutive late blocks before backing off
+    static const uint32_t BACKOFF_FRAMES = SAMPLE_RATE * 2;   // Then single-core for 2 s
+
+private:
+    Mode mode;                      // As latched by decide()
+    bool uiBusy;
+    int lateBlocks;
+    uint32_t backoffFrames;         // Single-core while > 0
+    std::atomic<int> requested;     // From the UI or console
+
+public:
+    RenderPolicy() : mode(SINGLE_CORE), uiBusy(false), lateBlocks(0), backoffFrames(0), requested(SINGLE_CORE) {}
+
+    static int groupOf(int voice) { return voice & 1; }
+
+    // Any task: applies from the next block
+    void request(Mode newMode) { requested.store(newMode, std::memory_order_relaxed); }
+    Mode getMode() const { return (Mode)requested.load(std::memory_order_relaxed); }
+    bool isBackingOff() const { return backoffFrames > 0; }     // Audio task
+
+    /**
+     * Once per block, before rendering
+     *
+     * @param activeVoices: Voices that will render this block
+     * @param uiLoadPermille: Recent busy fraction of the UI loop
+     * @param frames: Size of the block
+     * @return true to render group 1 on the worker
+     */
+    bool decide(int activeVoices, uint32_t uiLoadPermille, uint32_t frames) {
+        Mode latest = getMode();
+        if (latest != mode) {
+            mode = latest;
+            lateBlocks = 0;
+            backoffFrames = 0;
+        }
+        if (mode != AUTO) {
+            return mode == DUAL_CORE;
+        }
+
+        if (uiBusy && uiLoadPermille < UI_IDLE_PERMILLE) {
+            uiBusy = false;
+        } else if (!uiBusy && uiLoadPermille > UI_BUSY_PERMILLE) {
+            uiBusy = true;
+        }
+
+        if (backoffFrames > 0) {
+            backoffFrames = backoffFrames > frames ? backoffFrames - frames : 0;
+            return false;
+        }
+        return !uiBusy && activeVoices >= MIN_VOICES;
+    }
+
+    // After a dual-core block: was Core 0 left waiting too long for the worker?
+    void reportWorker(bool late) {
+        if (!late) {
+            lateBlocks = 0;
+        } else if (++lateBlocks >= MAX_LATE_BLOCKS && mode == AUTO) {
+            backoffFrames = BACKOFF_FRAMES;
+            lateBlocks = 0;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef SPINBARRIER_H
+#define SPINBARRIER_H
+
+#include <atomic>
+#if !defined(ARDUINO) || defined(EDULAB_SIM)
+#include <thread>
+#endif
+
+/**
+ * Reusable busy-wait barrier for a fixed number of threads
+ *
+ * For the per-block join of the render workers: the wait is expected to be
+ * microseconds, far shorter than a FreeRTOS tick, so spinning beats
+ * blocking on a semaphore. Each party must be pinned to its own core -
+ * spinning against a task on the same core would deadlock it.
+ *
+ * Sense-reversing: the last party to arrive bumps `generation`, which
+ * releases the others, so the barrier can be reused straight away.
+ * arriveAndWait() is a full acquire/release point: everything written
+ * before it on one side is visible after it on the other.
+ *
+ * Off the board (the simulator, tools/render_split.cpp) the spin yields,
+ * since host threads may share a CPU.
+ */
+class SpinBarrier {
+private:
+    const int parties;
+    std::atomic<int> arrived;
+    std::atomic<unsigned> generation;
+
+public:
+    explicit SpinBarrier(int count) : parties(count), arrived(0), generation(0) {}
+
+    // Returns the number of spin iterations spent waiting (0 for the last arrival)
+    unsigned arriveAndWait() {
+        unsigned gen = generation.load(std::memory_order_acquire);
+
+        if (arrived.fetch_add(1, std::memory_order_acq_rel) == parties - 1) {
+            arrived.store(0, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+            return 0;
+        }
+
+        unsigned spins = 0;
+        while (generation.load(std::memory_order_acquire) == gen) {
+            spins++;
+#if !defined(ARDUINO) || defined(EDULAB_SIM)
+            std::this_thread::yield();
+#endif
+        }
+        return spins;
+    }
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include "PluckString.h"
+#include <math.h>
+#include <string.h>
+#ifdef ARDUINO
+#include "esp_heap_caps.h"
+#else
+#include <stdlib.h>
+#endif
+
+PluckString::PluckString()
+    : ring(nullptr), writeIndex(0), delay(MIN_DELAY), allpassCoefficient(0), allpassIn(0), allpassOut(0),
+      previous(0), blend(16384), loss(32604), frequency(0.0f), decay(0.5f), pluckPending(false), noise(0x2545F491) {
+}
+
+PluckString::~PluckString() {
+#ifdef ARDUINO
+    heap_caps_free(ring);
+#else
+    free(ring);
+#endif
+}
+
+bool PluckString::begin() {
+    if (ring) {
+        return true;
+    }
+    // Internal SRAM: the loop reads and writes one sample each per output sample
+#ifdef ARDUINO
+    ring = (int16_t*)heap_caps_malloc(RING_SIZE * sizeof(int16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+#else
+    ring = (int16_t*)malloc(RING_SIZE * sizeof(int16_t));
+#endif
+    if (!ring) {
+        return false;
+    }
+    memset(ring, 0, RING_SIZE * sizeof(int16_t));
+    return true;
+}
+
+void PluckString::setDecay(float amount) {
+    decay = amount < 0.0f ? 0.0f : (amount > 1.0f ? 1.0f : amount);
+    frequency = 0.0f;       // Loss depends on pitch; recompute on the next prepare()
+}
+
+void PluckString::tune(float hz) {
+    const float maxFrequency = (float)SAMPLE_RATE / (MIN_DELAY + 1);
+    hz = hz < MIN_FREQUENCY ? MIN_FREQUENCY : (hz > maxFrequency ? maxFrequency : hz);
+    frequency = hz;
+    const float w = 2.0f * (float)M_PI * hz / SAMPLE_RATE;
+
+    // Ring-out time to -60 dB, 0.5 s - 10 s, the same at every pitch
+    float seconds = 0.5f * powf(20.0f, decay);
+    float perPeriod = powf(10.0f, -3.0f / (seconds * hz));
+    if (perPeriod > 0.9995f) {
+        perPeriod = 0.9995f;
+    }
+
+    // Damping filter y = (1 - s) x + s x[-1]. The classic s = 0.5 loses
+    // more per period than the whole decay allows on high notes, so s
+    // shrinks there: |H(w)|^2 = 1 - 2 s (1 - s)(1 - cos w) >= perPeriod^2.
+    float limit = (1.0f - perPeriod * perPeriod) / (2.0f * (1.0f - cosf(w)));
+    float s = (limit >= 0.25f) ? 0.5f : 0.5f * (1.0f - sqrtf(1.0f - 4.0f * limit));
+    float response = sqrtf(1.0f - 2.0f * s * (1.0f - s) * (1.0f - cosf(w)));
+    blend = (int32_t)lrintf(32767.0f * s);
+    loss = (int32_t)lrintf(32767.0f * fminf(perPeriod / response, 1.0f));
+
+    // Loop delay = line + damping filter + allpass. Keep the allpass part
+    // in [0.1, 1.1): near 0 its coefficient approaches 1 and it rings.
+    float filterDelay = atan2f(s * sinf(w), 1.0f - s + s * cosf(w)) / w;
+    float period = (float)SAMPLE_RATE / hz - filterDelay;
+    int whole = (int)(period - 0.1f);
+    if (whole < MIN_DELAY) {
+        whole = MIN_DELAY;
+    }
+    float fraction = period - whole;
+    if (fraction < 0.1f) {
+        fraction = 0.1f;
+    }
+    delay = whole;
+    // Allpass phase delay at w, solved for the coefficient (low-frequency
+    // approximation (1 - d) / (1 + d) is off by cents at the top of the range)
+    float t = tanf(w * fraction / 2.0f) / tanf(w / 2.0f);
+    allpassCoefficient = (int16_t)lrintf(32767.0f * (1.0f - t) / (1.0f + t));
+}
+
+void PluckString::excite() {
+    // One period of white noise, averaged once to take the edge off
+    int16_t last = 0;
+    for (int i = 0; i < delay; i++) {
+        noise = noise * 1664525u + 1013904223u;
+        int16_t white = (int16_t)(noise >> 16);
+        int16_t sample = (int16_t)(((int32_t)white + last) >> 2);
+        last = white;
+        ring[(writeIndex - delay + i) & RING_MASK] = sample;
+    }
+    previous = 0;
+    allpassIn = 0;
+    allpassOut = 0;
+}
+
+void PluckString::prepare(float hz) {
+    if (!ring) {
+        return;
+    }
+    if (hz != frequency) {
+        tune(hz);
+    }
+    if (pluckPending) {
+        pluckPending = false;
+        excite();
+    }
+}
+
+void PluckString::render(float* output, int frames, float gain) {
+    if (!ring) {
+        memset(output, 0, frames * sizeof(float));
+        return;
+    }
+
+    const float scale = gain / 32768.0f;
+    uint32_t w = writeIndex;
+    int32_t prev = previous;
+    int32_t apIn = allpassIn;
+    int32_t apOut = allpassOut;
+    const int32_t c = allpassCoefficient;
+    const int32_t g = loss;
+    const int32_t b = blend;
+    const uint32_t d = delay;
+    const int32_t ROUND = 1 << 14;
+
+    for (int i = 0; i < frames; i++) {
+        int32_t x = ring[(w - d) & RING_MASK];
+
+        // Damping: blend with the previous sample, then the per-period loss.
+        // Products are rounded, not floored: with loss near 1 the loop barely
+        // decays at DC, and a -0.5 LSB bias per pass would build into an offset.
+        int32_t damped = ((x + (((prev - x) * b + ROUND) >> 15)) * g + ROUND) >> 15;
+        prev = x;
+
+        // Fractional delay: y = c * (in - y[-1]) + in[-1]
+        int32_t y = ((c * (damped - apOut) + ROUND) >> 15) + apIn;
+        apIn = damped;
+        apOut = y;
+
+        ring[w & RING_MASK] = (int16_t)y;
+        w++;
+        output[i] = x * scale;
+    }
+
+    writeIndex = w;
+    previous = (int16_t)prev;
+    allpassIn = (int16_t)apIn;
+    allpassOut = (int16_t)apOut;
+}
@@ -0,0 +1,69 @@
+#ifndef PLUCKSTRING_H
+#define PLUCKSTRING_H
+
+#include <stdint.h>
+#include "../../../include/Consts.h"
+
+/**
+ * Karplus-Strong plucked string
+ *
+ * A delay line one period long is filled with noise on pluck() and played
+ * back through a loop of: two-point damping lowpass -> loss gain ->
+ * first-order allpass (fractional delay, so the pitch isn't quantised to
+ * whole samples). Filter weight, loss and allpass are set per pitch so
+ * every note rings for the same time and stays in tune up to the top of
+ * the range. The sample loop is Q15 integer.
+ *
+ * The line is a power-of-two ring in internal SRAM, so every index is a
+ * mask. RING_SIZE covers MIN_FREQUENCY at the build's sample rate (4096
+ * samples = 8 KB at 44.1/48 kHz); higher notes use the same ring with a
+ * shorter delay, so memory per voice is fixed.
+ *
+ * pluck() only sets a flag: the noise burst is written by prepare() on the
+ * audio task, so the UI never touches the ring.
+ */
+class PluckString {
+public:
+    static constexpr float MIN_FREQUENCY = 20.0f;
+    static const int MIN_DELAY = 4;                 // Loop filters need a few samples
+
+    static const int RING_SIZE = SAMPLE_RATE <= 48000 ? 4096 : 8192;
+    static const int RING_MASK = RING_SIZE - 1;
+    static_assert(RING_SIZE >= SAMPLE_RATE / 20 + MIN_DELAY + 2, "Ring too short for MIN_FREQUENCY");
+
+private:
+    int16_t* ring;              // RING_SIZE samples, internal RAM
+    uint32_t writeIndex;
+    int delay;                  // Whole samples in the loop
+    int16_t allpassCoefficient; // Q15, tunes the fractional part
+    int16_t allpassIn;          // Allpass state: previous input / output
+    int16_t allpassOut;
+    int16_t previous;           // Averaging filter state
+    int32_t blend;              // Q15 weight of the previous sample in the damping filter
+    int32_t loss;               // Q15 per-period gain: decay time
+    float frequency;
+    float decay;                // 0 - 1, longer ring-out towards 1
+    volatile bool pluckPending;
+    uint32_t noise;
+
+public:
+    PluckString();
+    ~PluckString();
+
+    bool begin();               // Allocate the ring (internal RAM); false if out of memory
+    bool isReady() const { return ring != nullptr; }
+
+    void pluck() { pluckPending = true; }
+    void setDecay(float amount);
+
+    // Control rate, audio task: tuning and a pending pluck
+    void prepare(float hz);
+
+    void render(float* output, int frames, float gain);
+
+private:
+    void tune(float hz);
+    void excite();
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef SAMPLEBANK_H
+#define SAMPLEBANK_H
+
+#include <stdint.h>
+
+/**
+ * On-flash sample bank format (shared by the firmware and tools/pack_samples)
+ *
+ * [SampleBankHeader][SampleInfo x count][PCM data ...]
+ *
+ * All fields little-endian. Data is mono, either 16-bit signed PCM or
+ * IMA-ADPCM blocks (see Codec/ImaAdpcm.h). Each entry's offset is relative
+ * to the start of the bank and 4-byte aligned. The bank is read in place
+ * from a memory-mapped flash partition.
+ *
+ * Entries are either plain samples or wavetables. A wavetable entry holds
+ * frameCount frames x Wavetable::MIP_LEVELS tables x Wavetable::TABLE_SIZE
+ * samples, already band-limited per octave by the pack tool; for ADPCM each
+ * table is encoded on its own so it can be decoded independently.
+ */
+
+static const uint32_t SAMPLE_BANK_MAGIC = 0x42534445;   // "EDSB"
+static const uint16_t SAMPLE_BANK_VERSION = 1;
+static const int SAMPLE_NAME_LENGTH = 16;
+
+enum SampleFormat : uint32_t {
+    SAMPLE_FORMAT_PCM16 = 0,
+    SAMPLE_FORMAT_IMA_ADPCM = 1
+};
+
+enum SampleKind : uint16_t {
+    SAMPLE_KIND_SAMPLE = 0,
+    SAMPLE_KIND_WAVETABLE = 1
+};
+
+struct SampleBankHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;         // Number of SampleInfo entries
+};
+
+struct SampleInfo {
+    char name[SAMPLE_NAME_LENGTH];
+    uint32_t offset;        // Bytes from the start of the bank
+    uint32_t length;        // Frames (all tables, for wavetables)
+    uint32_t sampleRate;    // Recorded rate (Hz)
+    uint32_t loopStart;     // Frames; loopEnd == 0 means one-shot
+    uint32_t loopEnd;
+    float rootFrequency;    // Pitch of the recording (Hz)
+    uint32_t format;        // SampleFormat
+    uint16_t kind;          // SampleKind
+    uint16_t frameCount;    // Wavetable frames (0 for samples)
+};
+
+static_assert(sizeof(SampleBankHeader) == 8, "SampleBankHeader layout");
+static_assert(sizeof(SampleInfo) == 48, "SampleInfo layout");
+
+#endif
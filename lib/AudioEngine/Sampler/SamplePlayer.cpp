@@ -0,0 +1,100 @@
+#include "SamplePlayer.h"
+#include "../../../include/Consts.h"
+
+SamplePlayer::SamplePlayer()
+    : data(nullptr), encoded(nullptr), length(0), loopStart(0), loopEnd(0), rootFrequency(440.0f),
+      rateRatio(1.0f), position(0), increment(0), playing(false), blockDecodes(0) {
+    for (int i = 0; i < SLOTS; i++) {
+        slotBlock[i] = -1;
+    }
+}
+
+void SamplePlayer::setSample(const SampleInfo* info, const uint8_t* sampleData) {
+    playing = false;
+    data = nullptr;
+    encoded = nullptr;
+    for (int i = 0; i < SLOTS; i++) {
+        slotBlock[i] = -1;
+    }
+
+    if (!info || !sampleData) {
+        return;
+    }
+
+    if (info->format == SAMPLE_FORMAT_IMA_ADPCM) {
+        encoded = sampleData;
+    } else {
+        data = (const int16_t*)sampleData;
+    }
+    length = info->length;
+    loopStart = info->loopStart;
+    loopEnd = (info->loopEnd > info->loopStart) ? info->loopEnd : 0;
+    rootFrequency = (info->rootFrequency > 0.0f) ? info->rootFrequency : 440.0f;
+    rateRatio = (float)info->sampleRate / SAMPLE_RATE;
+}
+
+void SamplePlayer::setFrequency(float frequency) {
+    double ratio = (double)frequency / rootFrequency * rateRatio;
+    increment = (uint64_t)(ratio * 4294967296.0);
+}
+
+void SamplePlayer::trigger() {
+    position = 0;
+    playing = ((data != nullptr || encoded != nullptr) && length >= 2);
+}
+
+void SamplePlayer::prepare(int frames) {
+    if (!encoded || !playing) {
+        return;
+    }
+
+    // Source frames this block will read, +1 for the interpolation partner
+    uint32_t first = (uint32_t)(position >> 32);
+    uint64_t span = ((uint64_t)frames * increment) >> 32;
+    uint32_t last = first + (uint32_t)span + 1;
+
+    bool wraps = false;
+    if (loopEnd && last >= loopEnd) {
+        last = loopEnd - 1;
+        wraps = true;
+    } else if (last >= length) {
+        last = length - 1;
+    }
+
+    // More blocks than slots (very high pitch): decode what fits, the rest
+    // falls back to inline decoding in fetch()
+    int32_t firstBlock = (int32_t)(first / ImaAdpcm::BLOCK_SAMPLES);
+    int32_t lastBlock = (int32_t)(last / ImaAdpcm::BLOCK_SAMPLES);
+    if (lastBlock - firstBlock >= SLOTS) {
+        lastBlock = firstBlock + SLOTS - 1;
+        wraps = false;
+    }
+
+    for (int32_t block = firstBlock; block <= lastBlock; block++) {
+        if (slotBlock[block & (SLOTS - 1)] != block) {
+            decodeBlock(block);
+        }
+    }
+
+    if (wraps) {
+        int32_t loopBlock = (int32_t)(loopStart / ImaAdpcm::BLOCK_SAMPLES);
+        int slot = loopBlock & (SLOTS - 1);
+        // Don't evict a block this render still needs
+        bool inUse = (lastBlock - firstBlock + 1 >= SLOTS) ||
+                     ((slot - firstBlock) & (SLOTS - 1)) <= lastBlock - firstBlock;
+        if (slotBlock[slot] != loopBlock && !inUse) {
+            decodeBlock(loopBlock);
+        }
+    }
+}
+
+void SamplePlayer::decodeBlock(int32_t block) {
+    int slot = block & (SLOTS - 1);
+    uint32_t start = (uint32_t)block * ImaAdpcm::BLOCK_SAMPLES;
+    uint32_t remaining = length - start;
+    int count = remaining < (uint32_t)ImaAdpcm::BLOCK_SAMPLES ? (int)remaining : ImaAdpcm::BLOCK_SAMPLES;
+
+    ImaAdpcm::decodeBlock(encoded + (size_t)block * ImaAdpcm::BLOCK_BYTES, decoded[slot], count);
+    slotBlock[slot] = block;
+    blockDecodes++;
+}
@@ -0,0 +1,115 @@
+#ifndef SAMPLEPLAYER_H
+#define SAMPLEPLAYER_H
+
+#include <stdint.h>
+#include "SampleBank.h"
+#include "../Codec/ImaAdpcm.h"
+
+/**
+ * Per-voice sample playback, streaming straight from mapped flash
+ *
+ * Position is 32.32 fixed point in source frames; the increment encodes
+ * both the pitch ratio (frequency / root) and the sample-rate ratio.
+ * Output is linearly interpolated. With loop points set, playback wraps
+ * from loopEnd back to loopStart indefinitely; otherwise it stops at the
+ * end of the sample.
+ *
+ * PCM16 samples are read in place. IMA-ADPCM samples are decoded one
+ * block at a time into a small direct-mapped block cache (SLOTS blocks,
+ * slot = block % SLOTS): prepare() decodes the blocks the next render
+ * will touch, so the per-sample path is normally just a cache lookup.
+ * A miss (extreme pitch, loop wrap onto a clashing slot) decodes inline.
+ */
+class SamplePlayer {
+public:
+    static const int SLOTS = 4;
+
+private:
+    const int16_t* data;        // PCM16: mapped flash, never copied
+    const uint8_t* encoded;     // IMA-ADPCM: mapped flash, decoded per block
+    uint32_t length;
+    uint32_t loopStart;
+    uint32_t loopEnd;           // 0 = one-shot
+    float rootFrequency;
+    float rateRatio;            // sample rate / output rate
+
+    uint64_t position;          // 32.32 frames
+    uint64_t increment;
+    bool playing;
+
+    // Decoded ADPCM blocks (internal SRAM)
+    int16_t decoded[SLOTS][ImaAdpcm::BLOCK_SAMPLES];
+    int32_t slotBlock[SLOTS];   // Block held by each slot, -1 = empty
+    uint32_t blockDecodes;      // For the benchmark / stats
+
+public:
+    SamplePlayer();
+
+    void setSample(const SampleInfo* info, const uint8_t* sampleData);
+    void setFrequency(float frequency);     // Control rate
+    void trigger();                         // Restart from the beginning
+    bool isPlaying() const { return playing; }
+    bool isCompressed() const { return encoded != nullptr; }
+    uint32_t getBlockDecodes() const { return blockDecodes; }
+
+    /**
+     * Control-rate update, call before rendering each block
+     *
+     * Decodes the ADPCM blocks covering the next `frames` output samples
+     * (and the loop start, if the loop wraps) ahead of the play position.
+     * Does nothing for PCM16 samples.
+     *
+     * @param frames: Output samples the next render will pull
+     */
+    void prepare(int frames);
+
+    inline float getSample() {
+        if (!playing) {
+            return 0.0f;
+        }
+
+        uint32_t index = (uint32_t)(position >> 32);
+        int32_t frac = (int32_t)((position >> 16) & 0xFFFF);
+
+        uint32_t next = index + 1;
+        if (loopEnd && next >= loopEnd) {
+            next = loopStart;
+        }
+
+        int32_t a = fetch(index);
+        int32_t b = fetch(next);
+        // b - a spans +-65535: the product needs 33 bits
+        int32_t value = a + (int32_t)(((int64_t)(b - a) * frac) >> 16);
+
+        position += increment;
+        uint32_t newIndex = (uint32_t)(position >> 32);
+        if (loopEnd) {
+            while (newIndex >= loopEnd) {
+                position -= (uint64_t)(loopEnd - loopStart) << 32;
+                newIndex = (uint32_t)(position >> 32);
+            }
+        } else if (newIndex + 1 >= length) {
+            playing = false;
+        }
+
+        return value * (1.0f / 32768.0f);
+    }
+
+private:
+    inline int32_t fetch(uint32_t index) {
+        if (!encoded) {
+            return data[index];
+        }
+
+        int32_t block = (int32_t)(index / ImaAdpcm::BLOCK_SAMPLES);
+        int slot = block & (SLOTS - 1);
+        if (slotBlock[slot] != block) {
+            decodeBlock(block);
+        }
+        return decoded[slot][index & (ImaAdpcm::BLOCK_SAMPLES - 1)];
+    }
+
+    void decodeBlock(int32_t block);
+};
+
+#endif
@@ -0,0 +1,168 @@
+#include "SampleStore.h"
+#include <string.h>
+#include "../Codec/ImaAdpcm.h"
+
+#ifdef ARDUINO
+#include "esp_partition.h"
+#include "Log.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+SampleStore::SampleStore()
+    : base(nullptr), size(0), infos(nullptr), count(0), mapHandle(0) {
+}
+
+SampleStore::~SampleStore() {
+    end();
+}
+
+#ifdef ARDUINO
+
+bool SampleStore::begin(const char* partitionLabel) {
+    const esp_partition_t* partition = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)PARTITION_SUBTYPE, partitionLabel);
+    if (!partition) {
+        LOG("[SMP] No '%s' partition", partitionLabel);
+        return false;
+    }
+
+    const void* mapped = nullptr;
+    spi_flash_mmap_handle_t handle;
+    if (esp_partition_mmap(partition, 0, partition->size, SPI_FLASH_MMAP_DATA, &mapped, &handle) != ESP_OK) {
+        LOG("[SMP] mmap of %u bytes failed", (unsigned)partition->size);
+        return false;
+    }
+    mapHandle = handle;
+
+    if (!parse((const uint8_t*)mapped, partition->size)) {
+        LOG("[SMP] Partition holds no valid sample bank");
+        end();
+        return false;
+    }
+
+    LOG("[SMP] %d samples mapped from flash (%u KB partition)", count, (unsigned)(partition->size / 1024));
+    return true;
+}
+
+void SampleStore::end() {
+    if (base) {
+        spi_flash_munmap((spi_flash_mmap_handle_t)mapHandle);
+    }
+    base = nullptr;
+    size = 0;
+    infos = nullptr;
+    count = 0;
+}
+
+#else
+
+bool SampleStore::openFile(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+
+    if (!parse((const uint8_t*)mapped, info.st_size)) {
+        munmap(mapped, info.st_size);
+        return false;
+    }
+    return true;
+}
+
+void SampleStore::end() {
+    if (base) {
+        munmap((void*)base, size);
+    }
+    base = nullptr;
+    size = 0;
+    infos = nullptr;
+    count = 0;
+}
+
+#endif
+
+bool SampleStore::parse(const uint8_t* mapped, size_t length) {
+    // Keep the mapping even on failure so end() can release it
+    base = mapped;
+    size = length;
+
+    if (length < sizeof(SampleBankHeader)) {
+        return false;
+    }
+
+    const SampleBankHeader* header = (const SampleBankHeader*)mapped;
+    if (header->magic != SAMPLE_BANK_MAGIC || header->version != SAMPLE_BANK_VERSION) {
+        return false;
+    }
+
+    size_t tableEnd = sizeof(SampleBankHeader) + (size_t)header->count * sizeof(SampleInfo);
+    if (tableEnd > length) {
+        return false;
+    }
+
+    const SampleInfo* table = (const SampleInfo*)(mapped + sizeof(SampleBankHeader));
+    for (int i = 0; i < header->count; i++) {
+        const SampleInfo& sample = table[i];
+        size_t bytes;
+        if (sample.format == SAMPLE_FORMAT_PCM16) {
+            bytes = (size_t)sample.length * sizeof(int16_t);
+        } else if (sample.format == SAMPLE_FORMAT_IMA_ADPCM) {
+            bytes = ImaAdpcm::encodedBytes(sample.length);
+        } else {
+            return false;
+        }
+
+        if ((sample.offset & 3) != 0 ||
+            sample.offset > length || bytes > length - sample.offset || sample.length < 2 ||
+            sample.loopEnd > sample.length || sample.loopStart > sample.loopEnd) {
+            return false;
+        }
+    }
+
+    infos = table;
+    count = header->count;
+    return true;
+}
+
+const SampleInfo* SampleStore::getInfo(int index) const {
+    return (index >= 0 && index < count) ? &infos[index] : nullptr;
+}
+
+const uint8_t* SampleStore::getData(int index) const {
+    const SampleInfo* info = getInfo(index);
+    return info ? base + info->offset : nullptr;
+}
+
+int SampleStore::findByKind(SampleKind kind, int start) const {
+    for (int i = start; i < count; i++) {
+        if (infos[i].kind == kind) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int SampleStore::findByName(const char* name) const {
+    for (int i = 0; i < count; i++) {
+        if (strncmp(infos[i].name, name, SAMPLE_NAME_LENGTH) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
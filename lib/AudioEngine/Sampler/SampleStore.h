@@ -0,0 +1,48 @@
+#ifndef SAMPLESTORE_H
+#define SAMPLESTORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "SampleBank.h"
+
+/**
+ * Read-only view of a sample bank, mapped straight from flash
+ *
+ * On the device the "samples" data partition is mapped into the address
+ * space with esp_partition_mmap, so playback reads PCM through the flash
+ * cache with no copies and no RAM buffers. On the host the same bank file
+ * is mapped with mmap() instead.
+ */
+class SampleStore {
+public:
+    static const uint8_t PARTITION_SUBTYPE = 0x40;   // See partitions_16MB_samples.csv
+
+private:
+    const uint8_t* base;            // Start of the mapped bank
+    size_t size;
+    const SampleInfo* infos;
+    int count;
+    uint32_t mapHandle;             // spi_flash_mmap_handle_t on the device
+
+public:
+    SampleStore();
+    ~SampleStore();
+
+#ifdef ARDUINO
+    bool begin(const char* partitionLabel = "samples");
+#else
+    bool openFile(const char* path);
+#endif
+    void end();
+
+    int getCount() const { return count; }
+    const SampleInfo* getInfo(int index) const;
+    const uint8_t* getData(int index) const;      // Mapped data (flash), PCM or ADPCM
+    int findByName(const char* name) const;
+    int findByKind(SampleKind kind, int start = 0) const;
+
+private:
+    bool parse(const uint8_t* mapped, size_t length);
+};
+
+#endif
@@ -0,0 +1,72 @@
+#include "FixedFft.h"
+#include <math.h>
+
+FixedFft::FixedFft() {
+    const double pi = 3.14159265358979323846;
+    for (int k = 0; k < SIZE; k++) {
+        cosTable[k] = (int16_t)lrint(32767.0 * cos(2.0 * pi * k / SIZE));
+        sinTable[k] = (int16_t)lrint(32767.0 * sin(2.0 * pi * k / SIZE));
+        window[k] = (int16_t)lrint(32767.0 * 0.5 * (1.0 - cos(2.0 * pi * k / SIZE)));
+
+        // Reverse the base-4 digits of k
+        int r = 0;
+        int v = k;
+        for (int s = 0; s < STAGES; s++) {
+            r = (r << 2) | (v & 3);
+            v >>= 2;
+        }
+        reversed[k] = (uint8_t)r;
+    }
+}
+
+void FixedFft::applyWindow(int16_t* samples) const {
+    for (int i = 0; i < SIZE; i++) {
+        samples[i] = (int16_t)(((int32_t)samples[i] * window[i]) >> 15);
+    }
+}
+
+void FixedFft::transform(int16_t* re, int16_t* im) const {
+    for (int i = 0; i < SIZE; i++) {
+        int j = reversed[i];
+        if (j > i) {
+            int16_t t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    for (int quarter = 1, stride = SIZE / 4; quarter < SIZE; quarter *= 4, stride /= 4) {
+        int span = quarter * 4;
+
+        for (int j = 0; j < quarter; j++) {
+            // W^m = cos(2 pi m / N) - j sin(2 pi m / N), m = j, 2j, 3j (in units of stride)
+            int m1 = j * stride, m2 = 2 * m1, m3 = 3 * m1;
+            int32_t c1 = cosTable[m1], s1 = sinTable[m1];
+            int32_t c2 = cosTable[m2], s2 = sinTable[m2];
+            int32_t c3 = cosTable[m3 & (SIZE - 1)], s3 = sinTable[m3 & (SIZE - 1)];
+
+            for (int k = j; k < SIZE; k += span) {
+                int a = k, b = k + quarter, c = b + quarter, d = c + quarter;
+
+                int32_t x0r = re[a], x0i = im[a];
+                int32_t x1r = (re[b] * c1 + im[b] * s1) >> 15;
+                int32_t x1i = (im[b] * c1 - re[b] * s1) >> 15;
+                int32_t x2r = (re[c] * c2 + im[c] * s2) >> 15;
+                int32_t x2i = (im[c] * c2 - re[c] * s2) >> 15;
+                int32_t x3r = (re[d] * c3 + im[d] * s3) >> 15;
+                int32_t x3i = (im[d] * c3 - re[d] * s3) >> 15;
+
+                int32_t t0r = x0r + x2r, t0i = x0i + x2i;
+                int32_t t1r = x0r - x2r, t1i = x0i - x2i;
+                int32_t t2r = x1r + x3r, t2i = x1i + x3i;
+                int32_t t3r = x1r - x3r, t3i = x1i - x3i;
+
+                // Scale by 1/4 per stage
+                re[a] = (int16_t)((t0r + t2r) >> 2);  im[a] = (int16_t)((t0i + t2i) >> 2);
+                re[c] = (int16_t)((t0r - t2r) >> 2);  im[c] = (int16_t)((t0i - t2i) >> 2);
+                // y1 = t1 - j t3, y3 = t1 + j t3
+                re[b] = (int16_t)((t1r + t3i) >> 2);  im[b] = (int16_t)((t1i - t3r) >> 2);
+                re[d] = (int16_t)((t1r - t3i) >> 2);  im[d] = (int16_t)((t1i + t3r) >> 2);
+            }
+        }
+    }
+}
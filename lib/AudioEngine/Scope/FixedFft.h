@@ -0,0 +1,52 @@
+#ifndef FIXEDFFT_H
+#define FIXEDFFT_H
+
+#include <stdint.h>
+
+/**
+ * 256-point fixed-point radix-4 FFT (Q15)
+ *
+ * In-place decimation-in-time: base-4 digit reversal, then 4 radix-4
+ * stages. Each stage divides by 4 so nothing can overflow; the result is
+ * the DFT scaled by 1/SIZE. Twiddles, the digit-reversal table and a Hann
+ * window are built once in the constructor (~2 KB).
+ *
+ * No Arduino dependency: the display uses it on Core 1, and
+ * tools/bench_fft.cpp checks and times it on the host.
+ */
+class FixedFft {
+public:
+    static const int SIZE = 256;
+    static const int STAGES = 4;            // log4(SIZE)
+    static const int BINS = SIZE / 2;
+
+private:
+    int16_t cosTable[SIZE];                 // cos(2 pi k / SIZE), Q15
+    int16_t sinTable[SIZE];
+    int16_t window[SIZE];                   // Hann, Q15
+    uint8_t reversed[SIZE];                 // Base-4 digit reversal
+
+public:
+    FixedFft();
+
+    void applyWindow(int16_t* samples) const;
+
+    /**
+     * Forward transform, in place
+     *
+     * @param re: SIZE real parts (input samples, output spectrum)
+     * @param im: SIZE imaginary parts (zero for real input)
+     */
+    void transform(int16_t* re, int16_t* im) const;
+
+    // |re + j im|, alpha-max-plus-beta-min (within ~4%)
+    static inline uint16_t magnitude(int16_t re, int16_t im) {
+        uint16_t a = (uint16_t)(re < 0 ? -re : re);
+        uint16_t b = (uint16_t)(im < 0 ? -im : im);
+        uint16_t hi = a > b ? a : b;
+        uint16_t lo = a > b ? b : a;
+        return hi + ((lo * 3) >> 3);
+    }
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef SCOPETAP_H
+#define SCOPETAP_H
+
+#include <stdint.h>
+#include "TripleBuffer.h"
+
+/**
+ * Decimated copy of the audio output for the scope/spectrum display
+ *
+ * The audio task calls write() once per block with the I2S buffer in the
+ * build's output format: it keeps every DECIMATION-th frame (pair-averaged,
+ * first channel, reduced to 16 bits) - a bounded copy of
+ * BLOCK_FRAMES / DECIMATION samples - and publishes a frame whenever
+ * SAMPLES have been collected. The UI reads the latest frame without ever
+ * blocking the audio task (TripleBuffer).
+ */
+class ScopeTap {
+public:
+    static const int SAMPLES = 256;         // One FFT worth
+    static const int DECIMATION = 2;        // ~11.6 ms per frame at 44.1 kHz
+
+    struct Frame {
+        int16_t samples[SAMPLES];
+        uint32_t sequence;
+    };
+
+private:
+    TripleBuffer<Frame> frames;
+    int fill;
+    uint32_t sequence;
+
+public:
+    ScopeTap() : fill(0), sequence(0) {}
+
+    // Audio task. interleaved: `count` frames of Format (see OutputFormat.h)
+    template<typename Format>
+    void write(const typename Format::Sample* interleaved, int count) {
+        Frame* frame = &frames.getWriteBuffer();
+        for (int i = 0; i + DECIMATION <= count; i += DECIMATION) {
+            int32_t sum = 0;
+            for (int d = 0; d < DECIMATION; d++) {
+                sum += Format::toInt16(interleaved[(i + d) * Format::CHANNELS]);
+            }
+            frame->samples[fill++] = (int16_t)(sum / DECIMATION);
+
+            if (fill == SAMPLES) {
+                frame->sequence = ++sequence;
+                frames.publish();
+                fill = 0;
+                frame = &frames.getWriteBuffer();
+            }
+        }
+    }
+
+    // UI: the newest complete frame (all zeros before the first one)
+    const Frame& latest() {
+        frames.update();
+        return frames.getReadBuffer();
+    }
+
+    bool hasNew() const { return frames.hasNew(); }
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * Lock-free triple buffer for one writer and one reader on different cores
+ *
+ * The writer fills getWriteBuffer() and publish()es it; the reader calls
+ * update() and then reads getReadBuffer(). Neither side ever waits: the
+ * writer always has a free buffer, and the reader always holds the most
+ * recent complete one. Intermediate frames are dropped if the reader is
+ * slower than the writer, which is what a display wants.
+ *
+ * The three slots rotate by swapping indices through one atomic byte
+ * (`middle`), whose DIRTY bit says the middle slot holds unread data.
+ */
+template<typename T>
+class TripleBuffer {
+private:
+    static const uint8_t INDEX_MASK = 0x03;
+    static const uint8_t DIRTY = 0x04;
+
+    T slots[3];
+    uint8_t back;                   // Writer only
+    uint8_t front;                  // Reader only
+    std::atomic<uint8_t> middle;
+
+public:
+    TripleBuffer() : slots(), back(0), front(1), middle(2) {}
+
+    // ---- Writer ----
+    T& getWriteBuffer() { return slots[back]; }
+
+    void publish() {
+        uint8_t previous = middle.exchange(back | DIRTY, std::memory_order_acq_rel);
+        back = previous & INDEX_MASK;
+    }
+
+    // ---- Reader ----
+    bool hasNew() const {
+        return (middle.load(std::memory_order_relaxed) & DIRTY) != 0;
+    }
+
+    // Take the latest published buffer; false (and no change) if none is new
+    bool update() {
+        if (!hasNew()) {
+            return false;
+        }
+        uint8_t previous = middle.exchange(front, std::memory_order_acq_rel);
+        front = previous & INDEX_MASK;
+        return true;
+    }
+
+    const T& getReadBuffer() const { return slots[front]; }
+};
+
+#endif
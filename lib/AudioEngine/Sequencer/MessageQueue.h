@@ -0,0 +1,59 @@
+#ifndef MESSAGEQUEUE_H
+#define MESSAGEQUEUE_H
+
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * Fixed-size message ring from the UI tasks to the audio task
+ *
+ * One consumer (the audio task) that never blocks or locks: it only reads
+ * `head` and advances `tail`. Producers (loop(), the console) are rare and
+ * not real-time, so they take a tiny spin lock among themselves; the
+ * audio task never contends for it.
+ *
+ * N must be a power of two. A full queue drops the message and push()
+ * returns false.
+ */
+template<typename T, uint32_t N>
+class MessageQueue {
+    static_assert((N & (N - 1)) == 0, "MessageQueue size must be a power of two");
+
+private:
+    T slots[N];
+    std::atomic<uint32_t> head;     // Written by producers (under the lock)
+    std::atomic<uint32_t> tail;     // Written by the consumer
+    std::atomic_flag producerLock;
+
+public:
+    MessageQueue() : slots(), head(0), tail(0) {
+        producerLock.clear();
+    }
+
+    // ---- Producers ----
+    bool push(const T& message) {
+        while (producerLock.test_and_set(std::memory_order_acquire)) {
+        }
+        uint32_t h = head.load(std::memory_order_relaxed);
+        bool stored = h - tail.load(std::memory_order_acquire) < N;
+        if (stored) {
+            slots[h & (N - 1)] = message;
+            head.store(h + 1, std::memory_order_release);
+        }
+        producerLock.clear(std::memory_order_release);
+        return stored;
+    }
+
+    // ---- Consumer ----
+    bool pop(T& message) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        message = slots[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,207 @@
+#include "Sequencer.h"
+
+Sequencer::Sequencer()
+    : clock(SAMPLE_RATE), mode(OFF), length(8), chordSize(4), gatePermille(500),
+      position(0), direction(1), sounding(false), releaseAt(0), running(false), stepsPlayed(0) {
+    // Default pattern: root, fifth, octave, fifth with a rest on every fourth step
+    static const int8_t pattern[MAX_STEPS] = {0, 7, 12, 7, 0, 7, 12, 7, 0, 7, 12, 7, 0, 7, 12, 7};
+    for (int i = 0; i < MAX_STEPS; i++) {
+        steps[i].semitones = pattern[i];
+        steps[i].velocity = (i % 4 == 3) ? 0 : 100;
+    }
+    static const int8_t major[] = {0, 4, 7, 12};
+    for (int i = 0; i < MAX_CHORD; i++) {
+        chord[i] = i < 4 ? major[i] : 0;
+    }
+}
+
+const char* Sequencer::modeName(Mode m) {
+    switch (m) {
+        case OFF:         return "off";
+        case STEPS:       return "steps";
+        case ARP_UP:      return "up";
+        case ARP_DOWN:    return "down";
+        case ARP_UP_DOWN: return "updown";
+        default:          return "?";
+    }
+}
+
+// ==========================================
+// UI SIDE
+// ==========================================
+
+bool Sequencer::post(Message::Type type, int index, int value, uint32_t extra) {
+    Message message;
+    message.type = type;
+    message.index = (int8_t)index;
+    message.value = (int16_t)value;
+    message.extra = extra;
+    return messages.push(message);
+}
+
+bool Sequencer::setMode(Mode newMode) {
+    return newMode < MODE_COUNT && post(Message::SET_MODE, 0, newMode);
+}
+
+bool Sequencer::setTempo(uint32_t milliBpm, uint32_t stepsPerBeat) {
+    return post(Message::SET_TEMPO, 0, (int)stepsPerBeat, milliBpm);
+}
+
+bool Sequencer::setGate(uint32_t permille) {
+    return post(Message::SET_GATE, 0, permille > 1000 ? 1000 : (int)permille);
+}
+
+bool Sequencer::setStep(int index, int semitones, int velocity) {
+    if (index < 0 || index >= MAX_STEPS || semitones < -48 || semitones > 48 || velocity < 0 || velocity > 127) {
+        return false;
+    }
+    return post(Message::SET_STEP, index, semitones, (uint32_t)velocity);
+}
+
+bool Sequencer::setLength(int stepCount) {
+    return stepCount >= 1 && stepCount <= MAX_STEPS && post(Message::SET_LENGTH, 0, stepCount);
+}
+
+bool Sequencer::setChord(const int8_t* semitones, int count) {
+    if (count < 1 || count > MAX_CHORD) {
+        return false;
+    }
+    // Notes first, size last: the audio task never sees a half-written chord
+    // as long as the queue has room for all of it
+    for (int i = 0; i < count; i++) {
+        if (!post(Message::SET_CHORD_NOTE, i, semitones[i])) {
+            return false;
+        }
+    }
+    return post(Message::SET_CHORD_SIZE, 0, count);
+}
+
+// ==========================================
+// AUDIO TASK
+// ==========================================
+
+void Sequencer::apply(const Message& message) {
+    switch (message.type) {
+        case Message::SET_MODE:
+            if ((Mode)message.value != mode) {
+                mode = (Mode)message.value;
+                // Start (or restart) on the first sample of this block
+                clock.reset();
+                position = 0;
+                direction = 1;
+                if (mode == ARP_DOWN) {
+                    position = chordSize - 1;
+                }
+            }
+            break;
+        case Message::SET_TEMPO:
+            clock.setTempo(message.extra, (uint32_t)message.value);
+            break;
+        case Message::SET_GATE:
+            gatePermille = (uint32_t)message.value;
+            break;
+        case Message::SET_STEP:
+            steps[message.index].semitones = (int8_t)message.value;
+            steps[message.index].velocity = (uint8_t)message.extra;
+            break;
+        case Message::SET_LENGTH:
+            length = message.value;
+            if (position >= length) {
+                position = 0;
+            }
+            break;
+        case Message::SET_CHORD_NOTE:
+            chord[message.index] = (int8_t)message.value;
+            break;
+        case Message::SET_CHORD_SIZE:
+            chordSize = message.value;
+            if (position >= chordSize) {
+                position = 0;
+            }
+            break;
+    }
+}
+
+bool Sequencer::nextNote(int8_t& semitones, uint8_t& velocity) {
+    if (mode == STEPS) {
+        const Step& step = steps[position];
+        position = (position + 1) % length;
+        semitones = step.semitones;
+        velocity = step.velocity;
+        return velocity > 0;
+    }
+
+    semitones = chord[position];
+    velocity = 100;
+    if (mode == ARP_UP) {
+        position = (position + 1) % chordSize;
+    } else if (mode == ARP_DOWN) {
+        position = (position + chordSize - 1) % chordSize;
+    } else if (chordSize > 1) {
+        // Bounce off both ends without playing them twice
+        if (position + direction < 0 || position + direction >= chordSize) {
+            direction = -direction;
+        }
+        position += direction;
+    }
+    return true;
+}
+
+int Sequencer::process(int frames, Event* events, int maxEvents) {
+    Message message;
+    while (messages.pop(message)) {
+        apply(message);
+    }
+
+    int count = 0;
+    if (mode == OFF) {
+        // Release whatever was playing when the sequencer was switched off
+        if (sounding && maxEvents > 0) {
+            events[count++] = { 0, false, 0, 0 };
+        }
+        sounding = false;
+        running.store(false, std::memory_order_relaxed);
+        return count;
+    }
+    running.store(true, std::memory_order_relaxed);
+
+    const int64_t gateSamples = ((int64_t)clock.getStepSamples() * gatePermille) / 1000;
+
+    // Events in time order. At equal offsets the release goes first, so
+    // a step that starts where the last one's gate ends is a fresh note.
+    // Past maxEvents the state still advances (timing stays exact); only
+    // the events are lost.
+    while (true) {
+        int64_t stepAt = clock.next();
+        int64_t releaseTime = sounding ? releaseAt : INT64_MAX;
+        if (stepAt >= frames && releaseTime >= frames) {
+            break;
+        }
+
+        if (releaseTime <= stepAt) {
+            if (count < maxEvents) {
+                events[count++] = { (uint16_t)releaseTime, false, 0, 0 };
+            }
+            sounding = false;
+            continue;
+        }
+
+        int8_t semitones;
+        uint8_t velocity;
+        if (nextNote(semitones, velocity)) {
+            if (count < maxEvents) {
+                events[count++] = { (uint16_t)stepAt, true, semitones, velocity };
+            }
+            sounding = true;
+            releaseAt = stepAt + (gateSamples > 0 ? gateSamples : 1);
+        }
+        clock.tick();
+        stepsPlayed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    clock.endBlock(frames);
+    if (sounding) {
+        releaseAt -= frames;
+    }
+    return count;
+}
@@ -0,0 +1,116 @@
+#ifndef SEQUENCER_H
+#define SEQUENCER_H
+
+#include <stdint.h>
+#include <atomic>
+#include "StepClock.h"
+#include "MessageQueue.h"
+#include "../../../include/Consts.h"
+
+/**
+ * Step sequencer and arpeggiator, clocked by rendered samples
+ *
+ * process() runs once per block on the audio task. It applies pending
+ * messages from the UI, then walks the StepClock through the block and
+ * returns note events with their exact sample offsets; the engine splits
+ * its render at those offsets. Nothing here depends on millis() or on
+ * when the UI gets to run.
+ *
+ * Modes:
+ *   STEPS        up to MAX_STEPS steps, each a transposition or a rest
+ *   ARP_UP/DOWN  the chord notes in order, one per step
+ *   ARP_UP_DOWN  up then down, without repeating the end notes
+ *
+ * One note sounds at a time. Each note is released after `gate` of its
+ * step (per mille); with a full gate the release and the next note-on
+ * share a sample, and a rest lets the last note finish its gate.
+ *
+ * The UI setters only post a message and may be called from loop() or
+ * the console; changes apply at the start of the next block.
+ */
+class Sequencer {
+public:
+    enum Mode : uint8_t {
+        OFF,
+        STEPS,
+        ARP_UP,
+        ARP_DOWN,
+        ARP_UP_DOWN,
+        MODE_COUNT
+    };
+
+    static const int MAX_STEPS = 16;
+    static const int MAX_CHORD = 8;
+    static const int MAX_EVENTS = 16;          // Per block: far more than any tempo needs
+
+    struct Event {
+        uint16_t offset;        // Sample within the block
+        bool noteOn;            // false: release the sounding note
+        int8_t semitones;       // Transposition from the base pitch
+        uint8_t velocity;       // 1 - 127
+    };
+
+private:
+    struct Step {
+        int8_t semitones;
+        uint8_t velocity;       // 0 = rest
+    };
+
+    struct Message {
+        enum Type : uint8_t {
+            SET_MODE, SET_TEMPO, SET_GATE, SET_STEP, SET_LENGTH, SET_CHORD_NOTE, SET_CHORD_SIZE
+        };
+        Type type;
+        int8_t index;
+        int16_t value;
+        uint32_t extra;
+    };
+
+    MessageQueue<Message, 32> messages;
+
+    // Audio task only
+    StepClock clock;
+    Mode mode;
+    Step steps[MAX_STEPS];
+    int length;
+    int8_t chord[MAX_CHORD];
+    int chordSize;
+    uint32_t gatePermille;
+    int position;               // Next step / chord index
+    int direction;              // ARP_UP_DOWN: +1 or -1
+    bool sounding;
+    int64_t releaseAt;          // Relative to the current block, like clock.next()
+
+    // Published for the UI
+    std::atomic<bool> running;
+    std::atomic<uint32_t> stepsPlayed;
+
+public:
+    Sequencer();
+
+    // ---- UI side (any task but the audio task) ----
+    bool setMode(Mode newMode);
+    bool setTempo(uint32_t milliBpm, uint32_t stepsPerBeat = 4);
+    bool setGate(uint32_t permille);
+    bool setStep(int index, int semitones, int velocity);  // velocity 0: rest
+    bool setLength(int steps);
+    bool setChord(const int8_t* semitones, int count);
+
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+    uint32_t getStepsPlayed() const { return stepsPlayed.load(std::memory_order_relaxed); }
+
+    static const char* modeName(Mode m);
+
+    // ---- Audio task ----
+    // Fills events (sorted by offset) for the next `frames` samples
+    int process(int frames, Event* events, int maxEvents);
+
+    uint64_t getElapsedSamples() const { return clock.getElapsed(); }
+
+private:
+    bool post(Message::Type type, int index, int value, uint32_t extra = 0);
+    void apply(const Message& message);
+    bool nextNote(int8_t& semitones, uint8_t& velocity);
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef STEPCLOCK_H
+#define STEPCLOCK_H
+
+#include <stdint.h>
+
+/**
+ * Sample-counting step clock
+ *
+ * Runs on the audio task and counts rendered samples, so step boundaries
+ * land on exact sample offsets within a block no matter how late loop()
+ * or the audio task itself runs.
+ *
+ * A step is SAMPLE_RATE * 60 / (bpm * stepsPerBeat) samples, usually not
+ * a whole number. It is kept as an exact fraction (whole + remainder /
+ * divisor) and the remainder is carried Bresenham-style, so step k always
+ * starts on sample floor(k * length): no drift, however long it runs.
+ *
+ * Tempo is given in milli-BPM (120000 = 120 BPM) so the fraction is exact
+ * for any tempo the UI can set. A tempo change takes effect from the next
+ * step; the one already scheduled keeps its start.
+ *
+ * Per block: while next() < frames, handle a step at next() and call
+ * tick(); then endBlock(frames).
+ */
+class StepClock {
+public:
+    static const uint32_t MIN_MILLI_BPM = 20000;
+    static const uint32_t MAX_MILLI_BPM = 400000;
+
+private:
+    uint32_t sampleRate;
+    uint32_t whole;         // Step length: whole + remainder / divisor samples
+    uint32_t remainder;
+    uint32_t divisor;
+    uint32_t carry;         // Accumulated remainder, < divisor
+    int64_t nextStep;       // Start of the next step, relative to the current block
+    uint64_t elapsed;       // Samples counted since reset()
+
+public:
+    explicit StepClock(uint32_t rate)
+        : sampleRate(rate), whole(0), remainder(0), divisor(1), carry(0), nextStep(0), elapsed(0) {
+        setTempo(120000, 4);
+    }
+
+    void setTempo(uint32_t milliBpm, uint32_t stepsPerBeat) {
+        milliBpm = milliBpm < MIN_MILLI_BPM ? MIN_MILLI_BPM : (milliBpm > MAX_MILLI_BPM ? MAX_MILLI_BPM : milliBpm);
+        stepsPerBeat = stepsPerBeat < 1 ? 1 : (stepsPerBeat > 16 ? 16 : stepsPerBeat);
+
+        // samples/step = rate * 60000 / (milliBpm * stepsPerBeat)
+        uint64_t numerator = (uint64_t)sampleRate * 60000u;
+        uint32_t denominator = milliBpm * stepsPerBeat;
+        whole = (uint32_t)(numerator / denominator);
+        remainder = (uint32_t)(numerator % denominator);
+        divisor = denominator;
+        carry = 0;
+    }
+
+    // Next step restarts on the first sample of the coming block
+    void reset() {
+        carry = 0;
+        nextStep = 0;
+        elapsed = 0;
+    }
+
+    // Offset of the next step from the start of the current block
+    int64_t next() const { return nextStep; }
+
+    // The step at next() has been handled; schedule the one after it
+    void tick() {
+        nextStep += whole;
+        carry += remainder;
+        if (carry >= divisor) {
+            carry -= divisor;
+            nextStep++;
+        }
+    }
+
+    void endBlock(int frames) {
+        nextStep -= frames;
+        elapsed += frames;
+    }
+
+    uint64_t getElapsed() const { return elapsed; }
+    uint32_t getStepSamples() const { return whole; }     // Whole part, for gate lengths
+};
+
+#endif
@@ -1,19 +1,81 @@
 #include "Voice.h"
 #include "Waveforms/Waveforms.h"
 #include "../../include/Consts.h"
+#include "Profiler.h"
 #include <Arduino.h>
 
 Voice::Voice(WaveformGenerator* wf, float freq, float amp) 
-    : waveform(wf), frequency(freq), amplitude(amp), phase(0), isActive(false) {
+    : type(WAVEFORM), waveform(wf), wavetable(nullptr), sampler(nullptr),
+      bank(nullptr), bankFirst(-1), unisonCount(7), detune(0.5f), unisonMix(0.7f), tunedFrequency(-1.0f), fm(nullptr), pluck(nullptr),
+      wavetablePosition(0.0f),
+      frequency(freq), amplitude(amp), phase(0), isActive(false) {
     updatePhaseIncrement();
 }
 
+void Voice::prepareBlock(int frames) {
+    if (type == WAVETABLE && wavetable) {
+        wavetable->prepare(frequency, wavetablePosition);
+    } else if (type == SAMPLE && sampler) {
+        sampler->setFrequency(frequency);
+        sampler->prepare(frames);      // Decode ADPCM blocks ahead of the play position
+    } else if (type == SUPERSAW && frequency != tunedFrequency) {
+        bank->setUnison(bankFirst, unisonCount, frequency, detune, unisonMix);
+        tunedFrequency = frequency;
+    } else if (type == FM && fm) {
+        fm->prepare(frequency, frames);     // Operator pitches + envelopes
+    } else if (type == PLUCK && pluck) {
+        pluck->prepare(frequency);          // Delay length + a pending pluck
+    }
+}
+
+void Voice::render(float* output, int frames) {
+    PROFILE_SCOPE("Voice::render");
+
+    if (type == SUPERSAW && isActive) {
+        bank->render(bankFirst, unisonCount, output, frames);
+        for (int i = 0; i < frames; i++) {
+            output[i] *= amplitude;
+        }
+        return;
+    }
+    if (type == FM && isActive) {
+        fm->render(output, frames, amplitude);
+        return;
+    }
+    if (type == PLUCK && isActive) {
+        pluck->render(output, frames, amplitude);
+        return;
+    }
+
+    for (int i = 0; i < frames; i++) {
+        output[i] = getNextSample();
+    }
+}
+
 float Voice::getNextSample() {
-    if (!isActive || !waveform) {
+    if (!isActive) {
         return 0.0f;
     }
 
-    float sample = waveform->getSample(phase) * amplitude;
+    float sample;
+    switch (type) {
+        case WAVETABLE:
+            sample = wavetable->getSample(phase) * amplitude;
+            break;
+        case SAMPLE:
+            // Sample playback keeps its own position; phase is unused
+            return sampler->getSample() * amplitude;
+        case SUPERSAW:
+        case FM:
+        case PLUCK:
+            return 0.0f;    // Block-rendered only, see render()
+        default:
+            if (!waveform) {
+                return 0.0f;
+            }
+            sample = waveform->getSample(phase) * amplitude;
+            break;
+    }
     
     phase += phaseIncrement;
     if (phase >= TWO_PI) {
@@ -29,6 +91,17 @@ void Voice::noteOn(float freq, float amp) {
     amplitude = amp;
     isActive = true;
     updatePhaseIncrement();
+    if (type == SAMPLE && sampler) {
+        sampler->setFrequency(frequency);
+        sampler->trigger();
+    } else if (type == SUPERSAW && bank) {
+        bank->randomizePhases(bankFirst, unisonCount);  // No phasey attack
+        tunedFrequency = -1.0f;
+    } else if (type == FM && fm) {
+        fm->noteOn();
+    } else if (type == PLUCK && pluck) {
+        pluck->pluck();
+    }
 }
 
 void Voice::noteOff() {
@@ -37,6 +110,74 @@ void Voice::noteOff() {
 
 void Voice::setWaveform(WaveformGenerator* wf) {
     waveform = wf;
+    type = WAVEFORM;
+}
+
+void Voice::setWavetable(WavetableOscillator* osc) {
+    wavetable = osc;
+    type = osc ? WAVETABLE : WAVEFORM;
+}
+
+void Voice::setSamplePlayer(SamplePlayer* player) {
+    if (type == SAMPLE && sampler == player) {
+        return;     // Already playing; don't retrigger every block
+    }
+
+    sampler = player;
+    type = player ? SAMPLE : WAVEFORM;
+    if (player) {
+        player->setFrequency(frequency);
+        player->trigger();
+    }
+}
+
+void Voice::setSupersaw(OscillatorBank* oscillators, int first) {
+    if (type == SUPERSAW && bank == oscillators) {
+        return;
+    }
+
+    bank = oscillators;
+    bankFirst = first;
+    type = (oscillators && first >= 0) ? SUPERSAW : WAVEFORM;
+    tunedFrequency = -1.0f;
+    if (type == SUPERSAW) {
+        bank->randomizePhases(bankFirst, unisonCount);
+    }
+}
+
+void Voice::setFm(FmVoice* voice) {
+    if (type == FM && fm == voice) {
+        return;
+    }
+
+    fm = voice;
+    type = voice ? FM : WAVEFORM;
+    if (voice) {
+        voice->noteOn();
+    }
+}
+
+void Voice::setPluck(PluckString* string) {
+    if (type == PLUCK && pluck == string) {
+        return;
+    }
+
+    pluck = string;
+    type = (string && string->isReady()) ? PLUCK : WAVEFORM;
+    if (type == PLUCK) {
+        string->pluck();
+    }
+}
+
+void Voice::setUnison(int count, float detuneAmount, float mix) {
+    unisonCount = constrain(count, 1, OscillatorBank::MAX_UNISON);
+    detune = constrain(detuneAmount, 0.0f, 1.0f);
+    unisonMix = constrain(mix, 0.0f, 1.0f);
+    tunedFrequency = -1.0f;
+}
+
+void Voice::setWavetablePosition(float position) {
+    wavetablePosition = position;
 }
 
 void Voice::setFrequency(float freq) {
@@ -2,11 +2,38 @@
 #define VOICE_H
 
 #include "Waveforms/WaveformGenerator.h"
+#include "Wavetable/WavetableOscillator.h"
+#include "Sampler/SamplePlayer.h"
+#include "Oscillators/OscillatorBank.h"
+#include "Fm/FmVoice.h"
+#include "Physical/PluckString.h"
 #include "../../include/Consts.h"
 
 class Voice {
+public:
+    enum Type {
+        WAVEFORM,       // Shared WaveformGenerator (SineWave, SawWave, ...)
+        WAVETABLE,      // Per-voice WavetableOscillator (PSRAM tables, SRAM cache)
+        SAMPLE,         // Per-voice SamplePlayer (PCM/ADPCM mapped from flash)
+        SUPERSAW,       // Unison stack in the shared OscillatorBank
+        FM,             // Per-voice FmVoice (2-4 integer operators)
+        PLUCK           // Per-voice PluckString (Karplus-Strong, SRAM ring)
+    };
+
 private:
+    Type type;
     WaveformGenerator* waveform;
+    WavetableOscillator* wavetable;
+    SamplePlayer* sampler;
+    OscillatorBank* bank;
+    int bankFirst;              // This voice's oscillators in the bank
+    int unisonCount;
+    float detune;
+    float unisonMix;
+    float tunedFrequency;       // Bank was last tuned for this (-1: retune)
+    FmVoice* fm;
+    PluckString* pluck;
+    float wavetablePosition;
     float frequency;
     float amplitude;
     float phase;
@@ -16,16 +43,26 @@ private:
 public:
     Voice(WaveformGenerator* wf = nullptr, float freq = 0.0f, float amp = 0.0f);
     
+    void prepareBlock(int frames);  // Control-rate work before rendering `frames` samples
     float getNextSample();
+    void render(float* output, int frames);     // Whole block; SoA path for SUPERSAW
     void noteOn(float freq, float amp);
     void noteOff();
     void setWaveform(WaveformGenerator* wf);
+    void setWavetable(WavetableOscillator* osc);
+    void setWavetablePosition(float position);
+    void setSamplePlayer(SamplePlayer* player);
+    void setSupersaw(OscillatorBank* oscillators, int first);  // first: MAX_UNISON reserved
+    void setUnison(int count, float detuneAmount, float mix);
+    void setFm(FmVoice* voice);
+    void setPluck(PluckString* string);
     void setFrequency(float freq);
     void setAmplitude(float amp);
     bool getIsActive() const { return isActive; }
+    Type getType() const { return type; }
 
 
 private:
     void updatePhaseIncrement();
 };
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,204 @@
+#include "Wavetable.h"
+#include "esp_heap_caps.h"
+#include "Log.h"
+#include "../Codec/ImaAdpcm.h"
+#include "../../../include/Consts.h"
+
+// ========== Harmonic recipes (sine series) ==========
+static float sineHarmonic(int h) {
+    return (h == 1) ? 1.0f : 0.0f;
+}
+
+static float triangleHarmonic(int h) {
+    if ((h & 1) == 0) return 0.0f;
+    float sign = (((h - 1) / 2) & 1) ? -1.0f : 1.0f;
+    return sign * 8.0f / (PI * PI * h * h);
+}
+
+static float sawHarmonic(int h) {
+    float sign = (h & 1) ? 1.0f : -1.0f;
+    return sign * 2.0f / (PI * h);
+}
+
+static float squareHarmonic(int h) {
+    return (h & 1) ? 4.0f / (PI * h) : 0.0f;
+}
+
+Wavetable::Wavetable()
+    : data(nullptr), external(nullptr), externalFormat(SAMPLE_FORMAT_PCM16), frameCount(0), ready(false) {
+}
+
+Wavetable::~Wavetable() {
+    if (data) {
+        heap_caps_free(data);
+    }
+}
+
+size_t Wavetable::getSizeBytes() const {
+    if (external) {
+        uint32_t samples = (uint32_t)frameCount * MIP_LEVELS * TABLE_SIZE;
+        return (externalFormat == SAMPLE_FORMAT_IMA_ADPCM)
+            ? ImaAdpcm::encodedBytes(samples) : samples * sizeof(int16_t);
+    }
+    return (size_t)frameCount * MIP_LEVELS * TABLE_STRIDE * sizeof(int16_t);
+}
+
+bool Wavetable::allocate(int frames) {
+    if (frames < 1 || frames > MAX_FRAMES || data || external) {
+        return false;
+    }
+
+    frameCount = frames;
+    size_t bytes = getSizeBytes();
+
+    data = (int16_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+    if (!data) {
+        LOG("[WT] No PSRAM, using internal RAM");
+        data = (int16_t*)heap_caps_malloc(bytes, MALLOC_CAP_8BIT);
+    }
+    if (!data) {
+        frameCount = 0;
+        return false;
+    }
+    return true;
+}
+
+bool Wavetable::loadFromBank(const SampleInfo* info, const uint8_t* assetData) {
+    if (!info || !assetData || data || external || info->kind != SAMPLE_KIND_WAVETABLE) {
+        return false;
+    }
+
+    int frames = info->frameCount;
+    if (frames < 1 || info->length != (uint32_t)frames * MIP_LEVELS * TABLE_SIZE) {
+        LOG("[WT] Bank wavetable has a bad shape (%d frames, %lu samples)",
+            frames, (unsigned long)info->length);
+        return false;
+    }
+
+    external = assetData;
+    externalFormat = info->format;
+    frameCount = frames;
+    ready.store(true, std::memory_order_release);
+
+    LOG("[WT] %d frames x %d mips from flash (%s, %u bytes)", frames, MIP_LEVELS,
+        externalFormat == SAMPLE_FORMAT_IMA_ADPCM ? "ADPCM" : "PCM", (unsigned)getSizeBytes());
+    return true;
+}
+
+void Wavetable::copyTable(int frame, int mip, int16_t* dst) const {
+    size_t table = (size_t)frame * MIP_LEVELS + mip;
+
+    if (data) {
+        memcpy(dst, data + table * TABLE_STRIDE, sizeof(int16_t) * TABLE_STRIDE);
+        return;
+    }
+
+    if (externalFormat == SAMPLE_FORMAT_IMA_ADPCM) {
+        // TABLE_SIZE is a whole number of blocks, so each table decodes on its own
+        const int blocks = TABLE_SIZE / ImaAdpcm::BLOCK_SAMPLES;
+        const uint8_t* src = external + table * blocks * ImaAdpcm::BLOCK_BYTES;
+        for (int b = 0; b < blocks; b++) {
+            ImaAdpcm::decodeBlock(src + b * ImaAdpcm::BLOCK_BYTES, dst + b * ImaAdpcm::BLOCK_SAMPLES);
+        }
+    } else {
+        memcpy(dst, external + table * TABLE_SIZE * sizeof(int16_t), sizeof(int16_t) * TABLE_SIZE);
+    }
+    dst[TABLE_SIZE] = dst[0];           // Guard for interpolation
+    dst[TABLE_SIZE + 1] = dst[1];
+}
+
+int Wavetable::mipForFrequency(float frequency) {
+    int mip = 0;
+    float limit = BASE_FREQUENCY * 2.0f;
+    while (frequency > limit && mip < MIP_LEVELS - 1) {
+        limit *= 2.0f;
+        mip++;
+    }
+    return mip;
+}
+
+void Wavetable::buildBasicShapes() {
+    static const HarmonicFunction shapes[] = {
+        sineHarmonic, triangleHarmonic, sawHarmonic, squareHarmonic
+    };
+    const int shapeCount = sizeof(shapes) / sizeof(shapes[0]);
+
+    if (!data && !allocate(shapeCount)) {
+        LOG("[WT] Allocation failed");
+        return;
+    }
+
+    // Temporary build buffers (internal RAM, freed afterwards)
+    float* sineTable = (float*)malloc(TABLE_SIZE * sizeof(float));
+    float* work = (float*)malloc(TABLE_SIZE * sizeof(float));
+    if (!sineTable || !work) {
+        free(sineTable);
+        free(work);
+        return;
+    }
+
+    for (int i = 0; i < TABLE_SIZE; i++) {
+        sineTable[i] = sinf(TWO_PI * i / TABLE_SIZE);
+    }
+
+    for (int frame = 0; frame < frameCount && frame < shapeCount; frame++) {
+        buildFrame(frame, shapes[frame], sineTable, work);
+    }
+
+    free(sineTable);
+    free(work);
+
+    ready.store(true, std::memory_order_release);
+}
+
+void Wavetable::buildFrame(int frame, HarmonicFunction amplitudeOf, const float* sineTable, float* work) {
+    float scale = 0.0f;
+
+    for (int mip = 0; mip < MIP_LEVELS; mip++) {
+        // Highest frequency this level is played at, and what fits below Nyquist
+        float topFrequency = BASE_FREQUENCY * (float)(2 << mip);
+        int harmonics = (int)((SAMPLE_RATE / 2) / topFrequency);
+        if (harmonics > TABLE_SIZE / 2) harmonics = TABLE_SIZE / 2;
+        if (harmonics < 1) harmonics = 1;
+
+        memset(work, 0, TABLE_SIZE * sizeof(float));
+        for (int h = 1; h <= harmonics; h++) {
+            float amplitude = amplitudeOf(h);
+            if (amplitude == 0.0f) continue;
+            for (int i = 0; i < TABLE_SIZE; i++) {
+                work[i] += amplitude * sineTable[(h * i) & (TABLE_SIZE - 1)];
+            }
+        }
+
+        // Normalise on the richest level so all mips of a frame share one gain
+        if (mip == 0) {
+            float peak = 0.0f;
+            for (int i = 0; i < TABLE_SIZE; i++) {
+                peak = max(peak, fabsf(work[i]));
+            }
+            scale = (peak > 0.0f) ? 32767.0f / peak : 0.0f;
+        }
+
+        int16_t* table = data + ((size_t)frame * MIP_LEVELS + mip) * TABLE_STRIDE;
+        for (int i = 0; i < TABLE_SIZE; i++) {
+            table[i] = (int16_t)constrain(lrintf(work[i] * scale), -32767L, 32767L);
+        }
+        table[TABLE_SIZE] = table[0];       // Guard for interpolation
+        table[TABLE_SIZE + 1] = table[1];
+    }
+}
+
+void Wavetable::buildAsync(UBaseType_t priority, BaseType_t core) {
+    xTaskCreatePinnedToCore(buildTask, "WavetableBuild", 3072, this, priority, nullptr, core);
+}
+
+void Wavetable::buildTask(void* parameter) {
+    Wavetable* self = static_cast<Wavetable*>(parameter);
+    unsigned long start = millis();
+
+    self->buildBasicShapes();
+    LOG("[WT] %d frames x %d mips built in %lu ms (%u bytes)",
+        self->frameCount, MIP_LEVELS, millis() - start, (unsigned)self->getSizeBytes());
+
+    vTaskDelete(nullptr);
+}
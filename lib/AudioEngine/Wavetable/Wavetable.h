@@ -0,0 +1,79 @@
+#ifndef WAVETABLE_H
+#define WAVETABLE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "../Sampler/SampleBank.h"
+
+/**
+ * Band-limited, mipmapped wavetable stored in PSRAM
+ *
+ * Layout: [frame][mip level][TABLE_STRIDE] int16 samples.
+ * - Frames are the morph targets (e.g. sine -> triangle -> saw -> square)
+ * - One mip level per octave above BASE_FREQUENCY; level k only contains
+ *   the harmonics that stay below Nyquist when played up to BASE * 2^(k+1)
+ * - Each table has a guard sample (copy of sample 0) so interpolation
+ *   never has to wrap
+ *
+ * Building the tables takes a few hundred ms, so it runs on a background
+ * task (buildAsync) and the oscillators stay silent until isReady().
+ *
+ * Alternatively the tables can come from a wavetable asset in the sample
+ * bank (loadFromBank). Those stay in mapped flash, unpadded
+ * ([frame][mip][TABLE_SIZE]) and either PCM16 or IMA-ADPCM; copyTable()
+ * decodes one table into a caller buffer and adds the guard samples.
+ * Only the built tables are directly readable through getTable().
+ */
+class Wavetable {
+public:
+    static const int TABLE_BITS = 10;
+    static const int TABLE_SIZE = 1 << TABLE_BITS;     // Samples per cycle
+    static const int TABLE_STRIDE = TABLE_SIZE + 2;    // + guard, keeps 4-byte alignment
+    static const int MIP_LEVELS = 11;                  // 20 Hz ... 40 kHz, one per octave
+    static const int MAX_FRAMES = 8;
+    static constexpr float BASE_FREQUENCY = 20.0f;
+
+private:
+    int16_t* data;              // PSRAM (internal RAM fallback)
+    const uint8_t* external;    // Bank asset in mapped flash (instead of data)
+    uint32_t externalFormat;    // SampleFormat of the bank asset
+    int frameCount;
+    std::atomic<bool> ready;
+
+public:
+    Wavetable();
+    ~Wavetable();
+
+    bool allocate(int frames);
+    void buildBasicShapes();                           // sine, triangle, saw, square
+    void buildAsync(UBaseType_t priority, BaseType_t core);
+    bool loadFromBank(const SampleInfo* info, const uint8_t* assetData);
+
+    bool isReady() const { return ready.load(std::memory_order_acquire); }
+    int getFrameCount() const { return frameCount; }
+    size_t getSizeBytes() const;
+
+    // Start of one table (TABLE_STRIDE samples) in PSRAM; built tables only
+    bool hasDirectTables() const { return data != nullptr; }
+    const int16_t* getTable(int frame, int mip) const {
+        return data + ((size_t)frame * MIP_LEVELS + mip) * TABLE_STRIDE;
+    }
+
+    /**
+     * Copy (or decode) one table, including guard samples
+     *
+     * @param frame: Frame index
+     * @param mip: Mip level
+     * @param dst: TABLE_STRIDE samples
+     */
+    void copyTable(int frame, int mip, int16_t* dst) const;
+
+    static int mipForFrequency(float frequency);
+
+private:
+    typedef float (*HarmonicFunction)(int harmonic);
+    void buildFrame(int frame, HarmonicFunction amplitudeOf, const float* sineTable, float* work);
+    static void buildTask(void* parameter);
+};
+
+#endif
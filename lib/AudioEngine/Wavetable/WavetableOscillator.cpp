@@ -0,0 +1,65 @@
+#include "WavetableOscillator.h"
+
+WavetableOscillator::WavetableOscillator()
+    : table(nullptr), readA(nullptr), readB(nullptr),
+      cachedMip(-1), cachedFrameA(-1), cachedFrameB(-1), morph(0.0f), useCache(true) {
+}
+
+void WavetableOscillator::setTable(const Wavetable* wavetable) {
+    table = wavetable;
+    cachedMip = -1;     // Force a refill on the next prepare()
+}
+
+void WavetableOscillator::setCacheEnabled(bool enabled) {
+    useCache = enabled;
+    cachedMip = -1;
+}
+
+void WavetableOscillator::prepare(float frequency, float position) {
+    if (!table || !table->isReady()) {
+        readA = readB = nullptr;
+        return;
+    }
+
+    int frames = table->getFrameCount();
+    float framePosition = constrain(position, 0.0f, 1.0f) * (frames - 1);
+    int frameA = (int)framePosition;
+    int frameB = min(frameA + 1, frames - 1);
+    morph = framePosition - frameA;
+
+    int mip = Wavetable::mipForFrequency(frequency);
+
+    // Bank tables live in flash and may be ADPCM: always go through the cache
+    if (!useCache && table->hasDirectTables()) {
+        readA = table->getTable(frameA, mip);
+        readB = table->getTable(frameB, mip);
+        return;
+    }
+
+    // Only touch PSRAM when the playing tables actually change.
+    // When moving to the neighbouring frame, reuse what is already cached.
+    if (mip != cachedMip) {
+        refill(cacheA, frameA, mip);
+        refill(cacheB, frameB, mip);
+    } else if (frameA != cachedFrameA || frameB != cachedFrameB) {
+        if (frameA == cachedFrameB) {
+            memcpy(cacheA, cacheB, sizeof(cacheA));
+        } else if (frameA != cachedFrameA) {
+            refill(cacheA, frameA, mip);
+        }
+        if (frameB != cachedFrameB) {
+            refill(cacheB, frameB, mip);
+        }
+    }
+
+    cachedMip = mip;
+    cachedFrameA = frameA;
+    cachedFrameB = frameB;
+    readA = cacheA;
+    readB = cacheB;
+}
+
+void WavetableOscillator::refill(int16_t* cache, int frame, int mip) {
+    // One contiguous 2 KB burst from PSRAM, or a 528-byte ADPCM decode from flash
+    table->copyTable(frame, mip, cache);
+}
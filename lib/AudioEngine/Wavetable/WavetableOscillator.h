@@ -0,0 +1,68 @@
+#ifndef WAVETABLE_OSCILLATOR_H
+#define WAVETABLE_OSCILLATOR_H
+
+#include <Arduino.h>
+#include "Wavetable.h"
+
+/**
+ * Per-voice wavetable playback with an internal-SRAM cache
+ *
+ * prepare() runs once per block (control rate): it picks the mip level for
+ * the current frequency and the two frames around the morph position, and
+ * copies those two tables from PSRAM into cacheA/cacheB only when they
+ * change. getSample() then reads SRAM exclusively, so the per-sample loop
+ * never stalls on a PSRAM cache miss.
+ *
+ * With the cache disabled the same code reads PSRAM directly (for the
+ * benchmark comparison).
+ */
+class WavetableOscillator {
+private:
+    const Wavetable* table;
+
+    // Internal SRAM copies of the two frames being morphed
+    int16_t cacheA[Wavetable::TABLE_STRIDE];
+    int16_t cacheB[Wavetable::TABLE_STRIDE];
+
+    const int16_t* readA;       // cacheA/B, PSRAM tables, or nullptr (silent)
+    const int16_t* readB;
+    int cachedMip;
+    int cachedFrameA;
+    int cachedFrameB;
+    float morph;                // 0 = frame A, 1 = frame B
+    bool useCache;
+
+public:
+    WavetableOscillator();
+
+    void setTable(const Wavetable* wavetable);
+    void setCacheEnabled(bool enabled);
+
+    /**
+     * Control-rate update, call before rendering each block
+     *
+     * @param frequency: Playback frequency (Hz), selects the mip level
+     * @param position: Morph position 0.0 (first frame) - 1.0 (last frame)
+     */
+    void prepare(float frequency, float position);
+
+    // phase: 0 - TWO_PI (same convention as WaveformGenerator)
+    inline float getSample(float phase) const {
+        if (!readA) {
+            return 0.0f;
+        }
+
+        float index = phase * (Wavetable::TABLE_SIZE / TWO_PI);
+        int i = (int)index & (Wavetable::TABLE_SIZE - 1);
+        float frac = index - (int)index;
+
+        float a = readA[i] + frac * (readA[i + 1] - readA[i]);
+        float b = readB[i] + frac * (readB[i + 1] - readB[i]);
+        return (a + morph * (b - a)) * (1.0f / 32768.0f);
+    }
+
+private:
+    void refill(int16_t* cache, int frame, int mip);
+};
+
+#endif
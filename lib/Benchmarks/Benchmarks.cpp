@@ -0,0 +1,365 @@
+#include "Benchmarks.h"
+#include <Arduino.h>
+#include "esp_heap_caps.h"
+#include "Wavetable/Wavetable.h"
+#include "Wavetable/WavetableOscillator.h"
+#include "Sampler/SamplePlayer.h"
+#include "Codec/ImaAdpcm.h"
+#include "Scope/FixedFft.h"
+#include "Oscillators/OscillatorBank.h"
+#include "Fm/FmVoice.h"
+#include "Physical/PluckString.h"
+#include "Waveforms/Waveforms.h"
+#include "Voice.h"
+#include "../../include/Consts.h"
+#include "../../include/CycleCounter.h"
+
+// Samples per benchmark block, same as one audio block
+static const int BENCH_BLOCK = BLOCK_FRAMES;
+static const int BENCH_BLOCKS = 200;
+
+// Results go into a volatile sink so the compiler can't drop the loops
+static volatile float benchSink;
+
+void runBenchmarks() {
+    delay(3000);    // Give the serial monitor time to attach
+    Serial.println("========== eduLAB benchmarks ==========");
+    Serial.printf("CPU: %lu MHz, block: %d samples\n", (unsigned long)cycleCounterMHz(), BENCH_BLOCK);
+
+    benchmarkWavetable();
+    benchmarkAdpcm();
+    benchmarkFft();
+    benchmarkOscillators();
+    benchmarkFm();
+    benchmarkPluck();
+
+    Serial.println("========== benchmarks done ==========");
+}
+
+// ==========================================
+// WAVETABLE: PSRAM-direct vs SRAM-cached playback
+// ==========================================
+void benchmarkWavetable() {
+    Wavetable table;
+    table.buildBasicShapes();
+    if (!table.isReady()) {
+        Serial.println("[BENCH] Wavetable: build failed");
+        return;
+    }
+
+    // Other PSRAM traffic (delay lines, other tables) evicts the tables from
+    // the data cache between blocks; emulate it by streaming through a buffer
+    // larger than the cache before every block (not timed).
+    const size_t thrashBytes = 128 * 1024;
+    volatile uint32_t* thrash = (volatile uint32_t*)heap_caps_malloc(thrashBytes, MALLOC_CAP_SPIRAM);
+
+    WavetableOscillator osc;
+    osc.setTable(&table);
+
+    const float frequencies[] = {55.0f, 440.0f, 3520.0f};
+
+    for (float frequency : frequencies) {
+        uint64_t cycles[2] = {0, 0};
+
+        for (int cached = 0; cached < 2; cached++) {
+            osc.setCacheEnabled(cached == 1);
+            float phase = 0.0f;
+            float increment = TWO_PI * frequency / SAMPLE_RATE;
+            float acc = 0.0f;
+
+            for (int block = 0; block < BENCH_BLOCKS; block++) {
+                if (thrash) {
+                    for (size_t i = 0; i < thrashBytes / 4; i += 8) {
+                        thrash[i];
+                    }
+                }
+
+                // Morph slowly so frame changes (and cache refills) are included
+                float position = (float)block / BENCH_BLOCKS;
+
+                uint32_t start = readCycleCounter();
+                osc.prepare(frequency, position);
+                for (int i = 0; i < BENCH_BLOCK; i++) {
+                    acc += osc.getSample(phase);
+                    phase += increment;
+                    if (phase >= TWO_PI) phase -= TWO_PI;
+                }
+                cycles[cached] += readCycleCounter() - start;
+            }
+            benchSink = acc;
+        }
+
+        const uint32_t samples = BENCH_BLOCK * BENCH_BLOCKS;
+        Serial.printf("[BENCH] Wavetable %4d Hz: PSRAM-direct %.1f cyc/sample, SRAM-cached %.1f cyc/sample\n",
+                      (int)frequency, (double)cycles[0] / samples, (double)cycles[1] / samples);
+    }
+
+    heap_caps_free((void*)thrash);
+}
+
+// ==========================================
+// ADPCM: streaming decode vs uncompressed PCM reads
+// ==========================================
+void benchmarkAdpcm() {
+    // A 2 s looped test tone in PSRAM stands in for a mapped flash sample:
+    // both sit behind the same external-memory cache.
+    const uint32_t length = SAMPLE_RATE * 2;
+    const size_t encodedSize = ImaAdpcm::encodedBytes(length);
+    int16_t* pcm = (int16_t*)heap_caps_malloc(length * sizeof(int16_t), MALLOC_CAP_SPIRAM);
+    uint8_t* encoded = (uint8_t*)heap_caps_malloc(encodedSize, MALLOC_CAP_SPIRAM);
+    if (!pcm || !encoded) {
+        Serial.println("[BENCH] ADPCM: allocation failed");
+        heap_caps_free(pcm);
+        heap_caps_free(encoded);
+        return;
+    }
+
+    for (uint32_t i = 0; i < length; i++) {
+        float t = (float)i / SAMPLE_RATE;
+        pcm[i] = (int16_t)(12000.0f * sinf(TWO_PI * 220.0f * t) + 6000.0f * sinf(TWO_PI * 1330.0f * t));
+    }
+    ImaAdpcm::State state = {0, 0};
+    for (uint32_t start = 0; start < length; start += ImaAdpcm::BLOCK_SAMPLES) {
+        int count = min((uint32_t)ImaAdpcm::BLOCK_SAMPLES, length - start);
+        ImaAdpcm::encodeBlock(pcm + start, count, state,
+                              encoded + (start / ImaAdpcm::BLOCK_SAMPLES) * ImaAdpcm::BLOCK_BYTES);
+    }
+
+    SampleInfo info = {};
+    info.length = length;
+    info.sampleRate = SAMPLE_RATE;
+    info.loopStart = 0;
+    info.loopEnd = length;
+    info.rootFrequency = 440.0f;
+
+    const size_t thrashBytes = 128 * 1024;
+    volatile uint32_t* thrash = (volatile uint32_t*)heap_caps_malloc(thrashBytes, MALLOC_CAP_SPIRAM);
+
+    // Players hold their decode slots, keep them off the stack
+    static SamplePlayer player;
+    const float frequencies[] = {220.0f, 440.0f, 1760.0f};
+
+    Serial.printf("[BENCH] ADPCM: %u PCM bytes -> %u ADPCM bytes (%.2f:1)\n",
+                  (unsigned)(length * sizeof(int16_t)), (unsigned)encodedSize,
+                  (double)(length * sizeof(int16_t)) / encodedSize);
+
+    for (float frequency : frequencies) {
+        uint64_t cycles[2] = {0, 0};
+
+        for (int compressed = 0; compressed < 2; compressed++) {
+            info.format = compressed ? SAMPLE_FORMAT_IMA_ADPCM : SAMPLE_FORMAT_PCM16;
+            player.setSample(&info, compressed ? encoded : (const uint8_t*)pcm);
+            player.setFrequency(frequency);
+            player.trigger();
+            float acc = 0.0f;
+
+            for (int block = 0; block < BENCH_BLOCKS; block++) {
+                if (thrash) {
+                    for (size_t i = 0; i < thrashBytes / 4; i += 8) {
+                        thrash[i];
+                    }
+                }
+
+                uint32_t start = readCycleCounter();
+                player.prepare(BENCH_BLOCK);
+                for (int i = 0; i < BENCH_BLOCK; i++) {
+                    acc += player.getSample();
+                }
+                cycles[compressed] += readCycleCounter() - start;
+            }
+            benchSink = acc;
+        }
+
+        // Source bytes pulled from flash/PSRAM per second of one voice
+        double framesPerSecond = (double)SAMPLE_RATE * frequency / info.rootFrequency;
+        double pcmRate = framesPerSecond * sizeof(int16_t);
+        double adpcmRate = framesPerSecond * ImaAdpcm::BLOCK_BYTES / ImaAdpcm::BLOCK_SAMPLES;
+
+        const uint32_t samples = BENCH_BLOCK * BENCH_BLOCKS;
+        Serial.printf("[BENCH] ADPCM %4d Hz: PCM %.1f cyc/sample, ADPCM %.1f cyc/sample; "
+                      "%.0f -> %.0f KB/s per voice\n",
+                      (int)frequency, (double)cycles[0] / samples, (double)cycles[1] / samples,
+                      pcmRate / 1024.0, adpcmRate / 1024.0);
+    }
+
+    player.setSample(nullptr, nullptr);
+    heap_caps_free((void*)thrash);
+    heap_caps_free(pcm);
+    heap_caps_free(encoded);
+}
+
+// ==========================================
+// FFT: one spectrum frame of the OLED display
+// ==========================================
+void benchmarkFft() {
+    static FixedFft fft;
+    static int16_t re[FixedFft::SIZE];
+    static int16_t im[FixedFft::SIZE];
+    const int frames = 100;
+
+    uint64_t cycles = 0;
+    uint32_t acc = 0;
+    for (int frame = 0; frame < frames; frame++) {
+        for (int i = 0; i < FixedFft::SIZE; i++) {
+            re[i] = (int16_t)(12000.0f * sinf(TWO_PI * (9.0f + frame * 0.1f) * i / FixedFft::SIZE));
+            im[i] = 0;
+        }
+
+        uint32_t start = readCycleCounter();
+        fft.applyWindow(re);
+        fft.transform(re, im);
+        for (int k = 0; k < FixedFft::BINS; k++) {
+            acc += FixedFft::magnitude(re[k], im[k]);
+        }
+        cycles += readCycleCounter() - start;
+    }
+    benchSink = (float)acc;
+
+    double perFrame = (double)cycles / frames;
+    Serial.printf("[BENCH] FFT %d-point radix-4: %.0f cycles/frame (%.1f us, %.2f%% of a 50 ms UI frame)\n",
+                  FixedFft::SIZE, perFrame, perFrame / cycleCounterMHz(),
+                  perFrame / cycleCounterMHz() / 500.0);
+}
+
+// ==========================================
+// OSCILLATORS: Voice objects vs the SoA bank
+// ==========================================
+void benchmarkOscillators() {
+    const int count = 64;
+    static float block[BENCH_BLOCK];
+    static float mix[BENCH_BLOCK];
+
+    // Current layout: one Voice per oscillator, virtual getSample per sample
+    static SawWave saw;
+    static Voice voices[count];
+    for (int v = 0; v < count; v++) {
+        voices[v] = Voice(&saw, 0.0f, 0.0f);
+        voices[v].noteOn(110.0f * (1.0f + v * 0.003f), 1.0f / count);
+    }
+
+    uint64_t voiceCycles = 0;
+    for (int b = 0; b < BENCH_BLOCKS; b++) {
+        uint32_t start = readCycleCounter();
+        memset(mix, 0, sizeof(mix));
+        for (int v = 0; v < count; v++) {
+            voices[v].render(block, BENCH_BLOCK);
+            for (int i = 0; i < BENCH_BLOCK; i++) {
+                mix[i] += block[i];
+            }
+        }
+        voiceCycles += readCycleCounter() - start;
+    }
+    benchSink = mix[0];
+
+    // SoA: the same oscillators as 4 supersaw stacks of 16
+    static OscillatorBank bank;
+    int first = bank.allocate(count);
+    for (int s = 0; s < count / OscillatorBank::MAX_UNISON && first >= 0; s++) {
+        int base = first + s * OscillatorBank::MAX_UNISON;
+        bank.setUnison(base, OscillatorBank::MAX_UNISON, 110.0f * (s + 1), 0.5f, 0.7f);
+        bank.randomizePhases(base, OscillatorBank::MAX_UNISON);
+    }
+
+    uint64_t bankCycles = 0;
+    for (int b = 0; b < BENCH_BLOCKS && first >= 0; b++) {
+        uint32_t start = readCycleCounter();
+        memset(mix, 0, sizeof(mix));
+        for (int s = 0; s < count / OscillatorBank::MAX_UNISON; s++) {
+            bank.render(first + s * OscillatorBank::MAX_UNISON, OscillatorBank::MAX_UNISON, block, BENCH_BLOCK);
+            for (int i = 0; i < BENCH_BLOCK; i++) {
+                mix[i] += block[i];
+            }
+        }
+        bankCycles += readCycleCounter() - start;
+    }
+    benchSink = mix[0];
+
+    // Oscillators one core could run at 100% load (no effects, no UI)
+    const double oscSamples = (double)count * BENCH_BLOCK * BENCH_BLOCKS;
+    const double budget = (double)cycleCounterMHz() * 1e6 / SAMPLE_RATE;     // Cycles per sample
+    double voicePerOsc = voiceCycles / oscSamples;
+    double bankPerOsc = bankCycles / oscSamples;
+    Serial.printf("[BENCH] Oscillators: Voice %.1f cyc/osc-sample (%d per core), "
+                  "SoA bank %.1f cyc/osc-sample (%d per core)\n",
+                  voicePerOsc, (int)(budget / voicePerOsc), bankPerOsc, (int)(budget / bankPerOsc));
+}
+
+// ==========================================
+// FM: cycles per voice for every algorithm
+// ==========================================
+void benchmarkFm() {
+    const int controlRate = 32;     // Engine default
+    static float block[BENCH_BLOCK];
+    static FmVoice voice;
+    FmVoice::buildSineTable();
+
+    const double budget = (double)cycleCounterMHz() * 1e6 / SAMPLE_RATE;
+    for (int a = 0; a < FmVoice::ALG_COUNT; a++) {
+        FmVoice::Patch patch = FmVoice::PRESETS[3];
+        patch.algorithm = (FmVoice::Algorithm)a;
+        patch.feedback = 0.5f;
+        voice.setPatch(patch);
+        voice.noteOn();
+
+        uint64_t cycles = 0;
+        for (int b = 0; b < BENCH_BLOCKS; b++) {
+            uint32_t start = readCycleCounter();
+            for (int offset = 0; offset < BENCH_BLOCK; offset += controlRate) {
+                voice.prepare(220.0f, controlRate);
+                voice.render(block + offset, controlRate, 0.5f);
+            }
+            cycles += readCycleCounter() - start;
+        }
+        benchSink = block[0];
+
+        double perSample = (double)cycles / (BENCH_BLOCK * BENCH_BLOCKS);
+        Serial.printf("[BENCH] FM %-12s (%d op): %.1f cyc/sample per voice, %d voices per core\n",
+                      FmVoice::algorithmName(patch.algorithm), FmVoice::operatorCount(patch.algorithm),
+                      perSample, (int)(budget / perSample));
+    }
+}
+
+// ==========================================
+// PLUCK: Karplus-Strong loop vs a plain saw voice
+// ==========================================
+void benchmarkPluck() {
+    static float block[BENCH_BLOCK];
+    static PluckString string;
+    if (!string.begin()) {
+        Serial.println("[BENCH] Pluck: no internal RAM for the ring");
+        return;
+    }
+    static SawWave saw;
+    static Voice voice;
+    voice = Voice(&saw, 0.0f, 0.0f);
+    voice.noteOn(220.0f, 0.5f);
+
+    const float pitches[] = {55.0f, 440.0f, 3520.0f};
+    const double budget = (double)cycleCounterMHz() * 1e6 / SAMPLE_RATE;
+    for (float hz : pitches) {
+        string.pluck();
+        string.prepare(hz);     // Tunes and writes the noise burst, outside the timing
+
+        uint64_t cycles = 0;
+        for (int b = 0; b < BENCH_BLOCKS; b++) {
+            uint32_t start = readCycleCounter();
+            string.render(block, BENCH_BLOCK, 0.5f);
+            cycles += readCycleCounter() - start;
+        }
+        benchSink = block[0];
+
+        double perSample = (double)cycles / (BENCH_BLOCK * BENCH_BLOCKS);
+        Serial.printf("[BENCH] Pluck %5.0f Hz: %.1f cyc/sample per voice, %d voices per core\n",
+                      hz, perSample, (int)(budget / perSample));
+    }
+
+    uint64_t sawCycles = 0;
+    for (int b = 0; b < BENCH_BLOCKS; b++) {
+        uint32_t start = readCycleCounter();
+        voice.render(block, BENCH_BLOCK);
+        sawCycles += readCycleCounter() - start;
+    }
+    benchSink = block[0];
+    Serial.printf("[BENCH] Saw voice (reference): %.1f cyc/sample\n",
+                  (double)sawCycles / (BENCH_BLOCK * BENCH_BLOCKS));
+}
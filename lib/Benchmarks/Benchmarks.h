@@ -0,0 +1,20 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+/**
+ * On-device DSP benchmarks
+ *
+ * Only called when built with -D EDULAB_BENCHMARKS (pio run -e esp32-s3-bench).
+ * Results are printed over Serial in cycles, measured with the CPU cycle
+ * counter on the UI core while the audio task keeps running on Core 0.
+ */
+void runBenchmarks();
+
+void benchmarkWavetable();
+void benchmarkAdpcm();
+void benchmarkFft();
+void benchmarkOscillators();
+void benchmarkFm();
+void benchmarkPluck();
+
+#endif
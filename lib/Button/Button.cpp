@@ -1,13 +1,19 @@
 #include "Button.h"
+#include "UiEvents.h"
+#include "Profiler.h"
 #include <Arduino.h>
 
 // ==========================================
 // 2. CLASS: BUTTON WITH SHORT/LONG PRESS DETECTION
 //===========================================
+// Edges are timestamped by the ISR, which also wakes the UI task.
+// Debounce = a new level is accepted once the pin has been quiet for DEBOUNCE_TIME.
 
     Button::Button(int p, unsigned long longPressTime) {
       pin = p;
       longPressThreshold = longPressTime;
+      lastEdgeTime = 0;
+      stableReading = HIGH;
       wasPressed = false;
       longPressHandled = false;
       longPressTriggered = false;
@@ -17,35 +23,61 @@
 
     void Button:: begin() {
     pinMode(pin, INPUT_PULLUP);
+    stableReading = digitalRead(pin);
+    attachInterruptArg(digitalPinToInterrupt(pin), handleInterrupt, this, CHANGE);
 }
 
+    void IRAM_ATTR Button::handleInterrupt(void* arg) {
+      PROFILE_SCOPE("Button ISR");
+      Button* button = static_cast<Button*>(arg);
+      button->lastEdgeTime = millis();
+      UiEvents::signalFromISR(UiEvents::BUTTON);
+    }
+
     void Button::update() {
+      PROFILE_SCOPE("Button::update");
+      unsigned long now = millis();
       int reading = digitalRead(pin);
-      if (reading == LOW && !wasPressed) {
-        delay(10); // Debounce
-        reading = digitalRead(pin);
+
+      if (reading != stableReading && now - lastEdgeTime >= DEBOUNCE_TIME) {
+        stableReading = reading;
+
         if (reading == LOW) {
-            wasPressed = true;
-        pressStartTime = millis();
-        longPressHandled = false;
-        longPressTriggered = false;
-        shortPressReady = false;
+          wasPressed = true;
+          pressStartTime = now;
+          longPressHandled = false;
+          longPressTriggered = false;
+          shortPressReady = false;
+        } else if (wasPressed) {
+          wasPressed = false;
+          if (!longPressHandled) {
+            shortPressReady = true;
+          }
         }
       }
 
-      if (wasPressed && reading == LOW) {
-        if ((millis() - pressStartTime > longPressThreshold) && !longPressHandled) {
+      if (wasPressed && !longPressHandled) {
+        if (now - pressStartTime > longPressThreshold) {
           longPressHandled = true;
           longPressTriggered = true;
         }
       }
-      
-      if (reading == HIGH && wasPressed) {
-        wasPressed = false;
-        if (!longPressHandled) {
-          shortPressReady = true;
-        }
+    }
+
+    unsigned long Button::msUntilDeadline(unsigned long now) const {
+      // Level changed but still settling: come back when the debounce window ends
+      if (digitalRead(pin) != stableReading) {
+        unsigned long elapsed = now - lastEdgeTime;
+        return (elapsed >= DEBOUNCE_TIME) ? 0 : DEBOUNCE_TIME - elapsed;
+      }
+
+      // Held down: come back when it becomes a long press
+      if (wasPressed && !longPressHandled) {
+        unsigned long elapsed = now - pressStartTime;
+        return (elapsed > longPressThreshold) ? 0 : longPressThreshold - elapsed + 1;
       }
+
+      return UiEvents::NO_DEADLINE;
     }
   
     bool Button::wasShortPressed() {
@@ -66,4 +98,4 @@
 
     bool Button::isPressed() {
       return wasPressed;
-    }
\ No newline at end of file
+    }
@@ -9,21 +9,30 @@ class Button
         int pin;
         unsigned long pressStartTime;
         unsigned long longPressThreshold;
+        volatile unsigned long lastEdgeTime;   // written by the ISR
+        int stableReading;                     // debounced pin level
         bool wasPressed;           // state tracking
         bool longPressHandled;
         bool longPressTriggered;
         bool shortPressReady;
 
+        static const unsigned long DEBOUNCE_TIME = 10;  // ms the pin must be quiet
+
+        static void IRAM_ATTR handleInterrupt(void* arg);
+
     public:
         Button(int p, unsigned long longPressTime = 800);
-        void begin();                   // initializes the pin
-        void update();                  // reads the pin and updates state
+        void begin();                   // initializes the pin and edge interrupt
+        void update();                  // non-blocking: reads the pin and updates state
         bool wasShortPressed();         // returns true once if there was a short press
         bool wasLongPressed();          // returns true once if there was a long press
         bool isPressed();               // returns the current state
+
+        // ms until update() has work to do without a new edge (debounce / long press)
+        unsigned long msUntilDeadline(unsigned long now) const;
 };
 
 
 
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,87 @@
+#include "Console.h"
+#include "Log.h"
+#include <string.h>
+
+Console::Command Console::commands[MAX_COMMANDS];
+int Console::commandCount = 0;
+TaskHandle_t Console::taskHandle = nullptr;
+
+void Console::begin(UBaseType_t priority, BaseType_t core) {
+    if (taskHandle) {
+        return;
+    }
+    xTaskCreatePinnedToCore(task, "Console", 3072, nullptr, priority, &taskHandle, core);
+}
+
+bool Console::addCommand(const char* name, const char* help, Handler handler) {
+    if (commandCount >= MAX_COMMANDS) {
+        LOG("[CON] Command table full, '%s' not added", name);
+        return false;
+    }
+
+    commands[commandCount].name = name;
+    commands[commandCount].help = help;
+    commands[commandCount].handler = handler;
+    commandCount++;
+    return true;
+}
+
+void Console::task(void*) {
+    char line[LINE_LENGTH];
+    int length = 0;
+
+    while (true) {
+        while (Serial.available() > 0) {
+            int c = Serial.read();
+
+            if (c == '\r' || c == '\n') {
+                if (length > 0) {
+                    line[length] = '\0';
+                    execute(line);
+                    length = 0;
+                }
+            } else if ((c == '\b' || c == 0x7F) && length > 0) {
+                length--;
+            } else if (c >= ' ' && length < LINE_LENGTH - 1) {
+                line[length++] = (char)c;
+            }
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(POLL_INTERVAL_MS));
+    }
+}
+
+void Console::execute(char* line) {
+    char* argv[MAX_ARGS];
+    int argc = 0;
+
+    char* save = nullptr;
+    for (char* token = strtok_r(line, " ", &save); token && argc < MAX_ARGS;
+         token = strtok_r(nullptr, " ", &save)) {
+        argv[argc++] = token;
+    }
+    if (argc == 0) {
+        return;
+    }
+
+    if (strcmp(argv[0], "help") == 0) {
+        printHelp();
+        return;
+    }
+
+    for (int i = 0; i < commandCount; i++) {
+        if (strcmp(argv[0], commands[i].name) == 0) {
+            commands[i].handler(argc, argv);
+            return;
+        }
+    }
+
+    Serial.printf("Unknown command '%s' - type 'help'\n", argv[0]);
+}
+
+void Console::printHelp() {
+    Serial.println("Commands:");
+    for (int i = 0; i < commandCount; i++) {
+        Serial.printf("  %-8s %s\n", commands[i].name, commands[i].help);
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/**
+ * Serial command console
+ *
+ * A low-priority task on Core 1 collects characters from Serial into a
+ * fixed line buffer and, on Enter, splits the line on spaces and runs the
+ * matching command. Modules register their own commands at startup:
+ *
+ *   Console::addCommand("mem", "heap, PSRAM and stack report", memCommand);
+ *
+ * Handlers run on the console task and print their reply directly with
+ * Serial.printf; they must not block for long. "help" lists all commands.
+ */
+class Console {
+public:
+    typedef void (*Handler)(int argc, char** argv);
+
+    static const int MAX_COMMANDS = 16;
+    static const int MAX_ARGS = 6;
+    static const int LINE_LENGTH = 64;
+    static const uint32_t POLL_INTERVAL_MS = 20;
+
+private:
+    struct Command {
+        const char* name;
+        const char* help;
+        Handler handler;
+    };
+
+    static Command commands[MAX_COMMANDS];
+    static int commandCount;
+    static TaskHandle_t taskHandle;
+
+public:
+    static void begin(UBaseType_t priority = 1, BaseType_t core = 1);
+
+    // name and help must be string literals (only the pointers are kept)
+    static bool addCommand(const char* name, const char* help, Handler handler);
+
+    static TaskHandle_t getTask() { return taskHandle; }
+
+private:
+    static void task(void* parameter);
+    static void execute(char* line);
+    static void printHelp();
+};
+
+#endif
@@ -1,6 +1,10 @@
 #include "DisplayManager.h"
 #include "StateMachine.h" 
 #include "Menu.h"                  
+#include "UiEvents.h"
+#include "Log.h"
+#include "AllocCounter.h"
+#include "Profiler.h"
 
 //constants
 #define SCREEN_WIDTH 128
@@ -12,35 +16,109 @@
 
 //constructor
 DisplayManager::DisplayManager() 
-    : display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET), lastUpdateTime(0) {
+    : display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET), lastUpdateTime(0),
+      shownState(-1), shownMenuIndex(-1), shownMode(-1), shownFrequency(-1), shownView(-1), redrawPending(false),
+      scope(nullptr), liveView(false), ready(false) {
+    frequencyField.value = -1;
+    frequencyField.text[0] = '\0';
+    frequencyField.x = 0;
 }
 
-void DisplayManager::begin() {
+bool DisplayManager::begin() {
     Wire.begin(I2C_SDA, I2C_SCL);
+    Wire.setTimeOut(20);
+
+    // display.begin() doesn't check for an ACK, so probe the address first.
+    // A missing OLED must not stop the synth: run headless instead.
+    Wire.beginTransmission(SCREEN_ADDRESS);
+    if (Wire.endTransmission() != 0) {
+        LOG("[DISP] No OLED at 0x%02x - running headless", SCREEN_ADDRESS);
+        return false;
+    }
+
     if (!display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
-        for (;;);
+        LOG("[DISP] SSD1306 init failed - running headless");
+        return false;
     }
     
+    muteLabel = centered("MUTE", 2);
+    menuTitle = centered("- SELECT MODE -", 1);
+    Menu menu;
+    for (int i = 0; i < Menu::ITEM_COUNT; i++) {
+        menuItems[i] = centered(menu.getItem(i), 2);
+    }
+
     display.clearDisplay();
     display.setTextColor(SSD1306_WHITE);
-    drawCenteredText("eduLAB", 8, 2);    
-    drawCenteredText("v3.8 OOP", 24, 1);   
+    drawText(centered("eduLAB", 2), 8);
+    drawText(centered("v3.8 OOP", 1), 24);
     display.display();
-    delay(2000);
+    delay(SPLASH_TIME);
     display.clearDisplay();
     
     renderMuted();
+
+    ready.store(true);
+    return true;
+}
+
+void DisplayManager::beginAsync(UBaseType_t priority, BaseType_t core) {
+    xTaskCreatePinnedToCore(initTask, "DisplayInit", 4096, this, priority, nullptr, core);
+}
+
+void DisplayManager::initTask(void* parameter) {
+    DisplayManager* self = static_cast<DisplayManager*>(parameter);
+
+    if (self->begin()) {
+        LOG("[DISP] Ready at %lu ms", (unsigned long)millis());
+        UiEvents::signal(UiEvents::DISPLAY);   // Draw the current screen
+    }
+
+    vTaskDelete(nullptr);
 }
 
 void DisplayManager::update(const StateMachine& stateMachine, int frequency) {
+    PROFILE_SCOPE("DisplayManager::update");
+
+    if (!ready.load()) {
+        return;
+    }
+
+    StateMachine::State currentState = stateMachine.getState();
+    const Menu& menu = stateMachine.getMenu();
+    int view = stateMachine.getPlayView();
+
+    liveView = scope && currentState == StateMachine::PLAYING && view != StateMachine::VIEW_INFO;
+
+    bool changed = currentState != shownState ||
+                   menu.getCurrentIndex() != shownMenuIndex ||
+                   menu.getSelectedMode() != shownMode ||
+                   frequency != shownFrequency ||
+                   view != shownView ||
+                   (liveView && scope->hasNew());
+    if (!changed) {
+        redrawPending = false;  // A held-back change was undone before its frame
+        if (liveView && millis() - lastUpdateTime >= UPDATE_INTERVAL) {
+            lastUpdateTime = millis();  // No new frame (audio parked): poll again a frame later
+        }
+        return;
+    }
+
     if(millis() - lastUpdateTime < UPDATE_INTERVAL) {
+        redrawPending = true;   // loop() wakes up again via msUntilNextFrame()
         return;
     }
     lastUpdateTime = millis();
+    redrawPending = false;
 
-    display.clearDisplay();
+    shownState = currentState;
+    shownMenuIndex = menu.getCurrentIndex();
+    shownMode = menu.getSelectedMode();
+    shownFrequency = frequency;
+    shownView = view;
 
-    StateMachine::State currentState = stateMachine.getState();
+    uint32_t allocsBefore = AllocCounter::getWatched();
+    display.clearDisplay();
     
     if (currentState == StateMachine::MUTE) {
         renderMuted();
@@ -48,22 +126,39 @@ void DisplayManager::update(const StateMachine& stateMachine, int frequency) {
     else if (currentState == StateMachine::MENU) {
         renderMenu(stateMachine.getMenu());
     } 
+    else if (liveView && view == StateMachine::VIEW_SCOPE) {
+        renderScope(scope->latest());
+    }
+    else if (liveView) {
+        renderSpectrum(scope->latest());
+    }
     else { // PLAYING
         renderPlaying(stateMachine.getMenu().getSelectedMode(), frequency);
     }
     display.display();
+    ALLOC_CHECK_NONE_SINCE(allocsBefore, "[DISP] Frame");
+}
+
+unsigned long DisplayManager::msUntilNextFrame(unsigned long now) const {
+    // Live views poll for frames: the audio task doesn't notify the UI
+    if ((!redrawPending && !liveView) || !ready.load()) {
+        return UiEvents::NO_DEADLINE;
+    }
+
+    unsigned long elapsed = now - lastUpdateTime;
+    return (elapsed >= UPDATE_INTERVAL) ? 0 : UPDATE_INTERVAL - elapsed;
 }
 
 void DisplayManager::renderMuted() {
     display.fillRect(0, 0, 128, 32, SSD1306_WHITE);
     display.setTextColor(SSD1306_BLACK);
-    drawCenteredText("MUTE", 9, 2);
+    drawText(muteLabel, 9);
     display.setTextColor(SSD1306_WHITE);
 }
 
 void DisplayManager::renderMenu(const Menu& menu) {
-    drawCenteredText("- SELECT MODE -", 0, 1);
-    drawCenteredText(menu.getCurrentItem(), 12, 2);
+    drawText(menuTitle, 0);
+    drawText(menuItems[menu.getCurrentIndex()], 12);
     display.fillTriangle(4, 20, 10, 14, 10, 26, SSD1306_WHITE);
     display.fillTriangle(124, 20, 118, 14, 118, 26, SSD1306_WHITE);
     
@@ -82,23 +177,20 @@ void DisplayManager::renderPlaying(int selectedMode, int frequency) {
     display.setCursor(0, 0);
     
     
-    const char* modeNames[] = {"SIN", "TRIANGLE", "SQUARE", "SAW", "NOISE"};
-    if (selectedMode >= 0 && selectedMode < 5 ) {
+    const char* modeNames[] = {"SIN", "TRIANGLE", "SQUARE", "SAW", "NOISE", "WTABLE", "SAMPLE", "SUPSAW", "FM", "PLUCK"};
+    if (selectedMode >= 0 && selectedMode < Menu::ITEM_COUNT) {
         display.print(modeNames[selectedMode]);
     }
     
-    String freqStr = String(frequency) + " Hz";
-    int16_t x1, y1; 
-    uint16_t w, h;
-    display.getTextBounds(freqStr, 0, 0, &x1, &y1, &w, &h);
-    display.setCursor(128 - w, 0); 
-    display.print(freqStr);
+    setNumber(frequencyField, frequency, " Hz");
+    display.setCursor(frequencyField.x, 0);
+    display.print(frequencyField.text);
     
     drawWaveIcon(selectedMode, 2, 14); 
     
     display.drawRect(30, 14, 90, 14, SSD1306_WHITE);
     
-    int maxFreq = (selectedMode == Menu::NOISE) ? 5000 : 20000;
+    int maxFreq = (selectedMode == Menu::NOISE || selectedMode == Menu::PLUCK) ? 5000 : 20000;
     int barW = map(frequency, 350, maxFreq, 0, 86);
     if (barW < 0) barW = 0;
     if (barW > 86) barW = 86;
@@ -106,14 +198,104 @@ void DisplayManager::renderPlaying(int selectedMode, int frequency) {
     display.fillRect(32, 16, barW, 10, SSD1306_WHITE);  
 }
 
-void DisplayManager::drawCenteredText(const String& text, int y, int size) {
+void DisplayManager::renderScope(const ScopeTap::Frame& frame) {
+    // Trigger on the first rising zero crossing so periodic waves stand
+    // still; free-run if there is none in the first half of the frame
+    const int traceLength = SCREEN_WIDTH;
+    int trigger = 0;
+    for (int i = 1; i < ScopeTap::SAMPLES - traceLength; i++) {
+        if (frame.samples[i - 1] < 0 && frame.samples[i] >= 0) {
+            trigger = i;
+            break;
+        }
+    }
+
+    const int mid = SCREEN_HEIGHT / 2;
+    int previousY = mid;
+    for (int x = 0; x < traceLength; x++) {
+        // Full scale (+-32768) maps onto +-16 px
+        int y = mid - (frame.samples[trigger + x] >> 11);
+        if (y < 0) y = 0;
+        if (y > SCREEN_HEIGHT - 1) y = SCREEN_HEIGHT - 1;
+
+        if (x == 0) {
+            display.drawPixel(x, y, SSD1306_WHITE);
+        } else {
+            display.drawLine(x - 1, previousY, x, y, SSD1306_WHITE);
+        }
+        previousY = y;
+    }
+
+    for (int x = 0; x < SCREEN_WIDTH; x += 4) {
+        display.drawPixel(x, mid, SSD1306_WHITE);      // Dotted zero line
+    }
+
+    display.setTextSize(1);
+    display.setCursor(0, 0);
+    display.print("SCOPE");
+}
+
+void DisplayManager::renderSpectrum(const ScopeTap::Frame& frame) {
+    for (int i = 0; i < FixedFft::SIZE; i++) {
+        fftRe[i] = frame.samples[i];
+        fftIm[i] = 0;
+    }
+    fft.applyWindow(fftRe);
+    fft.transform(fftRe, fftIm);
+
+    // 128 bins up to 11 kHz, folded into 64 bars of 2 px (peak of each pair).
+    // Height is logarithmic: 6 dB per 2 px, bottom at 1/SIZE of full scale.
+    const int binsPerBar = FixedFft::BINS / SPECTRUM_BINS;
+    for (int bar = 0; bar < SPECTRUM_BINS; bar++) {
+        uint16_t peak = 0;
+        for (int b = 0; b < binsPerBar; b++) {
+            int bin = bar * binsPerBar + b;
+            uint16_t m = FixedFft::magnitude(fftRe[bin], fftIm[bin]);
+            if (m > peak) peak = m;
+        }
+
+        if (peak == 0) {
+            continue;
+        }
+        int height = (int)(log2f((float)peak) * 2.0f);
+        if (height > SCREEN_HEIGHT) height = SCREEN_HEIGHT;
+        display.fillRect(bar * 2, SCREEN_HEIGHT - height, 1, height, SSD1306_WHITE);
+    }
+
+    display.setTextSize(1);
+    display.setCursor(SCREEN_WIDTH - 24, 0);
+    display.print("FFT");
+}
+
+DisplayManager::TextLayout DisplayManager::centered(const char* text, int size) {
     display.setTextSize(size);
     int16_t x1, y1; 
     uint16_t w, h;
     display.getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
-    int x = (SCREEN_WIDTH - w) / 2;
-    display.setCursor(x, y);
-    display.print(text);
+
+    TextLayout layout = { text, (int16_t)((SCREEN_WIDTH - w) / 2), (uint8_t)size };
+    return layout;
+}
+
+void DisplayManager::drawText(const TextLayout& layout, int y) {
+    display.setTextSize(layout.size);
+    display.setCursor(layout.x, y);
+    display.print(layout.text);
+}
+
+void DisplayManager::setNumber(NumberField& field, int value, const char* unit) {
+    if (value == field.value) {
+        return;
+    }
+    field.value = value;
+    snprintf(field.text, sizeof(field.text), "%d%s", value, unit);
+
+    // Size 1 text; measured only when the value changes
+    display.setTextSize(1);
+    int16_t x1, y1;
+    uint16_t w, h;
+    display.getTextBounds(field.text, 0, 0, &x1, &y1, &w, &h);
+    field.x = SCREEN_WIDTH - w;
 }
 
 void DisplayManager::drawWaveIcon(int mode, int x, int y) {
@@ -156,5 +338,53 @@ void DisplayManager::drawWaveIcon(int mode, int x, int y) {
                 display.drawLine(x+i, y+offset, x+i, y+offset+h, color);
             } 
             break;
+
+        case Menu::WAVETABLE:
+            // Stacked frames: sine in front, saw behind
+            for(int i=0; i<14; i++) {
+                int y1 = y + 7 + (int)(3.0 * sin((i / 14.0) * 6.28));
+                int y2 = y + 7 + (int)(3.0 * sin(((i+1) / 14.0) * 6.28));
+                display.drawLine(x+i, y1, x+i+1, y2, color);
+            }
+            display.drawLine(x+6, y+6, x+18, y, color);
+            display.drawLine(x+18, y, x+18, y+6, color);
+            break;
+
+        case Menu::SUPERSAW:
+            // Three saws, each slightly out of step with the one before
+            for(int k=0; k<3; k++) {
+                int dx = k * 2;
+                display.drawLine(x+dx, y+10-k, x+9+dx, y+2-k, color);
+                display.drawLine(x+9+dx, y+2-k, x+9+dx, y+10-k, color);
+            }
+            break;
+
+        case Menu::FM:
+            // Carrier squeezed by a modulator: the period shrinks then grows
+            for(int i=0; i<19; i++) {
+                float p1 = (i / 19.0) * 6.28, p2 = ((i+1) / 19.0) * 6.28;
+                int y1 = y + 6 + (int)(5.0 * sin(2 * p1 + 1.5 * sin(p1)));
+                int y2 = y + 6 + (int)(5.0 * sin(2 * p2 + 1.5 * sin(p2)));
+                display.drawLine(x+i, y1, x+i+1, y2, color);
+            }
+            break;
+
+        case Menu::PLUCK:
+            // Ringing string: a sine dying away
+            for(int i=0; i<19; i++) {
+                float a1 = 5.0 * exp(-i / 7.0), a2 = 5.0 * exp(-(i+1) / 7.0);
+                int y1 = y + 6 + (int)(a1 * sin((i / 5.0) * 6.28));
+                int y2 = y + 6 + (int)(a2 * sin(((i+1) / 5.0) * 6.28));
+                display.drawLine(x+i, y1, x+i+1, y2, color);
+            }
+            break;
+
+        case Menu::SAMPLE:
+            // Decaying hit: envelope of a recorded sample
+            for(int i=0; i<20; i+=2) {
+                int h = 10 - i / 2;
+                display.drawLine(x+i, y+6-h/2, x+i, y+6+h/2, color);
+            }
+            break;
     }
 }
\ No newline at end of file
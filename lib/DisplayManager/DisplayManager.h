@@ -5,9 +5,13 @@
 #include <Wire.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
+#include <atomic>
+#include "Scope/ScopeTap.h"
+#include "Scope/FixedFft.h"
+
+#include "Menu.h"
 
 class StateMachine;
-class Menu;
 
 class DisplayManager {
 private:
@@ -15,18 +19,69 @@ private:
     unsigned long lastUpdateTime;
     static const unsigned long UPDATE_INTERVAL = 50;
 
+    // What is currently on screen; only redraw when it changes
+    int shownState;
+    int shownMenuIndex;
+    int shownMode;
+    int shownFrequency;
+    int shownView;
+    bool redrawPending;     // change seen but held back by UPDATE_INTERVAL
+
+    // Live views (scope/spectrum) redraw on every new frame from the audio
+    // task, still at most once per UPDATE_INTERVAL
+    ScopeTap* scope;
+    bool liveView;
+    FixedFft fft;
+    int16_t fftRe[FixedFft::SIZE];
+    int16_t fftIm[FixedFft::SIZE];
+    static const int SPECTRUM_BINS = 64;
+
+    // Text layout, computed once: rendering a frame never measures text
+    // or builds a String, so the UI task does no heap allocation
+    struct TextLayout {
+        const char* text;
+        int16_t x;
+        uint8_t size;
+    };
+    TextLayout muteLabel;
+    TextLayout menuTitle;
+    TextLayout menuItems[Menu::ITEM_COUNT];
+
+    // Numeric fields are reformatted only when their value changes
+    struct NumberField {
+        int value;
+        char text[12];
+        int16_t x;          // Right-aligned
+    };
+    NumberField frequencyField;
+
+    // Set once the OLED is initialised and the splash is done.
+    // Until then (or forever, if no OLED answers) update() does nothing.
+    std::atomic<bool> ready;
+    static const unsigned long SPLASH_TIME = 2000;
+
 public:
     DisplayManager();
-    void begin();
+    bool begin();                                       // Blocking: I2C + OLED + splash
+    void beginAsync(UBaseType_t priority, BaseType_t core);  // Same, on its own task
+    bool isReady() const { return ready.load(); }
     void update(const StateMachine& stateMachine, int frequency);
+    unsigned long msUntilNextFrame(unsigned long now) const;  // for the UI wake-up deadline
+    void setScope(ScopeTap* tap) { scope = tap; }
     
 private:
+    static void initTask(void* parameter);
+
     void renderMuted();
     void renderMenu(const Menu& menu);
     
     void renderPlaying(int selectedMode, int frequency);
+    void renderScope(const ScopeTap::Frame& frame);
+    void renderSpectrum(const ScopeTap::Frame& frame);
     
-    void drawCenteredText(const String& text, int y, int size);
+    TextLayout centered(const char* text, int size);
+    void drawText(const TextLayout& layout, int y);
+    void setNumber(NumberField& field, int value, const char* unit);
     void drawWaveIcon(int mode, int x, int y);
 };
 
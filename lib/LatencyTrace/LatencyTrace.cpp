@@ -0,0 +1,137 @@
+#include "LatencyTrace.h"
+#include "Console.h"
+#include "esp_timer.h"
+#include "../../include/Consts.h"
+
+std::atomic<uint32_t> LatencyTrace::pending(0);
+uint32_t LatencyTrace::blockTag = 0;
+LatencyTrace::Stats LatencyTrace::render[SOURCE_COUNT];
+LatencyTrace::Stats LatencyTrace::sound[SOURCE_COUNT];
+uint32_t LatencyTrace::histogram[BUCKETS + 1];
+
+static const char* const SOURCE_NAMES[LatencyTrace::SOURCE_COUNT] = {"all", "pot", "encoder", "button"};
+
+// Tags keep microseconds in the top 30 bits (wraps after ~17 minutes,
+// far longer than any latency) and the source in the bottom 2
+static inline uint32_t nowTag() {
+    return (uint32_t)esp_timer_get_time() << 2;
+}
+
+void LatencyTrace::begin() {
+    reset();
+    Console::addCommand("lat", "control-to-sound latency histogram (lat reset)", latCommand);
+}
+
+void LatencyTrace::mark(Source source) {
+    // Keep the oldest untraced input; later ones ride on the same block
+    uint32_t expected = 0;
+    pending.compare_exchange_strong(expected, nowTag() | source, std::memory_order_release,
+                                    std::memory_order_relaxed);
+}
+
+void LatencyTrace::beginBlock() {
+    if (pending.load(std::memory_order_relaxed) != 0) {
+        blockTag = pending.exchange(0, std::memory_order_acquire);
+    }
+}
+
+void LatencyTrace::endBlock(uint32_t queuedFrames) {
+    if (blockTag == 0) {
+        return;
+    }
+    uint32_t renderUs = (nowTag() - (blockTag & ~3u)) >> 2;
+    uint32_t soundUs = renderUs + (uint32_t)((uint64_t)queuedFrames * 1000000 / SAMPLE_RATE);
+    int source = blockTag & 3;
+    blockTag = 0;
+
+    record(render[0], renderUs);
+    record(render[source], renderUs);
+    record(sound[0], soundUs);
+    record(sound[source], soundUs);
+
+    uint32_t bucket = soundUs / BUCKET_US;
+    histogram[bucket < BUCKETS ? bucket : BUCKETS]++;
+}
+
+void LatencyTrace::record(Stats& stats, uint32_t us) {
+    if (stats.count == 0 || us < stats.minUs) {
+        stats.minUs = us;
+    }
+    if (us > stats.maxUs) {
+        stats.maxUs = us;
+    }
+    stats.sumUs += us;
+    stats.count++;
+}
+
+void LatencyTrace::reset() {
+    memset(render, 0, sizeof(render));
+    memset(sound, 0, sizeof(sound));
+    memset(histogram, 0, sizeof(histogram));
+}
+
+uint32_t LatencyTrace::percentile(uint32_t total, uint32_t permille) {
+    // Upper edge of the bucket holding the permille-th sample
+    uint64_t target = ((uint64_t)total * permille + 999) / 1000;
+    uint64_t seen = 0;
+    for (int b = 0; b <= BUCKETS; b++) {
+        seen += histogram[b];
+        if (seen >= target) {
+            return (b + 1) * BUCKET_US;
+        }
+    }
+    return (BUCKETS + 1) * BUCKET_US;
+}
+
+void LatencyTrace::report() {
+    uint32_t total = sound[0].count;
+    if (total == 0) {
+        Serial.println("lat: no inputs traced yet (move a pot, turn the encoder or press the button)");
+        return;
+    }
+
+    Serial.println("Control-to-sound latency (us)      render: to DMA      sound: to DAC");
+    Serial.println("  source     count     min     avg     max     min     avg     max");
+    for (int s = 0; s < SOURCE_COUNT; s++) {
+        const Stats& r = render[s];
+        const Stats& d = sound[s];
+        if (r.count == 0) {
+            continue;
+        }
+        Serial.printf("  %-8s %7lu %7lu %7lu %7lu %7lu %7lu %7lu\n", SOURCE_NAMES[s], (unsigned long)r.count,
+                      (unsigned long)r.minUs, (unsigned long)(r.sumUs / r.count), (unsigned long)r.maxUs,
+                      (unsigned long)d.minUs, (unsigned long)(d.sumUs / d.count), (unsigned long)d.maxUs);
+    }
+
+    uint32_t peak = 1;
+    for (int b = 0; b <= BUCKETS; b++) {
+        peak = max(peak, histogram[b]);
+    }
+    Serial.printf("Sound latency histogram (%lu us buckets):\n", (unsigned long)BUCKET_US);
+    for (int b = 0; b <= BUCKETS; b++) {
+        if (histogram[b] == 0) {
+            continue;
+        }
+        char bar[41];
+        int length = (int)((uint64_t)histogram[b] * 40 / peak);
+        memset(bar, '#', length);
+        bar[length] = '\0';
+        if (b < BUCKETS) {
+            Serial.printf("  %5lu-%-5lu %7lu %s\n", (unsigned long)(b * BUCKET_US),
+                          (unsigned long)((b + 1) * BUCKET_US), (unsigned long)histogram[b], bar);
+        } else {
+            Serial.printf("  %5lu+      %7lu %s\n", (unsigned long)(b * BUCKET_US), (unsigned long)histogram[b], bar);
+        }
+    }
+    Serial.printf("p50 <= %lu us, p95 <= %lu us, p99 <= %lu us\n", (unsigned long)percentile(total, 500),
+                  (unsigned long)percentile(total, 950), (unsigned long)percentile(total, 990));
+}
+
+void LatencyTrace::latCommand(int argc, char** argv) {
+    if (argc >= 2 && strcmp(argv[1], "reset") == 0) {
+        reset();
+        Serial.println("ok");
+        return;
+    }
+    report();
+}
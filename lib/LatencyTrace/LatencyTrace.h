@@ -0,0 +1,75 @@
+#ifndef LATENCYTRACE_H
+#define LATENCYTRACE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+/**
+ * Control-to-sound latency tracer
+ *
+ * Follows one input at a time from loop() to the DAC:
+ *
+ *   loop()       mark(source)        input handled, timestamp taken
+ *   audio task   beginBlock()        this block reads the controls: it
+ *                                    takes the pending mark as its tag
+ *   audio task   endBlock(queued)    block handed to the I2S DMA; queued
+ *                                    = frames ahead of its first sample
+ *
+ * Two figures per traced block:
+ *   render  mark -> block handed to DMA (UI wake-up, park, render, write)
+ *   sound   render + the DMA frames still to play before its first sample
+ *
+ * Timestamps are esp_timer microseconds: the cycle counters of the two
+ * cores are not synchronised, and mark() and endBlock() run on different
+ * cores. If several inputs arrive before a block picks them up, the
+ * oldest one is traced (it waited longest). Results go into a histogram of
+ * the sound latency and per-source min/avg/max; "lat" prints them.
+ *
+ * mark() is a single compare-exchange; beginBlock()/endBlock() cost a
+ * timer read only on traced blocks.
+ */
+class LatencyTrace {
+public:
+    enum Source : uint8_t {
+        POT = 1,
+        ENCODER,
+        BUTTON,
+        SOURCE_COUNT
+    };
+
+    static const int BUCKETS = 48;              // Histogram of the sound latency
+    static const uint32_t BUCKET_US = 500;      // 0 - 24 ms, then one overflow bucket
+
+    struct Stats {
+        uint32_t count;
+        uint32_t minUs;
+        uint32_t maxUs;
+        uint64_t sumUs;
+    };
+
+private:
+    // Pending mark: microseconds << 2 | source, 0 = none
+    static std::atomic<uint32_t> pending;
+    static uint32_t blockTag;                   // Audio task only
+
+    static Stats render[SOURCE_COUNT];
+    static Stats sound[SOURCE_COUNT];
+    static uint32_t histogram[BUCKETS + 1];
+
+public:
+    static void begin();                        // Registers the "lat" console command
+
+    static void mark(Source source);            // UI: an input was handled
+    static void beginBlock();                   // Audio task: block about to read the controls
+    static void endBlock(uint32_t queuedFrames);    // Audio task: block handed to the DMA
+
+    static void reset();                        // Console task; races only lose a sample
+    static void report();
+
+private:
+    static void record(Stats& stats, uint32_t us);
+    static uint32_t percentile(uint32_t total, uint32_t permille);
+    static void latCommand(int argc, char** argv);
+};
+
+#endif
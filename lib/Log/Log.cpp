@@ -0,0 +1,71 @@
+#include "Log.h"
+
+Log::Ring Log::rings[2];
+TaskHandle_t Log::drainTaskHandle = nullptr;
+
+void Log::begin(UBaseType_t priority, BaseType_t core) {
+    if (drainTaskHandle) {
+        return;
+    }
+    xTaskCreatePinnedToCore(drainTask, "LogDrain", 3072, nullptr, priority, &drainTaskHandle, core);
+}
+
+void IRAM_ATTR Log::push(const char* format, const uintptr_t* args, int count) {
+    // Masking interrupts on this core also stops task preemption here,
+    // so the ring has exactly one writer for the duration of the copy
+    uint32_t irqState = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    Ring& ring = rings[xPortGetCoreID()];
+    uint32_t head = ring.head.load(std::memory_order_relaxed);
+    uint32_t tail = ring.tail.load(std::memory_order_acquire);
+
+    if (head - tail >= RING_SIZE) {
+        ring.dropped++;
+    } else {
+        Entry& entry = ring.entries[head & (RING_SIZE - 1)];
+        entry.format = format;
+        for (int i = 0; i < MAX_ARGS; i++) {
+            entry.args[i] = (i < count) ? args[i] : 0;
+        }
+        ring.head.store(head + 1, std::memory_order_release);
+    }
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(irqState);
+}
+
+uint32_t Log::getDropped(int core) {
+    return (core >= 0 && core < 2) ? rings[core].dropped : 0;
+}
+
+void Log::drainOnce() {
+    static uint32_t reportedDropped[2] = {0, 0};
+
+    for (int core = 0; core < 2; core++) {
+        Ring& ring = rings[core];
+        uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+        uint32_t head = ring.head.load(std::memory_order_acquire);
+
+        while (tail != head) {
+            // Copy out first: the slot may be reused as soon as tail advances
+            Entry entry = ring.entries[tail & (RING_SIZE - 1)];
+            ring.tail.store(++tail, std::memory_order_release);
+
+            Serial.printf(entry.format, entry.args[0], entry.args[1], entry.args[2], entry.args[3]);
+            Serial.println();
+        }
+
+        uint32_t dropped = ring.dropped;
+        if (dropped != reportedDropped[core]) {
+            Serial.printf("[LOG] %lu messages dropped on core %d\n",
+                          (unsigned long)(dropped - reportedDropped[core]), core);
+            reportedDropped[core] = dropped;
+        }
+    }
+}
+
+void Log::drainTask(void*) {
+    while (true) {
+        drainOnce();
+        vTaskDelay(pdMS_TO_TICKS(DRAIN_INTERVAL_MS));
+    }
+}
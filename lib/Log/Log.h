@@ -0,0 +1,78 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <type_traits>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/**
+ * Deferred binary logger, safe from ISRs and the audio task
+ *
+ * LOG("[ENC] %s", "CW") stores only the format-string pointer (its id) and
+ * up to 4 raw 32-bit arguments into a ring buffer owned by the calling core.
+ * That takes a few dozen cycles and never touches the USB-CDC console.
+ * A low-priority task on Core 1 drains both rings and does the printf.
+ *
+ * Rules:
+ * - The format must be a string literal (only the pointer is stored)
+ * - Arguments: integers, enums, chars, or pointers to static strings.
+ *   Floats are rejected at compile time - scale them to integers first.
+ * - No trailing newline; the drain task adds it.
+ *
+ * Each ring is single-producer per core (interrupts are masked for the few
+ * cycles of the copy) and single-consumer (the drain task), so no locks are
+ * needed. When a ring is full the message is dropped and counted.
+ */
+class Log {
+public:
+    static const int MAX_ARGS = 4;
+    static const uint32_t RING_SIZE = 128;          // Entries per core (power of two)
+    static const uint32_t DRAIN_INTERVAL_MS = 20;
+
+private:
+    struct Entry {
+        const char* format;
+        uintptr_t args[MAX_ARGS];
+    };
+
+    struct Ring {
+        Entry entries[RING_SIZE];
+        std::atomic<uint32_t> head;     // written by the producing core
+        std::atomic<uint32_t> tail;     // written by the drain task
+        volatile uint32_t dropped;
+    };
+
+    static Ring rings[2];
+    static TaskHandle_t drainTaskHandle;
+
+public:
+    static void begin(UBaseType_t priority = 1, BaseType_t core = 1);
+
+    template<typename... Args>
+    static inline void write(const char* format, Args... args) {
+        static_assert(sizeof...(Args) <= MAX_ARGS, "LOG supports up to 4 arguments");
+        const uintptr_t packed[MAX_ARGS + 1] = { toArg(args)... };
+        push(format, packed, sizeof...(Args));
+    }
+
+    static uint32_t getDropped(int core);
+    static TaskHandle_t getDrainTask() { return drainTaskHandle; }
+
+private:
+    template<typename T>
+    static inline uintptr_t toArg(T value) {
+        static_assert(!std::is_floating_point<T>::value,
+                      "LOG cannot store floats - scale to an integer first");
+        return (uintptr_t)value;
+    }
+
+    static void IRAM_ATTR push(const char* format, const uintptr_t* args, int count);
+    static void drainOnce();
+    static void drainTask(void*);
+};
+
+#define LOG(format, ...) Log::write(format, ##__VA_ARGS__)
+
+#endif
@@ -2,11 +2,11 @@
 #include <Arduino.h>
 
     void Menu::nextItem() {
-        currentIndex = (currentIndex + 1) % 5;
+        currentIndex = (currentIndex + 1) % ITEM_COUNT;
     }
 
     void Menu::previousItem() {
-        currentIndex = (currentIndex - 1 + 5) % 5;
+        currentIndex = (currentIndex - 1 + ITEM_COUNT) % ITEM_COUNT;
     }
 
     void Menu::selectCurrentItem() {
@@ -26,12 +26,12 @@
     }
 
     const char* Menu::getItem(int index) const {
-        if (index >= 0 && index < 5) {
+        if (index >= 0 && index < ITEM_COUNT) {
             return items[index];
         }
         return "";
     }
 
     int Menu::getItemCount() const {
-        return 5;
+        return ITEM_COUNT;
     }
@@ -8,11 +8,18 @@ public:
     TRIANGLE = 1,
     SQUARE = 2,
     SAW = 3,
-    NOISE = 4
+    NOISE = 4,
+    WAVETABLE = 5,
+    SAMPLE = 6,
+    SUPERSAW = 7,
+    FM = 8,
+    PLUCK = 9
 };
+
+    static const int ITEM_COUNT = 10;
     
 private:
-    const char* items[5] = {"SINE", "TRIANGLE", "SQUARE", "SAW", "NOISE"};
+    const char* items[ITEM_COUNT] = {"SINE", "TRIANGLE", "SQUARE", "SAW", "NOISE", "WTABLE", "SAMPLE", "SUPSAW", "FM", "PLUCK"};
     int currentIndex;
     int selectedMode;
 
@@ -0,0 +1,87 @@
+#ifndef POTFILTER_H
+#define POTFILTER_H
+
+#include <stdint.h>
+
+/**
+ * Integer smoothing stage for potentiometer readings
+ *
+ * Fed with decimated ADC samples in Q4 format (12-bit ADC value << 4),
+ * produced by averaging an oversampled burst of conversions. The extra
+ * fractional bits keep the resolution gained by oversampling.
+ *
+ * Filter:     acc += x - acc / 2^shift   (EMA, alpha = 1 / 2^shift)
+ * Hysteresis: output only moves when the filtered value drifts more than
+ *             `threshold` ADC units away from the last published value.
+ *
+ * Header-only and free of Arduino dependencies, so it can be compiled on
+ * the host and fed with recorded ADC traces.
+ */
+class PotFilter {
+public:
+    static const int FRAC_BITS = 4;
+    static const int32_t MAX_VALUE = 4095;
+
+private:
+    int32_t accumulator;   // filtered value, Q(FRAC_BITS + shift)
+    uint8_t shift;
+    int32_t threshold;
+    int32_t stableValue;   // last published value (0-4095)
+    bool primed;
+
+public:
+    // Shift 3 (alpha = 1/8) at ~300 Hz decimated rate = ~25 ms time constant
+    PotFilter(uint8_t smoothingShift = 3, int hysteresis = 12)
+        : accumulator(0), shift(smoothingShift), threshold(hysteresis),
+          stableValue(0), primed(false) {}
+
+    /**
+     * Feed one decimated sample
+     *
+     * @param sampleQ4: Averaged ADC reading in Q4 (0 - 4095 << 4)
+     * @return true if the published value changed
+     */
+    bool push(int32_t sampleQ4) {
+        if (!primed) {
+            // First sample: start the filter at the input instead of ramping up from 0
+            accumulator = sampleQ4 << shift;
+            stableValue = filtered();
+            primed = true;
+            return true;
+        }
+
+        accumulator += sampleQ4 - (accumulator >> shift);
+
+        int32_t value = filtered();
+        int32_t delta = value - stableValue;
+        if (delta < 0) delta = -delta;
+
+        // Hysteresis check, but always let the endpoints through so the
+        // full range stays reachable
+        bool atEndpoint = (value == 0 || value == MAX_VALUE) && value != stableValue;
+        if (delta > threshold || atEndpoint) {
+            stableValue = value;
+            return true;
+        }
+        return false;
+    }
+
+    void reset() {
+        accumulator = 0;
+        stableValue = 0;
+        primed = false;
+    }
+
+    int value() const { return stableValue; }
+
+    // Filtered value with rounding, scaled back to 12 bits
+    int32_t filtered() const {
+        const int totalShift = shift + FRAC_BITS;
+        int32_t value = (accumulator + (1 << (totalShift - 1))) >> totalShift;
+        if (value < 0) return 0;
+        if (value > MAX_VALUE) return MAX_VALUE;
+        return value;
+    }
+};
+
+#endif
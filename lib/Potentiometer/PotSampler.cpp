@@ -0,0 +1,139 @@
+#include "PotSampler.h"
+#include "UiEvents.h"
+#include "Log.h"
+#include "Profiler.h"
+#include <Arduino.h>
+#include "driver/adc.h"
+#include "soc/soc_caps.h"
+
+PotSampler::PotSampler()
+    : potCount(0), taskHandle(nullptr), overruns(0) {
+    for (int i = 0; i < MAX_POTS; i++) {
+        pots[i] = nullptr;
+        channels[i] = 0;
+        sums[i] = 0;
+        counts[i] = 0;
+    }
+}
+
+bool PotSampler::attach(Potentiometer& pot) {
+    if (potCount >= MAX_POTS) {
+        return false;
+    }
+
+    // Continuous mode only scans ADC1 (GPIO1-10 on the S3)
+    int8_t channel = digitalPinToAnalogChannel(pot.getPin());
+    if (channel < 0 || channel >= SOC_ADC_MAX_CHANNEL_NUM) {
+        LOG("[POT] GPIO %d is not an ADC1 pin", pot.getPin());
+        return false;
+    }
+
+    pots[potCount] = &pot;
+    channels[potCount] = channel;
+    potCount++;
+    return true;
+}
+
+bool PotSampler::begin() {
+    if (potCount == 0) {
+        return false;
+    }
+
+    uint32_t channelMask = 0;
+    for (int i = 0; i < potCount; i++) {
+        channelMask |= (1 << channels[i]);
+    }
+
+    adc_digi_init_config_t init_config = {
+        .max_store_buf_size = FRAME_BYTES * 4,
+        .conv_num_each_intr = FRAME_BYTES,
+        .adc1_chan_mask = channelMask,
+        .adc2_chan_mask = 0
+    };
+    if (adc_digi_initialize(&init_config) != ESP_OK) {
+        LOG("[POT] ADC DMA init failed");
+        return false;
+    }
+
+    adc_digi_pattern_config_t pattern[MAX_POTS] = {};
+    for (int i = 0; i < potCount; i++) {
+        pattern[i].atten = ADC_ATTEN_DB_11;     // Full 0-3.3V pot swing
+        pattern[i].channel = channels[i];
+        pattern[i].unit = 0;                    // ADC1
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+
+    adc_digi_configuration_t digi_config = {
+        .conv_limit_en = false,
+        .conv_limit_num = 250,
+        .pattern_num = (uint32_t)potCount,
+        .adc_pattern = pattern,
+        .sample_freq_hz = SAMPLE_RATE_HZ,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = ADC_DIGI_OUTPUT_FORMAT_TYPE2
+    };
+    if (adc_digi_controller_configure(&digi_config) != ESP_OK) {
+        LOG("[POT] ADC DMA configure failed");
+        return false;
+    }
+
+    adc_digi_start();
+
+    // Core 1, above loop() so a busy UI can't starve the pots
+    xTaskCreatePinnedToCore(taskEntry, "PotSampler", 3072, this, 3, &taskHandle, 1);
+
+    LOG("[POT] Continuous ADC: %d channels @ %lu Hz, %dx oversampling",
+        potCount, (unsigned long)SAMPLE_RATE_HZ, OVERSAMPLE);
+    return true;
+}
+
+void PotSampler::taskEntry(void* parameter) {
+    static_cast<PotSampler*>(parameter)->run();
+}
+
+void PotSampler::run() {
+    uint8_t frame[FRAME_BYTES];
+
+    while (true) {
+        uint32_t length = 0;
+        // Blocks until the DMA has a full frame ready
+        esp_err_t result = adc_digi_read_bytes(frame, FRAME_BYTES, &length, portMAX_DELAY);
+
+        if (result == ESP_ERR_INVALID_STATE) {
+            // Driver pool overflowed; data is still valid, we just lost some
+            overruns++;
+        } else if (result != ESP_OK) {
+            continue;
+        }
+
+        consume(frame, length);
+    }
+}
+
+void PotSampler::consume(const uint8_t* data, uint32_t length) {
+    PROFILE_SCOPE("PotSampler::consume");
+
+    for (uint32_t offset = 0; offset + SOC_ADC_DIGI_RESULT_BYTES <= length;
+         offset += SOC_ADC_DIGI_RESULT_BYTES) {
+        const adc_digi_output_data_t* result = (const adc_digi_output_data_t*)&data[offset];
+        uint8_t channel = result->type2.channel;
+
+        for (int i = 0; i < potCount; i++) {
+            if (channels[i] != channel) {
+                continue;
+            }
+
+            sums[i] += result->type2.data;
+            if (++counts[i] >= OVERSAMPLE) {
+                // Average with FRAC_BITS of extra resolution
+                int32_t sampleQ4 = (int32_t)((sums[i] << PotFilter::FRAC_BITS) / counts[i]);
+                if (pots[i]->pushSample(sampleQ4)) {
+                    UiEvents::signal(UiEvents::POT);
+                }
+                sums[i] = 0;
+                counts[i] = 0;
+            }
+            break;
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef POTSAMPLER_H
+#define POTSAMPLER_H
+
+#include <Arduino.h>
+#include "Potentiometer.h"
+
+/**
+ * Background sampler for all potentiometers
+ *
+ * Runs the ESP32-S3 ADC1 in continuous (DMA) mode at a fixed rate, scanning
+ * every attached pot channel. A small task on core 1 drains the DMA results,
+ * averages OVERSAMPLE conversions per channel (oversampled decimation) and
+ * feeds the result to each Potentiometer's integer filter.
+ *
+ * This takes analogRead() off the UI loop entirely; the pots publish their
+ * filtered values atomically for the UI and audio cores.
+ */
+class PotSampler {
+public:
+    static const int MAX_POTS = 4;
+    static const uint32_t SAMPLE_RATE_HZ = 20000;   // Total conversions/s (all channels)
+    static const int OVERSAMPLE = 32;               // Conversions averaged per decimated sample
+    static const uint32_t FRAME_BYTES = 256;        // DMA bytes per interrupt (64 results)
+
+private:
+    Potentiometer* pots[MAX_POTS];
+    uint8_t channels[MAX_POTS];
+    uint32_t sums[MAX_POTS];
+    uint16_t counts[MAX_POTS];
+    int potCount;
+
+    TaskHandle_t taskHandle;
+    volatile uint32_t overruns;     // DMA pool overflows (samples lost)
+
+public:
+    PotSampler();
+
+    bool attach(Potentiometer& pot);   // Call before begin()
+    bool begin();                      // Configures ADC DMA and starts the sampler task
+
+    uint32_t getOverruns() const { return overruns; }
+    TaskHandle_t getTask() const { return taskHandle; }
+
+private:
+    static void taskEntry(void* parameter);
+    void run();
+    void consume(const uint8_t* data, uint32_t length);
+};
+
+#endif
@@ -1,38 +1,43 @@
 #include "Potentiometer.h"
+#include "Profiler.h"
 #include <Arduino.h>
 
 // ==========================================
-// 2. CLASS: SMOOTH POTENTIOMETER (EMA FILTER)
+// 2. CLASS: SMOOTH POTENTIOMETER (INTEGER EMA FILTER)
 // ==========================================
+// Samples arrive from PotSampler (ADC continuous mode), not from analogRead().
 
-    Potentiometer::Potentiometer(int p, float a, int th) { 
-      pin = p;
-      alpha = a;
-      threshold = th;
-      filteredValue = 0;
-      lastStableValue = 0;
+    Potentiometer::Potentiometer(int p, uint8_t smoothingShift, int th)
+      : pin(p), filter(smoothingShift, th), publishedValue(0), lastReadValue(0) {
     }
 
     void Potentiometer::begin() {
        pinMode(pin, INPUT);
-       filteredValue = analogRead(pin);
-       lastStableValue = filteredValue;
+       filter.reset();
     }
 
-    bool Potentiometer::update() {
-      int raw = analogRead(pin);
-      
-      // EMA Filter
-      filteredValue = (filteredValue * (1.0 - alpha)) + (raw * alpha);
+    bool Potentiometer::pushSample(int32_t sampleQ4) {
+      if (filter.push(sampleQ4)) {
+        publishedValue.store(filter.value(), std::memory_order_relaxed);
+        return true;
+      }
+      return false;
+    }
 
-      // Hysteresis Check
-      if (abs((int)filteredValue - lastStableValue) > threshold) {
-        lastStableValue = (int)filteredValue;
-        return true; 
+    bool Potentiometer::update() {
+      PROFILE_SCOPE("Potentiometer::update");
+      int value = publishedValue.load(std::memory_order_relaxed);
+      if (value != lastReadValue) {
+        lastReadValue = value;
+        return true;
       }
-      return false; 
+      return false;
     }
 
     int Potentiometer::getValue() const{
-      return lastStableValue;
+      return publishedValue.load(std::memory_order_relaxed);
+    }
+
+    int Potentiometer::getPin() const {
+      return pin;
     }
@@ -2,23 +2,28 @@
 #define POTENTIOMETER_H
 
 #include <Arduino.h>
+#include <atomic>
+#include "PotFilter.h"
 
-class Potentiometer 
+class Potentiometer
 {
     private:
         int pin;
-        float filteredValue;
-        float alpha; 
-        int lastStableValue;
-        int threshold; 
-    
+        PotFilter filter;                 // Only touched by the sampler task
+        std::atomic<int> publishedValue;  // Read by the UI and audio cores
+        int lastReadValue;                // UI-side change detection
+
     public:
-        // Alpha 0.15 = faster response
-        // Threshold 40 = more aggressive filtering of Breadboard noise
-        Potentiometer(int p, float a = 0.15, int th = 40); 
+        // Shift 3 = alpha 1/8 at the decimated rate (~300 Hz)
+        // Threshold 12 = oversampling removes most of the breadboard noise
+        Potentiometer(int p, uint8_t smoothingShift = 3, int th = 12);
         void begin();
-        bool update();
+        bool update();                    // Non-blocking: true if a new value was published
         int getValue() const;
+        int getPin() const;
+
+        // Called from the PotSampler task with an averaged Q4 sample
+        bool pushSample(int32_t sampleQ4);
     };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,126 @@
+#include "Profiler.h"
+
+#ifdef EDULAB_PROFILE
+
+#include "Console.h"
+#include "esp_timer.h"
+
+Profiler::Buffer Profiler::buffers[2];
+std::atomic<bool> Profiler::capturing(false);
+
+static const char* const CORE_NAMES[2] = {"core 0 (audio)", "core 1 (UI)"};
+
+void Profiler::begin() {
+    Console::addCommand("prof", "scope profiler: prof start | prof dump (Chrome trace JSON)", profCommand);
+}
+
+void IRAM_ATTR Profiler::push(const char* name, uint32_t start, uint32_t end) {
+    // Same single-writer scheme as Log::push: masking interrupts on this
+    // core also keeps other tasks on it out for the few stores
+    uint32_t irqState = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    Buffer& buffer = buffers[xPortGetCoreID()];
+    uint32_t index = buffer.count;
+    if (index < CAPACITY) {
+        if (index == 0) {
+            // This core's counter against the clock both cores share
+            buffer.anchorCycles = readCycleCounter();
+            buffer.anchorUs = esp_timer_get_time();
+        }
+        Event& event = buffer.events[index];
+        event.name = name;
+        event.start = start;
+        event.cycles = end - start;
+#ifdef EDULAB_SIM
+        event.closedUs = esp_timer_get_time();
+#endif
+        buffer.count = index + 1;
+    } else {
+        buffer.dropped++;
+    }
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(irqState);
+}
+
+void Profiler::start() {
+    // A scope closing on the other core right now may land in the old
+    // capture or the new one; races only lose an event
+    capturing.store(false, std::memory_order_relaxed);
+    for (int core = 0; core < 2; core++) {
+        buffers[core].count = 0;
+        buffers[core].dropped = 0;
+    }
+    capturing.store(true, std::memory_order_release);
+}
+
+void Profiler::stop() {
+    capturing.store(false, std::memory_order_release);
+}
+
+uint32_t Profiler::getCount(int core) {
+    return (core >= 0 && core < 2) ? buffers[core].count : 0;
+}
+
+void Profiler::writeTrace(Writer writer, void* context) {
+    stop();
+
+    char line[160];
+    writer("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", context);
+    writer("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"eduLAB\"}}", context);
+    for (int core = 0; core < 2; core++) {
+        const Buffer& buffer = buffers[core];
+        snprintf(line, sizeof(line),
+                 ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"%s\","
+                 "\"events\":%lu,\"dropped\":%lu}}",
+                 core, CORE_NAMES[core], (unsigned long)buffer.count, (unsigned long)buffer.dropped);
+        writer(line, context);
+    }
+
+    const uint64_t mhz = cycleCounterMHz();
+    for (int core = 0; core < 2; core++) {
+        const Buffer& buffer = buffers[core];
+        for (uint32_t i = 0; i < buffer.count; i++) {
+            const Event& event = buffer.events[i];
+            // Signed: a scope may have opened before the anchor was taken
+            int64_t offsetNs = (int64_t)(int32_t)(event.start - buffer.anchorCycles) * 1000 / (int64_t)mhz;
+            uint64_t startNs = (uint64_t)(buffer.anchorUs * 1000 + offsetNs);
+            uint64_t lengthNs = (uint64_t)event.cycles * 1000 / mhz;
+#ifdef EDULAB_SIM
+            startNs = (uint64_t)event.closedUs * 1000 - lengthNs;
+#endif
+            snprintf(line, sizeof(line),
+                     ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%llu.%03u,\"dur\":%llu.%03u}",
+                     event.name, core, (unsigned long long)(startNs / 1000), (unsigned)(startNs % 1000),
+                     (unsigned long long)(lengthNs / 1000), (unsigned)(lengthNs % 1000));
+            writer(line, context);
+        }
+    }
+    writer("\n]}\n", context);
+}
+
+static void serialWriter(const char* text, void*) {
+    Serial.print(text);
+}
+
+void Profiler::profCommand(int argc, char** argv) {
+    if (argc >= 2 && strcmp(argv[1], "start") == 0) {
+        start();
+        Serial.printf("prof: capturing up to %lu events per core\n", (unsigned long)CAPACITY);
+        return;
+    }
+    if (argc >= 2 && strcmp(argv[1], "dump") == 0) {
+        Serial.println("----- BEGIN TRACE -----");
+        writeTrace(serialWriter, nullptr);
+        Serial.println("----- END TRACE -----");
+        return;
+    }
+
+    Serial.printf("prof: %s\n", isCapturing() ? "capturing" : "stopped");
+    for (int core = 0; core < 2; core++) {
+        Serial.printf("  %-16s %5lu / %lu events, %lu dropped\n", CORE_NAMES[core],
+                      (unsigned long)buffers[core].count, (unsigned long)CAPACITY,
+                      (unsigned long)buffers[core].dropped);
+    }
+}
+
+#endif
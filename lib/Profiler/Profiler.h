@@ -0,0 +1,116 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+/**
+ * Scoped cycle profiler with Chrome trace export
+ *
+ *   void AudioEngine::fillBuffer() {
+ *       PROFILE_SCOPE("AudioEngine::fillBuffer");
+ *       ...
+ *
+ * A scope reads the cycle counter when it opens and again when it closes,
+ * then appends one complete event (name, start, length) to the buffer of
+ * the core it ran on. Like Log, each buffer has one writer at a time:
+ * interrupts are masked on that core for the few stores, so ISRs and
+ * tasks can both profile without locks. Nothing is recorded until a
+ * capture is started; it then runs until a core's buffer is full (the
+ * other core keeps going until its own is).
+ *
+ * Console ("prof"):
+ *   prof start     arm a capture (clears the previous one)
+ *   prof           capture status
+ *   prof dump      stop and print the capture as Chrome trace-event JSON
+ *                  between BEGIN/END TRACE lines; tools/trace_extract
+ *                  cuts it out of a monitor log for chrome://tracing or
+ *                  ui.perfetto.dev
+ *
+ * In the host simulator, --trace <file> captures from boot and writes the
+ * trace at exit. Code takes no virtual time there, so scopes are placed at
+ * the virtual time they closed, with their length in host nanoseconds.
+ *
+ * Each core has its own, unsynchronised cycle counter, so every core is
+ * anchored to esp_timer by its first event in a capture and shown as one
+ * thread (tid = core). Preemption nests: an ISR's scope sits inside the
+ * scope of the task it interrupted.
+ *
+ * Compiled in only with -D EDULAB_PROFILE. Otherwise PROFILE_SCOPE expands
+ * to nothing and the library is empty.
+ */
+#ifdef EDULAB_PROFILE
+
+#include <Arduino.h>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "../../include/CycleCounter.h"
+
+class Profiler {
+public:
+    static const uint32_t CAPACITY = 2048;         // Events per core (24 KB each on the S3)
+
+    // Output sink for writeTrace(): called once per line
+    typedef void (*Writer)(const char* text, void* context);
+
+    struct Event {
+        const char* name;       // String literal
+        uint32_t start;         // Cycle counter of the recording core
+        uint32_t cycles;
+#ifdef EDULAB_SIM
+        int64_t closedUs;       // Virtual time: the simulator's cycle counter is the host clock
+#endif
+    };
+
+private:
+    struct Buffer {
+        Event events[CAPACITY];
+        uint32_t count;
+        uint32_t dropped;       // Scopes that closed after the buffer filled
+        uint32_t anchorCycles;  // Taken with anchorUs by the first event
+        int64_t anchorUs;
+    };
+
+    static Buffer buffers[2];
+    static std::atomic<bool> capturing;
+
+public:
+    static void begin();                        // Registers the "prof" console command
+
+    static void start();
+    static void stop();
+    static bool isCapturing() { return capturing.load(std::memory_order_relaxed); }
+    static uint32_t getCount(int core);
+
+    static void writeTrace(Writer writer, void* context);   // Stops the capture first
+
+    static inline void record(const char* name, uint32_t start, uint32_t end) {
+        if (!capturing.load(std::memory_order_relaxed)) {
+            return;
+        }
+        push(name, start, end);
+    }
+
+    class Scope {
+    private:
+        const char* name;
+        uint32_t start;
+
+    public:
+        explicit inline Scope(const char* scopeName) : name(scopeName), start(readCycleCounter()) {}
+        inline ~Scope() { record(name, start, readCycleCounter()); }
+    };
+
+private:
+    static void IRAM_ATTR push(const char* name, uint32_t start, uint32_t end);
+    static void profCommand(int argc, char** argv);
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name) Profiler::Scope PROFILE_CONCAT(profileScope, __LINE__)(name)
+
+#else
+
+#define PROFILE_SCOPE(name) do { } while (0)
+
+#endif
+
+#endif
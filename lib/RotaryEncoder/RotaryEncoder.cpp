@@ -1,4 +1,7 @@
 #include "RotaryEncoder.h"
+#include "UiEvents.h"
+#include "Log.h"
+#include "Profiler.h"
 
 // Static instance for ISR
 static RotaryEncoder* instancePointer = nullptr;
@@ -43,16 +46,17 @@ void RotaryEncoder::begin() {
     attachInterrupt(digitalPinToInterrupt(pinCLK), handleInterruptStatic, CHANGE);
     attachInterrupt(digitalPinToInterrupt(pinDT), handleInterruptStatic, CHANGE);
     
-    Serial.println("[ENC] Initialized with state machine decoder");
+    LOG("[ENC] Initialized with state machine decoder");
 }
 
 void IRAM_ATTR RotaryEncoder::handleInterruptStatic() {
+    PROFILE_SCOPE("RotaryEncoder ISR");
     if (instancePointer) {
         instancePointer->updatePosition();
     }
 }
 
-void RotaryEncoder::updatePosition() {
+void IRAM_ATTR RotaryEncoder::updatePosition() {
     unsigned long currentTime = millis();
     
     // Aggressive debouncing
@@ -72,9 +76,15 @@ void RotaryEncoder::updatePosition() {
     
     if (direction != 0) {
         position += direction;
-        Serial.printf("[ENC] %s (state: %d -> %d)\n", 
-                     (direction > 0) ? "CW" : "CCW",
-                     encoderState, currentState);
+        // Deferred: printing from the ISR could block on USB-CDC
+        LOG("[ENC] %s (state: %d -> %d)",
+            (direction > 0) ? "CW" : "CCW",
+            encoderState, currentState);
+
+        // Wake the UI task once a full detent has accumulated
+        if (abs(position) >= 4) {
+            UiEvents::signalFromISR(UiEvents::ENCODER);
+        }
     }
     
     // Update state for next transition
@@ -82,6 +92,7 @@ void RotaryEncoder::updatePosition() {
 }
 
 int RotaryEncoder::getDirection() {
+    PROFILE_SCOPE("RotaryEncoder::getDirection");
     noInterrupts();
     
     int currentPosition = position;
@@ -23,7 +23,7 @@ private:
     
     // ISR helper
     static void IRAM_ATTR handleInterruptStatic();
-    void updatePosition();
+    void IRAM_ATTR updatePosition();
     
     // Lookup table for state machine
     static const int8_t stateTable[16];
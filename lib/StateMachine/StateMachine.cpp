@@ -1,8 +1,9 @@
 #include "StateMachine.h"
+#include "UiEvents.h"
 #include <Arduino.h>
 
 StateMachine::StateMachine() 
-    : currentState(MUTE), lastInteractionTime(0) {
+    : currentState(MUTE), playView(VIEW_INFO), lastInteractionTime(0) {
     lastInteractionTime = millis();
 }
 
@@ -14,6 +15,15 @@ void StateMachine::update() {
     }
 }
 
+unsigned long StateMachine::msUntilTimeout(unsigned long now) const {
+    if (currentState != MENU || menu.getSelectedMode() < 0) {
+        return UiEvents::NO_DEADLINE;
+    }
+
+    unsigned long elapsed = now - lastInteractionTime;
+    return (elapsed > MENU_TIMEOUT) ? 0 : MENU_TIMEOUT - elapsed + 1;
+}
+
 void StateMachine::onEncoderMoved(int direction) {
     if (currentState == MUTE) {
         return;
@@ -35,6 +45,8 @@ void StateMachine::onButtonShortPress() {
         menu.selectCurrentItem();
         currentState = PLAYING;
         resetTimeout();
+    } else if (currentState == PLAYING) {
+        playView = (PlayView)((playView + 1) % VIEW_COUNT);
     }
 }
 
@@ -13,8 +13,17 @@ class StateMachine
             MUTE
         };
 
+        // What the PLAYING screen shows; short press cycles through them
+        enum PlayView {
+            VIEW_INFO,
+            VIEW_SCOPE,
+            VIEW_SPECTRUM,
+            VIEW_COUNT
+        };
+
     private:
         State currentState;
+        PlayView playView;
         Menu menu;
         unsigned long lastInteractionTime;
         static const unsigned long MENU_TIMEOUT = 10000; // 10 seconds
@@ -30,6 +39,8 @@ class StateMachine
         void onButtonLongPress();
 
         State getState() const;
+        PlayView getPlayView() const { return playView; }
+        unsigned long msUntilTimeout(unsigned long now) const;  // for the UI wake-up deadline
         Menu &getMenu();
         const Menu &getMenu() const; //const version
         
@@ -0,0 +1,135 @@
+#include "Telemetry.h"
+#include "AllocCounter.h"
+#include "Console.h"
+#include "Log.h"
+#include "esp_heap_caps.h"
+
+TaskHandle_t Telemetry::tasks[MAX_TASKS];
+int Telemetry::taskCount = 0;
+uint32_t Telemetry::activeWarnings = 0;
+uint32_t Telemetry::allocationsPerSecond = 0;
+TaskHandle_t Telemetry::taskHandle = nullptr;
+
+// Warning bits; stacks use STACK_WARNING + task index
+enum {
+    INTERNAL_WARNING = 0,
+    DMA_WARNING,
+    PSRAM_WARNING,
+    STACK_WARNING
+};
+
+void Telemetry::begin(UBaseType_t priority, BaseType_t core) {
+    if (taskHandle) {
+        return;
+    }
+    xTaskCreatePinnedToCore(task, "Telemetry", 3072, nullptr, priority, &taskHandle, core);
+    watchTask(taskHandle);
+
+    Console::addCommand("mem", "heap, PSRAM, stacks and allocation counts", memCommand);
+}
+
+bool Telemetry::watchTask(TaskHandle_t task) {
+    if (!task || taskCount >= MAX_TASKS) {
+        return false;
+    }
+    tasks[taskCount++] = task;
+    return true;
+}
+
+void Telemetry::sampleHeap(HeapStats& stats, uint32_t caps) {
+    stats.freeBytes = heap_caps_get_free_size(caps);
+    stats.minFreeBytes = heap_caps_get_minimum_free_size(caps);
+    stats.largestBlock = heap_caps_get_largest_free_block(caps);
+    stats.totalBytes = heap_caps_get_total_size(caps);
+}
+
+void Telemetry::sample(Snapshot& snapshot) {
+    sampleHeap(snapshot.internal, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    sampleHeap(snapshot.dma, MALLOC_CAP_DMA);
+    sampleHeap(snapshot.psram, MALLOC_CAP_SPIRAM);
+
+    for (int i = 0; i < taskCount; i++) {
+        // ESP-IDF reports the high-water mark in bytes
+        snapshot.stackFree[i] = uxTaskGetStackHighWaterMark(tasks[i]);
+    }
+
+    snapshot.allocations = AllocCounter::getTotal();
+    snapshot.news = AllocCounter::getNews();
+    snapshot.frees = AllocCounter::getFrees();
+}
+
+void Telemetry::warn(int bit, bool low, const char* what, uint32_t value) {
+    uint32_t mask = 1UL << bit;
+    if (low && !(activeWarnings & mask)) {
+        activeWarnings |= mask;
+        LOG("[MEM] WARNING: %s low: %lu bytes", what, (unsigned long)value);
+    } else if (!low && (activeWarnings & mask)) {
+        activeWarnings &= ~mask;
+        LOG("[MEM] %s recovered: %lu bytes", what, (unsigned long)value);
+    }
+}
+
+void Telemetry::checkThresholds(const Snapshot& snapshot) {
+    warn(INTERNAL_WARNING, snapshot.internal.freeBytes < LOW_INTERNAL_FREE,
+         "Internal heap", snapshot.internal.freeBytes);
+    warn(DMA_WARNING, snapshot.dma.largestBlock < LOW_DMA_BLOCK,
+         "DMA block", snapshot.dma.largestBlock);
+    if (snapshot.psram.totalBytes > 0) {
+        warn(PSRAM_WARNING, snapshot.psram.largestBlock < LOW_PSRAM_BLOCK,
+             "PSRAM block", snapshot.psram.largestBlock);
+    }
+
+    for (int i = 0; i < taskCount; i++) {
+        // The high-water mark never rises again, so this fires at most once
+        if (snapshot.stackFree[i] < LOW_STACK_FREE && !(activeWarnings & (1UL << (STACK_WARNING + i)))) {
+            activeWarnings |= 1UL << (STACK_WARNING + i);
+            LOG("[MEM] WARNING: %s stack headroom %lu bytes",
+                pcTaskGetName(tasks[i]), (unsigned long)snapshot.stackFree[i]);
+        }
+    }
+}
+
+void Telemetry::task(void*) {
+    Snapshot snapshot;
+    uint32_t lastAllocations = AllocCounter::getTotal();
+
+    while (true) {
+        vTaskDelay(pdMS_TO_TICKS(SAMPLE_INTERVAL_MS));
+
+        sample(snapshot);
+        allocationsPerSecond = (snapshot.allocations - lastAllocations) * 1000 / SAMPLE_INTERVAL_MS;
+        lastAllocations = snapshot.allocations;
+
+        checkThresholds(snapshot);
+    }
+}
+
+static void printHeap(const char* name, const Telemetry::HeapStats& stats) {
+    Serial.printf("  %-9s free %7lu  min %7lu  largest %7lu  of %7lu\n", name,
+                  (unsigned long)stats.freeBytes, (unsigned long)stats.minFreeBytes,
+                  (unsigned long)stats.largestBlock, (unsigned long)stats.totalBytes);
+}
+
+void Telemetry::report() {
+    Snapshot snapshot;
+    sample(snapshot);
+
+    Serial.printf("Memory at %lu ms (bytes):\n", (unsigned long)millis());
+    printHeap("internal", snapshot.internal);
+    printHeap("dma", snapshot.dma);
+    printHeap("psram", snapshot.psram);
+
+    Serial.println("Stack headroom (minimum free since start):");
+    for (int i = 0; i < taskCount; i++) {
+        Serial.printf("  %-16s %5lu%s\n", pcTaskGetName(tasks[i]), (unsigned long)snapshot.stackFree[i],
+                      snapshot.stackFree[i] < LOW_STACK_FREE ? "  LOW" : "");
+    }
+
+    Serial.printf("Allocations: %lu malloc/calloc/realloc (%lu/s), %lu operator new, %lu free\n",
+                  (unsigned long)snapshot.allocations, (unsigned long)allocationsPerSecond,
+                  (unsigned long)snapshot.news, (unsigned long)snapshot.frees);
+}
+
+void Telemetry::memCommand(int, char**) {
+    report();
+}
@@ -0,0 +1,73 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/**
+ * Memory telemetry: heap per capability, stack headroom, allocation counts
+ *
+ * A low-priority task on Core 1 samples once per SAMPLE_INTERVAL_MS:
+ * - free / minimum-ever-free / largest free block for internal RAM,
+ *   DMA-capable RAM and PSRAM (heap_caps)
+ * - the stack high-water mark (smallest free stack ever) of every task
+ *   registered with watchTask()
+ * - malloc / operator new / free counts from AllocCounter
+ *
+ * Crossing a threshold logs a warning once; it re-arms after recovering.
+ * The "mem" console command prints a full report.
+ */
+class Telemetry {
+public:
+    static const int MAX_TASKS = 10;
+    static const uint32_t SAMPLE_INTERVAL_MS = 1000;
+
+    // Warning thresholds (bytes)
+    static const uint32_t LOW_INTERNAL_FREE = 24 * 1024;
+    static const uint32_t LOW_DMA_BLOCK = 8 * 1024;        // Largest DMA-capable block (I2S/ADC buffers)
+    static const uint32_t LOW_PSRAM_BLOCK = 64 * 1024;     // Largest PSRAM block (delay lines, tables)
+    static const uint32_t LOW_STACK_FREE = 512;
+
+    struct HeapStats {
+        uint32_t freeBytes;
+        uint32_t minFreeBytes;
+        uint32_t largestBlock;
+        uint32_t totalBytes;
+    };
+
+    struct Snapshot {
+        HeapStats internal;
+        HeapStats dma;
+        HeapStats psram;
+        uint32_t stackFree[MAX_TASKS];
+        uint32_t allocations;
+        uint32_t news;
+        uint32_t frees;
+    };
+
+private:
+    static TaskHandle_t tasks[MAX_TASKS];
+    static int taskCount;
+    static uint32_t activeWarnings;     // One bit per threshold check
+    static uint32_t allocationsPerSecond;
+    static TaskHandle_t taskHandle;
+
+public:
+    static void begin(UBaseType_t priority = 1, BaseType_t core = 1);
+
+    // Call once per task, after it has been created. nullptr is ignored.
+    static bool watchTask(TaskHandle_t task);
+
+    static void sample(Snapshot& snapshot);
+    static void report();                           // Serial, from the console task
+
+private:
+    static void task(void* parameter);
+    static void sampleHeap(HeapStats& stats, uint32_t caps);
+    static void checkThresholds(const Snapshot& snapshot);
+    static void warn(int bit, bool low, const char* what, uint32_t value);
+    static void memCommand(int argc, char** argv);
+};
+
+#endif
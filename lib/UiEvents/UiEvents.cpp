@@ -0,0 +1,34 @@
+#include "UiEvents.h"
+
+TaskHandle_t UiEvents::uiTask = nullptr;
+
+void UiEvents::begin(TaskHandle_t task) {
+    uiTask = task;
+}
+
+void IRAM_ATTR UiEvents::signalFromISR(uint32_t sources) {
+    if (!uiTask) {
+        return;
+    }
+
+    BaseType_t higherPriorityWoken = pdFALSE;
+    xTaskNotifyFromISR(uiTask, sources, eSetBits, &higherPriorityWoken);
+    if (higherPriorityWoken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+void UiEvents::signal(uint32_t sources) {
+    if (uiTask) {
+        xTaskNotify(uiTask, sources, eSetBits);
+    }
+}
+
+uint32_t UiEvents::wait(unsigned long timeoutMs) {
+    TickType_t ticks = (timeoutMs == NO_DEADLINE) ? portMAX_DELAY : pdMS_TO_TICKS(timeoutMs);
+
+    uint32_t sources = 0;
+    // Clear all bits on exit so each wake-up reports fresh sources
+    xTaskNotifyWait(0, 0xFFFFFFFF, &sources, ticks);
+    return sources;
+}
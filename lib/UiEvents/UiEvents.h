@@ -0,0 +1,46 @@
+#ifndef UIEVENTS_H
+#define UIEVENTS_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/**
+ * Wake-up channel for the UI task (Core 1)
+ *
+ * Input sources (button/encoder ISRs, pot sampler task) set bits in the UI
+ * task's notification value. loop() blocks in wait() until an input arrives
+ * or the nearest deadline (debounce, long press, menu timeout, display frame)
+ * expires, instead of polling every 10 ms.
+ */
+class UiEvents {
+public:
+    enum Source : uint32_t {
+        BUTTON  = 1 << 0,
+        ENCODER = 1 << 1,
+        POT     = 1 << 2,
+        DISPLAY = 1 << 3     // Display finished initialising
+    };
+
+    // Returned by msUntil...() helpers when nothing is scheduled
+    static const unsigned long NO_DEADLINE = 0xFFFFFFFFUL;
+
+private:
+    static TaskHandle_t uiTask;
+
+public:
+    static void begin(TaskHandle_t task);          // Call from the UI task before attaching ISRs
+
+    static void IRAM_ATTR signalFromISR(uint32_t sources);
+    static void signal(uint32_t sources);
+
+    /**
+     * Block until an input arrives or the timeout expires
+     *
+     * @param timeoutMs: Milliseconds to sleep, NO_DEADLINE = forever
+     * @return Bitmask of Source values (0 on timeout)
+     */
+    static uint32_t wait(unsigned long timeoutMs);
+};
+
+#endif
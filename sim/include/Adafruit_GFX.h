@@ -0,0 +1,60 @@
+#ifndef SIM_ADAFRUIT_GFX_H
+#define SIM_ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+
+/**
+ * Adafruit_GFX stand-in: the drawing calls the firmware uses, with the
+ * library's geometry (classic 6x8 text cell per size step, wrapping at the
+ * right edge). Text is drawn with the classic 5x7 font, printable ASCII.
+ */
+class Adafruit_GFX {
+public:
+    Adafruit_GFX(int16_t w, int16_t h);
+    virtual ~Adafruit_GFX() {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void fillScreen(uint16_t color);
+    void drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+    void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size);
+
+    void setCursor(int16_t x, int16_t y) { cursorX = x; cursorY = y; }
+    void setTextColor(uint16_t c) { textColor = c; textBackground = c; }
+    void setTextColor(uint16_t c, uint16_t bg) { textColor = c; textBackground = bg; }
+    void setTextSize(uint8_t s) { textSize = s > 0 ? s : 1; }
+    void setTextWrap(bool w) { wrap = w; }
+    int16_t getCursorX() const { return cursorX; }
+    int16_t getCursorY() const { return cursorY; }
+    int16_t width() const { return screenWidth; }
+    int16_t height() const { return screenHeight; }
+
+    void getTextBounds(const char* text, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h);
+
+    size_t write(uint8_t c);
+    size_t print(const char* text);
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value);
+    size_t print(unsigned int value);
+    size_t print(long value);
+    size_t print(unsigned long value);
+    size_t println(const char* text = "");
+
+protected:
+    int16_t screenWidth;
+    int16_t screenHeight;
+    int16_t cursorX;
+    int16_t cursorY;
+    uint16_t textColor;
+    uint16_t textBackground;    // Same as textColor = transparent
+    uint8_t textSize;
+    bool wrap;
+};
+
+#endif
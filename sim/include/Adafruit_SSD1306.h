@@ -0,0 +1,41 @@
+#ifndef SIM_ADAFRUIT_SSD1306_H
+#define SIM_ADAFRUIT_SSD1306_H
+
+#include "Adafruit_GFX.h"
+#include <Wire.h>
+
+#define SSD1306_BLACK               0
+#define SSD1306_WHITE               1
+#define SSD1306_INVERSE             2
+#define BLACK                       SSD1306_BLACK
+#define WHITE                       SSD1306_WHITE
+#define INVERSE                     SSD1306_INVERSE
+#define SSD1306_EXTERNALVCC         0x01
+#define SSD1306_SWITCHCAPVCC        0x02
+
+/**
+ * SSD1306 stand-in: the library's page-organised 1-bit buffer; display()
+ * captures the frame (--frames, and the script's "screen")
+ */
+class Adafruit_SSD1306 : public Adafruit_GFX {
+public:
+    Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi = &Wire, int8_t resetPin = -1,
+                     uint32_t clkDuring = 400000UL, uint32_t clkAfter = 100000UL);
+    ~Adafruit_SSD1306();
+
+    bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t address = 0, bool reset = true,
+               bool periphBegin = true);
+    void display();
+    void clearDisplay();
+    void invertDisplay(bool invert) { inverted = invert; }
+    void dim(bool dimmed) {}
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    bool getPixel(int16_t x, int16_t y);
+    uint8_t* getBuffer() { return buffer; }
+
+private:
+    uint8_t* buffer;
+    bool inverted;
+};
+
+#endif
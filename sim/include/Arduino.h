@@ -0,0 +1,144 @@
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+/**
+ * Arduino-ESP32 core stand-in for the host simulator
+ *
+ * The subset the firmware uses, with the core's semantics: millis(),
+ * micros() and delay() run on the simulator's virtual clock, pins and
+ * interrupts are driven by the input script, Serial is stdout.
+ */
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <math.h>
+#include <ctype.h>
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cmath>
+using std::abs;
+using std::isinf;
+using std::isnan;
+using std::max;
+using std::min;
+using ::round;
+#endif
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define EXT_RAM_ATTR
+#define RTC_DATA_ATTR
+
+#define PI          3.1415926535897932384626433832795
+#define HALF_PI     1.5707963267948966192313216916398
+#define TWO_PI      6.283185307179586476925286766559
+#define DEG_TO_RAD  0.017453292519943295769236907684886
+#define RAD_TO_DEG  57.295779513082320876798154814105
+
+#define HIGH            0x1
+#define LOW             0x0
+
+#define INPUT           0x01
+#define OUTPUT          0x03
+#define PULLUP          0x04
+#define INPUT_PULLUP    0x05
+#define PULLDOWN        0x08
+#define INPUT_PULLDOWN  0x09
+
+#define RISING          0x01
+#define FALLING         0x02
+#define CHANGE          0x03
+#define ONLOW           0x04
+#define ONHIGH          0x05
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define sq(x) ((x) * (x))
+#define digitalPinToInterrupt(p) (p)
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// Time (virtual)
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+// Pins (sim/src/Gpio.cpp)
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+uint16_t analogRead(uint8_t pin);
+int8_t digitalPinToAnalogChannel(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t pin);
+void noInterrupts();
+void interrupts();
+
+// Math
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+uint32_t getCpuFrequencyMhz();
+
+class HardwareSerial {
+public:
+    void begin(unsigned long baud);
+    void end() {}
+    operator bool() const { return true; }
+
+    int available();
+    int read();
+    int peek();
+    int availableForWrite();
+    void flush();
+
+    size_t write(uint8_t c);
+    size_t write(const uint8_t* buffer, size_t size);
+    size_t print(const char* text);
+    size_t print(char c);
+    size_t print(int value);
+    size_t print(unsigned int value);
+    size_t print(long value);
+    size_t print(unsigned long value);
+    size_t print(double value, int digits = 2);
+    size_t println();
+    size_t println(const char* text);
+    size_t println(int value);
+    size_t println(unsigned long value);
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern HardwareSerial Serial;
+
+class EspClass {
+public:
+    uint32_t getCycleCount();
+    uint32_t getCpuFreqMHz() { return getCpuFrequencyMhz(); }
+    uint32_t getFreeHeap();
+    uint32_t getHeapSize();
+    uint32_t getFreePsram();
+    uint32_t getPsramSize();
+    void restart();
+};
+
+extern EspClass ESP;
+
+// Sketch
+void setup();
+void loop();
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef SIM_WIRE_H
+#define SIM_WIRE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * I2C bus with one device on it: the SSD1306 at 0x3C (unless --headless)
+ */
+class TwoWire {
+public:
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    void setClock(uint32_t frequency) {}
+    void setTimeOut(uint16_t timeoutMs) {}
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data) { return 1; }
+    uint8_t endTransmission(bool sendStop = true);
+
+private:
+    uint8_t address = 0;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef SIM_DRIVER_I2S_H
+#define SIM_DRIVER_I2S_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "soc/soc_caps.h"
+#include "hal/i2s_types.h"
+
+/**
+ * Legacy I2S driver (IDF 4.4), TX only: see sim/src/I2s.cpp
+ */
+typedef enum {
+    I2S_MODE_MASTER = (1 << 0),
+    I2S_MODE_SLAVE = (1 << 1),
+    I2S_MODE_TX = (1 << 2),
+    I2S_MODE_RX = (1 << 3)
+} i2s_mode_t;
+
+typedef enum {
+    I2S_BITS_PER_SAMPLE_8BIT = 8,
+    I2S_BITS_PER_SAMPLE_16BIT = 16,
+    I2S_BITS_PER_SAMPLE_24BIT = 24,
+    I2S_BITS_PER_SAMPLE_32BIT = 32
+} i2s_bits_per_sample_t;
+
+typedef enum {
+    I2S_BITS_PER_CHAN_DEFAULT = 0,
+    I2S_BITS_PER_CHAN_8BIT = 8,
+    I2S_BITS_PER_CHAN_16BIT = 16,
+    I2S_BITS_PER_CHAN_24BIT = 24,
+    I2S_BITS_PER_CHAN_32BIT = 32
+} i2s_bits_per_chan_t;
+
+typedef enum {
+    I2S_CHANNEL_FMT_RIGHT_LEFT,
+    I2S_CHANNEL_FMT_ALL_RIGHT,
+    I2S_CHANNEL_FMT_ALL_LEFT,
+    I2S_CHANNEL_FMT_ONLY_RIGHT,
+    I2S_CHANNEL_FMT_ONLY_LEFT
+} i2s_channel_fmt_t;
+
+typedef enum {
+    I2S_COMM_FORMAT_STAND_I2S = 0x01,
+    I2S_COMM_FORMAT_STAND_MSB = 0x02,
+    I2S_COMM_FORMAT_STAND_PCM_SHORT = 0x04,
+    I2S_COMM_FORMAT_STAND_PCM_LONG = 0x0C
+} i2s_comm_format_t;
+
+typedef enum { I2S_CHANNEL_MONO = 1, I2S_CHANNEL_STEREO = 2 } i2s_channel_t;
+
+#define ESP_INTR_FLAG_LEVEL1    (1 << 1)
+#define I2S_PIN_NO_CHANGE       (-1)
+
+typedef struct {
+    i2s_mode_t mode;
+    uint32_t sample_rate;
+    i2s_bits_per_sample_t bits_per_sample;
+    i2s_channel_fmt_t channel_format;
+    i2s_comm_format_t communication_format;
+    int intr_alloc_flags;
+    int dma_buf_count;
+    int dma_buf_len;
+    bool use_apll;
+    bool tx_desc_auto_clear;
+    int fixed_mclk;
+    i2s_mclk_multiple_t mclk_multiple;
+    i2s_bits_per_chan_t bits_per_chan;
+} i2s_config_t;
+
+typedef struct {
+    int mck_io_num;
+    int bck_io_num;
+    int ws_io_num;
+    int data_out_num;
+    int data_in_num;
+} i2s_pin_config_t;
+
+typedef enum {
+    I2S_EVENT_DMA_ERROR,
+    I2S_EVENT_TX_DONE,
+    I2S_EVENT_RX_DONE,
+    I2S_EVENT_TX_Q_OVF,
+    I2S_EVENT_RX_Q_OVF,
+    I2S_EVENT_MAX
+} i2s_event_type_t;
+
+typedef struct {
+    i2s_event_type_t type;
+    size_t size;
+} i2s_event_t;
+
+esp_err_t i2s_driver_install(i2s_port_t port, const i2s_config_t* config, int queueSize, void* queue);
+esp_err_t i2s_driver_uninstall(i2s_port_t port);
+esp_err_t i2s_set_pin(i2s_port_t port, const i2s_pin_config_t* pins);
+esp_err_t i2s_set_clk(i2s_port_t port, uint32_t rate, uint32_t bits, i2s_channel_t channels);
+esp_err_t i2s_write(i2s_port_t port, const void* src, size_t size, size_t* written, TickType_t ticks);
+esp_err_t i2s_zero_dma_buffer(i2s_port_t port);
+esp_err_t i2s_start(i2s_port_t port);
+esp_err_t i2s_stop(i2s_port_t port);
+
+#endif
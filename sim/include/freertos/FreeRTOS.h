@@ -0,0 +1,56 @@
+#ifndef SIM_FREERTOS_H
+#define SIM_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * FreeRTOS stand-in for the host simulator (see sim/src/Kernel.h)
+ *
+ * Types, constants and the port layer as the ESP32 Arduino core has them
+ * (1 kHz tick). Critical sections and interrupt masking lock per core.
+ */
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE             ((BaseType_t)0)
+#define pdTRUE              ((BaseType_t)1)
+#define pdFAIL              pdFALSE
+#define pdPASS              pdTRUE
+#define errQUEUE_EMPTY      ((BaseType_t)0)
+#define errQUEUE_FULL       ((BaseType_t)0)
+
+#define configTICK_RATE_HZ  1000
+#define portTICK_PERIOD_MS  ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY       ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(((TickType_t)(ms) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+#define tskNO_AFFINITY      0x7FFFFFFF
+#define configASSERT(x)     do { if (!(x)) { simAssertFailed(__FILE__, __LINE__); } } while (0)
+
+// Spinlock + this core's interrupts, as on the dual-core port
+typedef struct {
+    volatile int owner;     // Core + 1, 0 = free
+    int count;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0, 0}
+
+void vPortEnterCritical(portMUX_TYPE* mux);
+void vPortExitCritical(portMUX_TYPE* mux);
+#define portENTER_CRITICAL(mux)         vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux)          vPortExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux)     vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux)      vPortExitCritical(mux)
+
+uint32_t portSET_INTERRUPT_MASK_FROM_ISR();
+void portCLEAR_INTERRUPT_MASK_FROM_ISR(uint32_t state);
+#define portYIELD_FROM_ISR(...)         do { } while (0)
+#define portYIELD()                     simYield()
+#define taskYIELD()                     simYield()
+
+BaseType_t xPortGetCoreID();
+BaseType_t xPortInIsrContext();
+void simYield();
+void simAssertFailed(const char* file, int line);
+
+#endif
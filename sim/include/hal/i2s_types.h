@@ -0,0 +1,16 @@
+#ifndef SIM_HAL_I2S_TYPES_H
+#define SIM_HAL_I2S_TYPES_H
+
+/**
+ * Types shared by the legacy and the channel I2S drivers
+ */
+typedef enum { I2S_NUM_0 = 0, I2S_NUM_1 = 1, I2S_NUM_MAX } i2s_port_t;
+
+typedef enum {
+    I2S_MCLK_MULTIPLE_DEFAULT = 0,
+    I2S_MCLK_MULTIPLE_128 = 128,
+    I2S_MCLK_MULTIPLE_256 = 256,
+    I2S_MCLK_MULTIPLE_384 = 384
+} i2s_mclk_multiple_t;
+
+#endif
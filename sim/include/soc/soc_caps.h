@@ -0,0 +1,11 @@
+#ifndef SIM_SOC_CAPS_H
+#define SIM_SOC_CAPS_H
+
+// ESP32-S3 (no audio PLL: SOC_I2S_SUPPORTS_APLL is left undefined)
+#define SOC_CPU_CORES_NUM           2
+#define SOC_ADC_DIGI_RESULT_BYTES   4
+#define SOC_ADC_DIGI_MAX_BITWIDTH   12
+#define SOC_ADC_PATT_LEN_MAX        24
+#define SOC_ADC_MAX_CHANNEL_NUM     10
+
+#endif
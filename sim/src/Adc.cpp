@@ -0,0 +1,143 @@
+#include "driver/adc.h"
+#include <Arduino.h>
+#include "Kernel.h"
+#include "Sim.h"
+
+using sim::Kernel;
+
+/**
+ * ADC1 continuous-mode model
+ *
+ * Conversions run at sample_freq_hz through the configured pattern, one
+ * channel after the other, from the moment adc_digi_start() is called.
+ * Each reads the level the script last set on that channel's GPIO. A read
+ * blocks until `length` bytes of results exist; if the reader fell behind
+ * by more than the driver's pool (max_store_buf_size) the oldest results
+ * are lost and the read returns ESP_ERR_INVALID_STATE, as the driver does.
+ */
+namespace {
+
+struct Adc {
+    bool initialized;
+    bool running;
+    uint32_t poolBytes;
+    uint32_t rate;
+    int patternCount;
+    uint8_t channels[SOC_ADC_PATT_LEN_MAX];
+    uint64_t startNs;
+    uint64_t consumed;          // Conversions handed out (or lost)
+    uint64_t overflows;
+};
+
+Adc adc;
+
+uint64_t produced(uint64_t now) {
+    return (now - adc.startNs) * adc.rate / 1000000000ull;
+}
+
+uint64_t timeOf(uint64_t conversions) {
+    // First ns at which `conversions` results exist
+    return adc.startNs + (conversions * 1000000000ull + adc.rate - 1) / adc.rate;
+}
+
+}   // namespace
+
+esp_err_t adc_digi_initialize(const adc_digi_init_config_t* config) {
+    Kernel::Lock held(Kernel::mutex());
+    if (adc.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    adc.initialized = true;
+    adc.poolBytes = config->max_store_buf_size;
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_controller_configure(const adc_digi_configuration_t* config) {
+    Kernel::Lock held(Kernel::mutex());
+    if (!adc.initialized || config->pattern_num == 0 || config->pattern_num > SOC_ADC_PATT_LEN_MAX ||
+        config->sample_freq_hz == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    adc.rate = config->sample_freq_hz;
+    adc.patternCount = config->pattern_num;
+    for (int i = 0; i < adc.patternCount; i++) {
+        adc.channels[i] = config->adc_pattern[i].channel;
+    }
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_start() {
+    Kernel::Lock held(Kernel::mutex());
+    if (!adc.initialized || adc.rate == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    adc.running = true;
+    adc.startNs = Kernel::nowNs();
+    adc.consumed = 0;
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_stop() {
+    Kernel::Lock held(Kernel::mutex());
+    adc.running = false;
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_deinitialize() {
+    Kernel::Lock held(Kernel::mutex());
+    adc.running = false;
+    adc.initialized = false;
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_read_bytes(uint8_t* buffer, uint32_t length, uint32_t* outLength, uint32_t timeoutMs) {
+    Kernel::Lock held(Kernel::mutex());
+    *outLength = 0;
+    if (!adc.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uint32_t wanted = length / SOC_ADC_DIGI_RESULT_BYTES;
+    uint64_t ready = timeOf(adc.consumed + wanted);
+    uint64_t deadline = Kernel::afterMs(timeoutMs);
+    Kernel::sleepUntil(held, ready < deadline ? ready : deadline);
+
+    esp_err_t result = ESP_OK;
+    uint64_t available = produced(Kernel::nowNs()) - adc.consumed;
+    uint64_t pool = adc.poolBytes / SOC_ADC_DIGI_RESULT_BYTES;
+    if (available > pool) {
+        adc.consumed += available - pool;       // Pool overflowed: oldest results lost
+        adc.overflows++;
+        available = pool;
+        result = ESP_ERR_INVALID_STATE;
+    }
+    if (available == 0) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    uint32_t count = available < wanted ? (uint32_t)available : wanted;
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t channel = adc.channels[(adc.consumed + i) % adc.patternCount];
+        adc_digi_output_data_t data;
+        data.val = 0;
+        data.type2.data = sim::analogLevel(channel + 1);     // ADC1 channel n is GPIO n+1
+        data.type2.channel = channel;
+        data.type2.unit = 0;
+        memcpy(buffer + i * SOC_ADC_DIGI_RESULT_BYTES, &data, SOC_ADC_DIGI_RESULT_BYTES);
+    }
+    adc.consumed += count;
+    *outLength = count * SOC_ADC_DIGI_RESULT_BYTES;
+    return result;
+}
+
+namespace sim {
+
+void printAdcStats(FILE* out) {
+    if (adc.running) {
+        fprintf(out, "[SIM] ADC: %lu Hz over %d channels, %llu conversions read, %llu pool overflows\n",
+                (unsigned long)adc.rate, adc.patternCount, (unsigned long long)adc.consumed,
+                (unsigned long long)adc.overflows);
+    }
+}
+
+}   // namespace sim
@@ -0,0 +1,421 @@
+#include <Adafruit_SSD1306.h>
+#include <Wire.h>
+#include <mutex>
+#include "Kernel.h"
+#include "Sim.h"
+
+/**
+ * OLED: Adafruit_GFX drawing, the SSD1306 framebuffer and its I2C probe
+ *
+ * display() copies the frame for the script's "screen" command and, with
+ * --frames, appends it to the frame stream as a PBM image. Both run inside
+ * the firmware's allocation-checked frame, so neither allocates: the copy
+ * is static and the stream is opened up front with a static buffer.
+ */
+
+// Classic 5x7 font, printable ASCII (0x20-0x7E): 5 columns, bit 0 = top row
+static const uint8_t FONT[95][5] = {
+    {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, {0x00,0x07,0x00,0x07,0x00}, {0x14,0x7F,0x14,0x7F,0x14},
+    {0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62}, {0x36,0x49,0x56,0x20,0x50}, {0x00,0x08,0x07,0x03,0x00},
+    {0x00,0x1C,0x22,0x41,0x00}, {0x00,0x41,0x22,0x1C,0x00}, {0x2A,0x1C,0x7F,0x1C,0x2A}, {0x08,0x08,0x3E,0x08,0x08},
+    {0x00,0x80,0x70,0x30,0x00}, {0x08,0x08,0x08,0x08,0x08}, {0x00,0x00,0x60,0x60,0x00}, {0x20,0x10,0x08,0x04,0x02},
+    {0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00}, {0x72,0x49,0x49,0x49,0x46}, {0x21,0x41,0x49,0x4D,0x33},
+    {0x18,0x14,0x12,0x7F,0x10}, {0x27,0x45,0x45,0x45,0x39}, {0x3C,0x4A,0x49,0x49,0x31}, {0x41,0x21,0x11,0x09,0x07},
+    {0x36,0x49,0x49,0x49,0x36}, {0x46,0x49,0x49,0x29,0x1E}, {0x00,0x00,0x14,0x00,0x00}, {0x00,0x40,0x34,0x00,0x00},
+    {0x00,0x08,0x14,0x22,0x41}, {0x14,0x14,0x14,0x14,0x14}, {0x00,0x41,0x22,0x14,0x08}, {0x02,0x01,0x59,0x09,0x06},
+    {0x3E,0x41,0x5D,0x59,0x4E}, {0x7C,0x12,0x11,0x12,0x7C}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22},
+    {0x7F,0x41,0x41,0x41,0x3E}, {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x09,0x01}, {0x3E,0x41,0x41,0x51,0x73},
+    {0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00}, {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41},
+    {0x7F,0x40,0x40,0x40,0x40}, {0x7F,0x02,0x1C,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E},
+    {0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46}, {0x26,0x49,0x49,0x49,0x32},
+    {0x03,0x01,0x7F,0x01,0x03}, {0x3F,0x40,0x40,0x40,0x3F}, {0x1F,0x20,0x40,0x20,0x1F}, {0x3F,0x40,0x38,0x40,0x3F},
+    {0x63,0x14,0x08,0x14,0x63}, {0x03,0x04,0x78,0x04,0x03}, {0x61,0x59,0x49,0x4D,0x43}, {0x00,0x7F,0x41,0x41,0x41},
+    {0x02,0x04,0x08,0x10,0x20}, {0x00,0x41,0x41,0x41,0x7F}, {0x04,0x02,0x01,0x02,0x04}, {0x40,0x40,0x40,0x40,0x40},
+    {0x00,0x03,0x07,0x08,0x00}, {0x20,0x54,0x54,0x78,0x40}, {0x7F,0x28,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x28},
+    {0x38,0x44,0x44,0x28,0x7F}, {0x38,0x54,0x54,0x54,0x18}, {0x00,0x08,0x7E,0x09,0x02}, {0x18,0xA4,0xA4,0x9C,0x78},
+    {0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00}, {0x20,0x40,0x40,0x3D,0x00}, {0x7F,0x10,0x28,0x44,0x00},
+    {0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x78,0x04,0x78}, {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38},
+    {0xFC,0x18,0x24,0x24,0x18}, {0x18,0x24,0x24,0x18,0xFC}, {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x24},
+    {0x04,0x04,0x3F,0x44,0x24}, {0x3C,0x40,0x40,0x20,0x7C}, {0x1C,0x20,0x40,0x20,0x1C}, {0x3C,0x40,0x30,0x40,0x3C},
+    {0x44,0x28,0x10,0x28,0x44}, {0x4C,0x90,0x90,0x90,0x7C}, {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00},
+    {0x00,0x00,0x77,0x00,0x00}, {0x00,0x41,0x36,0x08,0x00}, {0x02,0x01,0x02,0x04,0x02},
+};
+
+static const uint8_t UNKNOWN_GLYPH[5] = {0x7F, 0x41, 0x41, 0x41, 0x7F};
+
+// ==========================================
+// ADAFRUIT_GFX
+// ==========================================
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h)
+    : screenWidth(w), screenHeight(h), cursorX(0), cursorY(0), textColor(0xFFFF), textBackground(0xFFFF),
+      textSize(1), wrap(true) {
+}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    for (int16_t i = 0; i < h; i++) {
+        drawPixel(x, y + i, color);
+    }
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    for (int16_t i = 0; i < w; i++) {
+        drawPixel(x + i, y, color);
+    }
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    // Bresenham, as the library does it
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+        std::swap(x0, y0);
+        std::swap(x1, y1);
+    }
+    if (x0 > x1) {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+    }
+    int16_t dx = x1 - x0;
+    int16_t dy = abs(y1 - y0);
+    int16_t err = dx / 2;
+    int16_t ystep = y0 < y1 ? 1 : -1;
+    for (; x0 <= x1; x0++) {
+        if (steep) {
+            drawPixel(y0, x0, color);
+        } else {
+            drawPixel(x0, y0, color);
+        }
+        err -= dy;
+        if (err < 0) {
+            y0 += ystep;
+            err += dx;
+        }
+    }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    for (int16_t i = x; i < x + w; i++) {
+        drawFastVLine(i, y, h, color);
+    }
+}
+
+void Adafruit_GFX::fillScreen(uint16_t color) {
+    fillRect(0, 0, screenWidth, screenHeight, color);
+}
+
+void Adafruit_GFX::drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2,
+                                uint16_t color) {
+    drawLine(x0, y0, x1, y1, color);
+    drawLine(x1, y1, x2, y2, color);
+    drawLine(x2, y2, x0, y0, color);
+}
+
+void Adafruit_GFX::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2,
+                                uint16_t color) {
+    // Sort by y, then fill one span per scanline between the edges
+    if (y0 > y1) { std::swap(y0, y1); std::swap(x0, x1); }
+    if (y1 > y2) { std::swap(y2, y1); std::swap(x2, x1); }
+    if (y0 > y1) { std::swap(y0, y1); std::swap(x0, x1); }
+
+    if (y0 == y2) {
+        int16_t a = std::min(x0, std::min(x1, x2));
+        int16_t b = std::max(x0, std::max(x1, x2));
+        drawFastHLine(a, y0, b - a + 1, color);
+        return;
+    }
+
+    for (int16_t y = y0; y <= y2; y++) {
+        int16_t a = x0 + (int32_t)(x2 - x0) * (y - y0) / (y2 - y0);
+        int16_t b;
+        if (y < y1 || y1 == y2) {
+            b = (y1 == y0) ? x1 : x0 + (int32_t)(x1 - x0) * (y - y0) / (y1 - y0);
+        } else {
+            b = x1 + (int32_t)(x2 - x1) * (y - y1) / (y2 - y1);
+        }
+        if (a > b) {
+            std::swap(a, b);
+        }
+        drawFastHLine(a, y, b - a + 1, color);
+    }
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+    const uint8_t* glyph = (c >= 0x20 && c <= 0x7E) ? FONT[c - 0x20] : UNKNOWN_GLYPH;
+    for (int col = 0; col < 6; col++) {
+        uint8_t bits = col < 5 ? glyph[col] : 0;
+        for (int row = 0; row < 8; row++, bits >>= 1) {
+            if (bits & 1) {
+                fillRect(x + col * size, y + row * size, size, size, color);
+            } else if (bg != color) {
+                fillRect(x + col * size, y + row * size, size, size, bg);
+            }
+        }
+    }
+}
+
+size_t Adafruit_GFX::write(uint8_t c) {
+    if (c == '\n') {
+        cursorX = 0;
+        cursorY += textSize * 8;
+    } else if (c != '\r') {
+        if (wrap && cursorX + textSize * 6 > screenWidth) {
+            cursorX = 0;
+            cursorY += textSize * 8;
+        }
+        drawChar(cursorX, cursorY, c, textColor, textBackground, textSize);
+        cursorX += textSize * 6;
+    }
+    return 1;
+}
+
+size_t Adafruit_GFX::print(const char* text) {
+    size_t n = 0;
+    while (*text) {
+        n += write((uint8_t)*text++);
+    }
+    return n;
+}
+
+size_t Adafruit_GFX::print(int value) {
+    char text[12];
+    snprintf(text, sizeof(text), "%d", value);
+    return print(text);
+}
+
+size_t Adafruit_GFX::print(unsigned int value) {
+    char text[12];
+    snprintf(text, sizeof(text), "%u", value);
+    return print(text);
+}
+
+size_t Adafruit_GFX::print(long value) {
+    char text[24];
+    snprintf(text, sizeof(text), "%ld", value);
+    return print(text);
+}
+
+size_t Adafruit_GFX::print(unsigned long value) {
+    char text[24];
+    snprintf(text, sizeof(text), "%lu", value);
+    return print(text);
+}
+
+size_t Adafruit_GFX::println(const char* text) {
+    return print(text) + write('\n');
+}
+
+void Adafruit_GFX::getTextBounds(const char* text, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w,
+                                 uint16_t* h) {
+    // Same walk as write(), tracking the extent instead of drawing
+    int16_t minX = 0x7FFF, minY = 0x7FFF, maxX = -1, maxY = -1;
+    for (const char* c = text; *c; c++) {
+        if (*c == '\n') {
+            x = 0;
+            y += textSize * 8;
+            continue;
+        }
+        if (*c == '\r') {
+            continue;
+        }
+        if (wrap && x + textSize * 6 > screenWidth) {
+            x = 0;
+            y += textSize * 8;
+        }
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, (int16_t)(x + textSize * 6 - 1));
+        maxY = std::max(maxY, (int16_t)(y + textSize * 8 - 1));
+        x += textSize * 6;
+    }
+    if (maxX < minX) {
+        *x1 = x;
+        *y1 = y;
+        *w = *h = 0;
+        return;
+    }
+    *x1 = minX;
+    *y1 = minY;
+    *w = maxX - minX + 1;
+    *h = maxY - minY + 1;
+}
+
+// ==========================================
+// FRAME CAPTURE
+// ==========================================
+static const int MAX_WIDTH = 128;
+static const int MAX_HEIGHT = 64;
+
+static std::mutex screenLock;
+static uint8_t shown[MAX_WIDTH * MAX_HEIGHT / 8];
+static int shownWidth = 0;
+static int shownHeight = 0;
+static uint32_t framesShown = 0;
+
+static FILE* frameStream = nullptr;
+static uint8_t frameStreamBuffer[1 << 15];
+
+static void capture(const uint8_t* buffer, int w, int h) {
+    std::lock_guard<std::mutex> guard(screenLock);
+    shownWidth = w;
+    shownHeight = h;
+    memcpy(shown, buffer, w * h / 8);
+    framesShown++;
+
+    if (sim::options.framesPath && !frameStream) {
+        frameStream = fopen(sim::options.framesPath, "wb");
+        if (frameStream) {
+            setvbuf(frameStream, (char*)frameStreamBuffer, _IOFBF, sizeof(frameStreamBuffer));
+        }
+    }
+    if (!frameStream) {
+        return;
+    }
+
+    // PBM rows are MSB-first bit rows; the SSD1306 buffer is column bytes per page
+    fprintf(frameStream, "P4\n# t=%lu ms\n%d %d\n", millis(), w, h);
+    for (int y = 0; y < h; y++) {
+        for (int xb = 0; xb < w / 8; xb++) {
+            uint8_t packed = 0;
+            for (int bit = 0; bit < 8; bit++) {
+                int x = xb * 8 + bit;
+                if (buffer[x + (y / 8) * w] & (1 << (y & 7))) {
+                    packed |= 0x80 >> bit;
+                }
+            }
+            fputc(packed, frameStream);
+        }
+    }
+}
+
+// ==========================================
+// ADAFRUIT_SSD1306
+// ==========================================
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t resetPin, uint32_t clkDuring,
+                                   uint32_t clkAfter)
+    : Adafruit_GFX(w, h), buffer(nullptr), inverted(false) {
+}
+
+Adafruit_SSD1306::~Adafruit_SSD1306() {
+    delete[] buffer;
+}
+
+bool Adafruit_SSD1306::begin(uint8_t switchvcc, uint8_t address, bool reset, bool periphBegin) {
+    if (screenWidth > MAX_WIDTH || screenHeight > MAX_HEIGHT || (screenHeight & 7)) {
+        return false;
+    }
+    if (!buffer) {
+        buffer = new uint8_t[screenWidth * screenHeight / 8];
+    }
+    clearDisplay();
+    return true;
+}
+
+void Adafruit_SSD1306::display() {
+    if (!buffer) {
+        return;
+    }
+    if (inverted) {
+        uint8_t frame[MAX_WIDTH * MAX_HEIGHT / 8];
+        for (int i = 0; i < screenWidth * screenHeight / 8; i++) {
+            frame[i] = ~buffer[i];
+        }
+        capture(frame, screenWidth, screenHeight);
+    } else {
+        capture(buffer, screenWidth, screenHeight);
+    }
+}
+
+void Adafruit_SSD1306::clearDisplay() {
+    if (buffer) {
+        memset(buffer, 0, screenWidth * screenHeight / 8);
+    }
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if (!buffer || x < 0 || y < 0 || x >= screenWidth || y >= screenHeight) {
+        return;
+    }
+    uint8_t& byte = buffer[x + (y / 8) * screenWidth];
+    uint8_t bit = 1 << (y & 7);
+    switch (color) {
+        case SSD1306_WHITE:   byte |= bit; break;
+        case SSD1306_BLACK:   byte &= ~bit; break;
+        case SSD1306_INVERSE: byte ^= bit; break;
+    }
+}
+
+bool Adafruit_SSD1306::getPixel(int16_t x, int16_t y) {
+    if (!buffer || x < 0 || y < 0 || x >= screenWidth || y >= screenHeight) {
+        return false;
+    }
+    return buffer[x + (y / 8) * screenWidth] & (1 << (y & 7));
+}
+
+// ==========================================
+// I2C
+// ==========================================
+TwoWire Wire;
+
+static const uint8_t OLED_ADDRESS = 0x3C;
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+    return true;
+}
+
+void TwoWire::beginTransmission(uint8_t target) {
+    address = target;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    return sim::displayPresent() && address == OLED_ADDRESS ? 0 : 2;     // 2 = NACK on address
+}
+
+namespace sim {
+
+bool displayPresent() {
+    return !options.headless;
+}
+
+void printScreen(FILE* out) {
+    std::lock_guard<std::mutex> guard(screenLock);
+    if (framesShown == 0) {
+        fprintf(out, "[SIM] screen: nothing displayed yet\n");
+        return;
+    }
+    // Two pixel rows per text line: upper/lower half blocks
+    fprintf(out, "+");
+    for (int x = 0; x < shownWidth; x++) {
+        fputc('-', out);
+    }
+    fprintf(out, "+  frame %lu\n", (unsigned long)framesShown);
+    for (int y = 0; y < shownHeight; y += 2) {
+        fputc('|', out);
+        for (int x = 0; x < shownWidth; x++) {
+            bool top = shown[x + (y / 8) * shownWidth] & (1 << (y & 7));
+            bool bottom = shown[x + ((y + 1) / 8) * shownWidth] & (1 << ((y + 1) & 7));
+            fputs(top && bottom ? "\xE2\x96\x88" : top ? "\xE2\x96\x80" : bottom ? "\xE2\x96\x84" : " ", out);
+        }
+        fputs("|\n", out);
+    }
+    fprintf(out, "+");
+    for (int x = 0; x < shownWidth; x++) {
+        fputc('-', out);
+    }
+    fprintf(out, "+\n");
+}
+
+void closeFrames() {
+    std::lock_guard<std::mutex> guard(screenLock);
+    if (frameStream) {
+        fclose(frameStream);
+        frameStream = nullptr;
+    }
+}
+
+}   // namespace sim
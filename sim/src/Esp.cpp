@@ -0,0 +1,278 @@
+#include <Arduino.h>
+#include "esp_err.h"
+#include "esp_partition.h"
+#include "Kernel.h"
+#include "Sim.h"
+#include "../../include/CycleCounter.h"
+
+using sim::Kernel;
+
+/**
+ * Time, random numbers, heap capabilities and the sample partition
+ */
+
+// ==========================================
+// TIME
+// ==========================================
+unsigned long millis() {
+    return (unsigned long)(uint32_t)(Kernel::nowNs() / 1000000ull);
+}
+
+unsigned long micros() {
+    return (unsigned long)(uint32_t)(Kernel::nowNs() / 1000ull);
+}
+
+int64_t esp_timer_get_time() {
+    return (int64_t)(Kernel::nowNs() / 1000ull);
+}
+
+void delay(uint32_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+    Kernel::Lock held(Kernel::mutex());
+    Kernel::sleepUntil(held, Kernel::nowNs() + (uint64_t)us * 1000ull);
+}
+
+uint32_t getCpuFrequencyMhz() {
+    return 240;
+}
+
+// ==========================================
+// RANDOM
+// ==========================================
+// One xorshift stream per task (seeded from --seed and the task's creation
+// order), so runs repeat whatever the host interleaving
+static thread_local uint32_t threadState = 0;
+
+static uint32_t nextRandom() {
+    uint32_t& state = threadState;
+    if (state == 0) {
+        Kernel::Task* task = Kernel::current();
+        state = (task ? task->seed : 0x2545F491u) ^ sim::options.seed;
+        if (state == 0) {
+            state = 1;
+        }
+    }
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+long random(long howbig) {
+    return howbig <= 0 ? 0 : (long)(nextRandom() % (uint32_t)howbig);
+}
+
+long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) {
+        return howsmall;
+    }
+    return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed) {
+    threadState = seed ? (uint32_t)seed : 1;
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    long dividend = outMax - outMin;
+    long divisor = inMax - inMin;
+    if (divisor == 0) {
+        return -1;      // As the core does
+    }
+    return (x - inMin) * dividend / divisor + outMin;
+}
+
+// ==========================================
+// ESP
+// ==========================================
+EspClass ESP;
+
+uint32_t EspClass::getCycleCount() {
+    return readCycleCounter();
+}
+
+uint32_t EspClass::getFreeHeap() {
+    return heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+}
+
+uint32_t EspClass::getHeapSize() {
+    return heap_caps_get_total_size(MALLOC_CAP_INTERNAL);
+}
+
+uint32_t EspClass::getFreePsram() {
+    return heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+}
+
+uint32_t EspClass::getPsramSize() {
+    return heap_caps_get_total_size(MALLOC_CAP_SPIRAM);
+}
+
+void EspClass::restart() {
+    Serial.println("[SIM] ESP.restart()");
+    sim::finish(0);
+}
+
+const char* esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK:                return "ESP_OK";
+        case ESP_FAIL:              return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:        return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:   return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE:  return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND:     return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT:       return "ESP_ERR_TIMEOUT";
+        default:                    return "UNKNOWN ERROR";
+    }
+}
+
+// ==========================================
+// HEAP CAPABILITIES
+// ==========================================
+// Straight to the libc heap (as on the chip, these bypass the malloc
+// wrappers AllocCounter counts); a header records the pool and size
+extern "C" {
+void* __real_malloc(size_t size);
+void __real_free(void* ptr);
+}
+
+namespace {
+
+struct Pool {
+    size_t total;
+    std::atomic<size_t> used;
+    std::atomic<size_t> peak;
+};
+
+// ESP32-S3 with 8 MB octal PSRAM, after the Arduino core has booted
+Pool internalPool = { 320 * 1024, {0}, {0} };
+Pool psramPool = { 8 * 1024 * 1024 - 64 * 1024, {0}, {0} };
+
+struct alignas(16) Header {
+    Pool* pool;
+    size_t size;
+};
+
+Pool& poolFor(uint32_t caps) {
+    return (caps & MALLOC_CAP_SPIRAM) ? psramPool : internalPool;
+}
+
+}   // namespace
+
+void* heap_caps_malloc(size_t size, uint32_t caps) {
+    Pool& pool = poolFor(caps);
+    if (pool.used.load() + size > pool.total) {
+        return nullptr;
+    }
+    Header* header = (Header*)__real_malloc(sizeof(Header) + size);
+    if (!header) {
+        return nullptr;
+    }
+    header->pool = &pool;
+    header->size = size;
+    size_t used = pool.used.fetch_add(size) + size;
+    size_t peak = pool.peak.load();
+    while (used > peak && !pool.peak.compare_exchange_weak(peak, used)) {
+    }
+    return header + 1;
+}
+
+void* heap_caps_calloc(size_t count, size_t size, uint32_t caps) {
+    void* ptr = heap_caps_malloc(count * size, caps);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+void* heap_caps_realloc(void* ptr, size_t size, uint32_t caps) {
+    void* grown = heap_caps_malloc(size, caps);
+    if (grown && ptr) {
+        Header* header = (Header*)ptr - 1;
+        memcpy(grown, ptr, header->size < size ? header->size : size);
+        heap_caps_free(ptr);
+    }
+    return grown;
+}
+
+void heap_caps_free(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    Header* header = (Header*)ptr - 1;
+    header->pool->used.fetch_sub(header->size);
+    __real_free(header);
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+    Pool& pool = poolFor(caps);
+    return pool.total - pool.used.load();
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps) {
+    Pool& pool = poolFor(caps);
+    return pool.total - pool.peak.load();
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps) {
+    return heap_caps_get_free_size(caps);      // No fragmentation modelled
+}
+
+size_t heap_caps_get_total_size(uint32_t caps) {
+    return poolFor(caps).total;
+}
+
+// ==========================================
+// SAMPLE PARTITION
+// ==========================================
+static esp_partition_t samplesPartition;
+static uint8_t* samplesImage = nullptr;
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label) {
+    if (!sim::options.samplesPath || type != ESP_PARTITION_TYPE_DATA ||
+        (label && strcmp(label, "samples") != 0)) {
+        return nullptr;
+    }
+    if (!samplesImage) {
+        FILE* file = fopen(sim::options.samplesPath, "rb");
+        if (!file) {
+            fprintf(stderr, "[SIM] Can't open sample bank %s\n", sim::options.samplesPath);
+            return nullptr;
+        }
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        samplesImage = new uint8_t[size > 0 ? size : 1];
+        if (size <= 0 || fread(samplesImage, 1, size, file) != (size_t)size) {
+            fclose(file);
+            return nullptr;
+        }
+        fclose(file);
+
+        samplesPartition.type = ESP_PARTITION_TYPE_DATA;
+        samplesPartition.subtype = subtype;
+        samplesPartition.address = 0x610000;   // partitions_16MB_samples.csv
+        samplesPartition.size = (uint32_t)size;
+        strcpy(samplesPartition.label, "samples");
+        samplesPartition.encrypted = false;
+    }
+    return &samplesPartition;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t* partition, size_t offset, size_t size,
+                             spi_flash_mmap_memory_t memory, const void** out, spi_flash_mmap_handle_t* handle) {
+    if (partition != &samplesPartition || !samplesImage || offset + size > partition->size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out = samplesImage + offset;
+    *handle = 1;
+    return ESP_OK;
+}
+
+void spi_flash_munmap(spi_flash_mmap_handle_t handle) {
+}
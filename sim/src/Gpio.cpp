@@ -0,0 +1,221 @@
+#include <Arduino.h>
+#include <atomic>
+#include <mutex>
+#include "Kernel.h"
+#include "Sim.h"
+
+using sim::Kernel;
+
+/**
+ * Pins, GPIO interrupts and interrupt masking
+ *
+ * Pins read HIGH (pulled up) until the script drives them. A level change
+ * runs the pin's ISR right away on the script's thread, as an ISR on the
+ * core that attached it, with that core's interrupts masked.
+ *
+ * Masking is one recursive lock per core: noInterrupts() and
+ * portSET_INTERRUPT_MASK_FROM_ISR() keep ISRs and other tasks "on the same
+ * core" out, which is what the firmware relies on them for. Holding a
+ * mask across a blocking call would stall the other side, as it would on
+ * the chip.
+ */
+static const int PIN_COUNT = 49;
+
+struct PinState {
+    std::atomic<int> level;
+    std::atomic<uint16_t> analog;
+    void (*handler)(void);
+    void (*handlerArg)(void*);
+    void* arg;
+    int mode;
+    int core;
+};
+
+static PinState pins[PIN_COUNT];
+static std::recursive_mutex coreMasks[2];
+static std::mutex attachLock;
+
+static bool validPin(int pin) {
+    return pin >= 0 && pin < PIN_COUNT;
+}
+
+namespace {
+struct PinInit {
+    PinInit() {
+        for (int i = 0; i < PIN_COUNT; i++) {
+            pins[i].level.store(HIGH);
+            pins[i].analog.store(0);
+            pins[i].handler = nullptr;
+            pins[i].handlerArg = nullptr;
+            pins[i].arg = nullptr;
+            pins[i].mode = 0;
+            pins[i].core = 1;
+        }
+    }
+} pinInit;
+}
+
+// ==========================================
+// INTERRUPT MASKING
+// ==========================================
+uint32_t portSET_INTERRUPT_MASK_FROM_ISR() {
+    int core = Kernel::currentCore();
+    coreMasks[core].lock();
+    return (uint32_t)core;
+}
+
+void portCLEAR_INTERRUPT_MASK_FROM_ISR(uint32_t state) {
+    coreMasks[state & 1].unlock();
+}
+
+void noInterrupts() {
+    coreMasks[Kernel::currentCore()].lock();
+}
+
+void interrupts() {
+    coreMasks[Kernel::currentCore()].unlock();
+}
+
+void vPortEnterCritical(portMUX_TYPE* mux) {
+    int core = Kernel::currentCore();
+    coreMasks[core].lock();
+    if (mux->owner == core + 1) {
+        mux->count++;       // Nested on the same core
+        return;
+    }
+    while (!__sync_bool_compare_and_swap(&mux->owner, 0, core + 1)) {
+        std::this_thread::yield();
+    }
+    mux->count = 1;
+}
+
+void vPortExitCritical(portMUX_TYPE* mux) {
+    int core = Kernel::currentCore();
+    if (--mux->count == 0) {
+        __sync_lock_release(&mux->owner);
+    }
+    coreMasks[core].unlock();
+}
+
+// ==========================================
+// PINS
+// ==========================================
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (validPin(pin) && (mode & PULLDOWN) && !(mode & PULLUP)) {
+        pins[pin].level.store(LOW);
+    }
+}
+
+int digitalRead(uint8_t pin) {
+    return validPin(pin) ? pins[pin].level.load(std::memory_order_acquire) : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if (validPin(pin)) {
+        pins[pin].level.store(value ? HIGH : LOW, std::memory_order_release);
+    }
+}
+
+uint16_t analogRead(uint8_t pin) {
+    return sim::analogLevel(pin);
+}
+
+int8_t digitalPinToAnalogChannel(uint8_t pin) {
+    // ESP32-S3: GPIO1-10 are ADC1 channels 0-9, GPIO11-20 ADC2 (10-19)
+    return (pin >= 1 && pin <= 20) ? (int8_t)(pin - 1) : -1;
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode) {
+    if (!validPin(pin)) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(attachLock);
+    pins[pin].handler = handler;
+    pins[pin].handlerArg = nullptr;
+    pins[pin].mode = mode;
+    pins[pin].core = Kernel::currentCore();     // The GPIO ISR service runs where it was installed
+}
+
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode) {
+    if (!validPin(pin)) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(attachLock);
+    pins[pin].handler = nullptr;
+    pins[pin].handlerArg = handler;
+    pins[pin].arg = arg;
+    pins[pin].mode = mode;
+    pins[pin].core = Kernel::currentCore();
+}
+
+void detachInterrupt(uint8_t pin) {
+    if (!validPin(pin)) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(attachLock);
+    pins[pin].handler = nullptr;
+    pins[pin].handlerArg = nullptr;
+    pins[pin].mode = 0;
+}
+
+namespace sim {
+
+static bool triggers(int mode, int level) {
+    switch (mode) {
+        case RISING:  return level == HIGH;
+        case FALLING: return level == LOW;
+        case CHANGE:  return true;
+        case ONLOW:   return level == LOW;
+        case ONHIGH:  return level == HIGH;
+        default:      return false;
+    }
+}
+
+void setPin(int pin, int level) {
+    if (!validPin(pin)) {
+        return;
+    }
+    level = level ? HIGH : LOW;
+    if (pins[pin].level.exchange(level, std::memory_order_acq_rel) == level) {
+        return;     // No edge
+    }
+
+    void (*handler)(void);
+    void (*handlerArg)(void*);
+    void* arg;
+    int mode;
+    int core;
+    {
+        std::lock_guard<std::mutex> guard(attachLock);
+        handler = pins[pin].handler;
+        handlerArg = pins[pin].handlerArg;
+        arg = pins[pin].arg;
+        mode = pins[pin].mode;
+        core = pins[pin].core;
+    }
+    if (!triggers(mode, level) || (!handler && !handlerArg)) {
+        return;
+    }
+
+    Kernel::enterIsr(core);
+    coreMasks[core].lock();
+    if (handler) {
+        handler();
+    } else {
+        handlerArg(arg);
+    }
+    coreMasks[core].unlock();
+    Kernel::exitIsr();
+}
+
+void setAnalog(int pin, uint16_t value) {
+    if (validPin(pin)) {
+        pins[pin].analog.store(value > 4095 ? 4095 : value, std::memory_order_release);
+    }
+}
+
+uint16_t analogLevel(int pin) {
+    return validPin(pin) ? pins[pin].analog.load(std::memory_order_acquire) : 0;
+}
+
+}   // namespace sim
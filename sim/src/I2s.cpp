@@ -0,0 +1,435 @@
+#include "driver/i2s.h"
+#include "driver/i2s_std.h"
+#include "Kernel.h"
+#include "Sim.h"
+#include <string.h>
+
+using sim::Kernel;
+
+/**
+ * I2S TX model
+ *
+ * The DMA ring is a FIFO of dma_buf_count x dma_buf_len frames. Every
+ * dma_buf_len frames of virtual time the DMA plays one buffer: it takes
+ * that much from the FIFO (zeros for whatever is missing, as with
+ * tx_desc_auto_clear), posts I2S_EVENT_TX_DONE - dropping the oldest event
+ * if the queue is full, like the driver's ISR - and hands the buffer to the
+ * WAV recorder. i2s_write() blocks while the FIFO is full.
+ *
+ * The channel driver (i2s_new_channel) plays the same clock from a ring of
+ * dma_desc_num buffers that the firmware writes into directly. A buffer
+ * is fetched as it starts playing, so a block written into it later is
+ * lost, as on the chip. When it ends, on_sent runs as an ISR with the
+ * buffer's address (then auto_clear, if set). It runs under the kernel
+ * lock - the FromISR calls know not to take it again - and without the
+ * core's interrupt mask, which would order the locks the other way round
+ * from the GPIO ISRs.
+ *
+ * Buffer times come from a frame count, so the DMA never drifts from the
+ * sample clock.
+ */
+namespace {
+
+struct Port : sim::Timer {
+    bool installed;
+    bool running;
+    uint32_t rate;
+    int slotBytes;
+    int channels;
+    int bufferFrames;
+    int bufferCount;
+    QueueHandle_t events;
+
+    uint8_t* fifo;
+    size_t capacity;            // Bytes
+    size_t head;                // Oldest byte
+    size_t count;
+    uint8_t* played;            // One DMA buffer, as sent to the DAC
+
+    // Channel driver: the firmware's own ring instead of the FIFO
+    bool channel;
+    bool autoClear;
+    uint8_t** ring;
+    i2s_isr_callback_t onSent;
+    void* callbackContext;
+    int isrCore;                // Core of the task that created the channel
+
+    uint64_t startNs;
+    uint64_t buffersPlayed;
+    uint64_t starvedBuffers;    // Went out at least partly empty
+    uint64_t framesWritten;
+
+    FILE* wav;
+    uint64_t wavBytes;
+
+    int frameBytes() const { return slotBytes * channels; }
+    size_t bufferBytes() const { return (size_t)bufferFrames * frameBytes(); }
+
+    uint64_t bufferEnd(uint64_t index) const {
+        return startNs + (index + 1) * (uint64_t)bufferFrames * 1000000000ull / rate;
+    }
+
+    void fire(uint64_t now) override;
+};
+
+Port ports[I2S_NUM_MAX];
+uint8_t wavBuffer[1 << 16];
+
+void writeLe(FILE* file, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        fputc((value >> (8 * i)) & 0xFF, file);
+    }
+}
+
+void writeWavHeader(Port& port) {
+    uint32_t dataBytes = (uint32_t)(port.wavBytes > 0xFFFFFFF0ull ? 0xFFFFFFF0ull : port.wavBytes);
+    fseek(port.wav, 0, SEEK_SET);
+    fwrite("RIFF", 1, 4, port.wav);
+    writeLe(port.wav, 36 + dataBytes, 4);
+    fwrite("WAVEfmt ", 1, 8, port.wav);
+    writeLe(port.wav, 16, 4);
+    writeLe(port.wav, 1, 2);                                        // PCM
+    writeLe(port.wav, port.channels, 2);
+    writeLe(port.wav, port.rate, 4);
+    writeLe(port.wav, port.rate * port.frameBytes(), 4);
+    writeLe(port.wav, port.frameBytes(), 2);
+    writeLe(port.wav, port.slotBytes * 8, 2);
+    fwrite("data", 1, 4, port.wav);
+    writeLe(port.wav, dataBytes, 4);
+}
+
+void Port::fire(uint64_t now) {
+    size_t want = bufferBytes();
+    if (ring) {
+        // `played` was fetched when this buffer started
+        if (wav) {
+            fwrite(played, 1, want, wav);
+            wavBytes += want;
+        }
+        int index = (int)(buffersPlayed % bufferCount);
+        if (onSent) {
+            i2s_event_data_t event = { &ring[index], want };
+            Kernel::enterIsr(isrCore);
+            onSent((i2s_chan_handle_t)this, &event, callbackContext);
+            Kernel::exitIsr();
+        }
+        if (autoClear) {
+            memset(ring[index], 0, want);
+        }
+        buffersPlayed++;
+        memcpy(played, ring[buffersPlayed % bufferCount], want);
+        at = running ? bufferEnd(buffersPlayed) : sim::Kernel::FOREVER;
+        return;
+    }
+
+    size_t take = count < want ? count : want;
+    for (size_t i = 0; i < take; i++) {
+        played[i] = fifo[(head + i) % capacity];
+    }
+    memset(played + take, 0, want - take);
+    head = (head + take) % capacity;
+    count -= take;
+    if (take < want) {
+        starvedBuffers++;
+    }
+
+    if (wav) {
+        fwrite(played, 1, want, wav);
+        wavBytes += want;
+    }
+
+    if (events) {
+        i2s_event_t event = { I2S_EVENT_TX_DONE, want };
+        sim::queueSendLocked(events, &event, true);
+    }
+    buffersPlayed++;
+    at = running ? bufferEnd(buffersPlayed) : sim::Kernel::FOREVER;
+    Kernel::poke();     // Space for a blocked i2s_write()
+}
+
+void restart(Port& port) {
+    port.startNs = Kernel::nowNs();
+    port.buffersPlayed = 0;
+    port.at = port.bufferEnd(0);
+    if (port.ring) {
+        memcpy(port.played, port.ring[0], port.bufferBytes());
+    }
+}
+
+void openWav(Port& port, int index) {
+    port.wav = nullptr;
+    port.wavBytes = 0;
+    if (index == I2S_NUM_0 && sim::options.wavPath) {
+        port.wav = fopen(sim::options.wavPath, "wb");
+        if (port.wav) {
+            // Buffered in static memory: recording must not allocate on the tasks it runs on
+            setvbuf(port.wav, (char*)wavBuffer, _IOFBF, sizeof(wavBuffer));
+            writeWavHeader(port);
+        } else {
+            fprintf(stderr, "[SIM] Can't write %s\n", sim::options.wavPath);
+        }
+    }
+}
+
+Port* portOf(i2s_chan_handle_t handle) {
+    return (Port*)handle;
+}
+
+}   // namespace
+
+esp_err_t i2s_driver_install(i2s_port_t index, const i2s_config_t* config, int queueSize, void* queue) {
+    if (index >= I2S_NUM_MAX || !config || !(config->mode & I2S_MODE_TX)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    Kernel::Lock held(Kernel::mutex());
+    Port& port = ports[index];
+    if (port.installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    port.rate = config->sample_rate;
+    int bits = (int)config->bits_per_chan > (int)config->bits_per_sample ? (int)config->bits_per_chan
+                                                                        : (int)config->bits_per_sample;
+    port.slotBytes = bits <= 8 ? 1 : bits <= 16 ? 2 : 4;
+    port.channels = config->channel_format == I2S_CHANNEL_FMT_RIGHT_LEFT ||
+                    config->channel_format == I2S_CHANNEL_FMT_ALL_RIGHT ||
+                    config->channel_format == I2S_CHANNEL_FMT_ALL_LEFT ? 2 : 1;
+    port.bufferFrames = config->dma_buf_len;
+    port.bufferCount = config->dma_buf_count;
+    port.capacity = (size_t)port.bufferCount * port.bufferBytes();
+    port.fifo = new uint8_t[port.capacity];
+    port.played = new uint8_t[port.bufferBytes()];
+    port.head = 0;
+    port.count = 0;
+    port.starvedBuffers = 0;
+    port.framesWritten = 0;
+    port.events = nullptr;
+
+    if (queueSize > 0 && queue) {
+        port.events = xQueueCreate(queueSize, sizeof(i2s_event_t));
+        *(QueueHandle_t*)queue = port.events;
+    }
+
+    openWav(port, index);
+
+    // The driver starts the DMA on install, playing silence
+    port.installed = true;
+    port.running = true;
+    restart(port);
+    Kernel::addTimer(&port);
+    return ESP_OK;
+}
+
+esp_err_t i2s_driver_uninstall(i2s_port_t index) {
+    Kernel::Lock held(Kernel::mutex());
+    Port& port = ports[index];
+    port.running = false;
+    port.at = Kernel::FOREVER;
+    return ESP_OK;
+}
+
+esp_err_t i2s_set_pin(i2s_port_t index, const i2s_pin_config_t* pins) {
+    return ports[index].installed ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t i2s_set_clk(i2s_port_t index, uint32_t rate, uint32_t bits, i2s_channel_t channels) {
+    Kernel::Lock held(Kernel::mutex());
+    Port& port = ports[index];
+    if (!port.installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    int slotBytes = bits <= 8 ? 1 : bits <= 16 ? 2 : 4;
+    if (slotBytes != port.slotBytes || (int)channels != port.channels) {
+        // A new frame size would need a new ring; the firmware never does this
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (rate != port.rate) {
+        port.rate = rate;
+        restart(port);
+    }
+    return ESP_OK;
+}
+
+esp_err_t i2s_write(i2s_port_t index, const void* src, size_t size, size_t* written, TickType_t ticks) {
+    Kernel::Lock held(Kernel::mutex());
+    Port& port = ports[index];
+    *written = 0;
+    if (!port.installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    const uint8_t* bytes = (const uint8_t*)src;
+    uint64_t deadline = Kernel::afterMs(ticks);
+    auto space = [&port]() { return port.count < port.capacity; };
+    while (*written < size) {
+        if (!Kernel::blockUntil(held, deadline, space)) {
+            break;
+        }
+        size_t room = port.capacity - port.count;
+        size_t chunk = size - *written < room ? size - *written : room;
+        for (size_t i = 0; i < chunk; i++) {
+            port.fifo[(port.head + port.count + i) % port.capacity] = bytes[*written + i];
+        }
+        port.count += chunk;
+        *written += chunk;
+    }
+    port.framesWritten += *written / port.frameBytes();
+    return ESP_OK;
+}
+
+esp_err_t i2s_zero_dma_buffer(i2s_port_t index) {
+    Kernel::Lock held(Kernel::mutex());
+    ports[index].count = 0;
+    Kernel::poke();
+    return ESP_OK;
+}
+
+esp_err_t i2s_new_channel(const i2s_chan_config_t* config, i2s_chan_handle_t* tx, i2s_chan_handle_t* rx) {
+    if (!config || config->id >= I2S_NUM_MAX || !tx || rx || config->role != I2S_ROLE_MASTER ||
+        config->dma_desc_num < 2) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    Kernel::Lock held(Kernel::mutex());
+    Port& port = ports[config->id];
+    if (port.installed) {
+        return ESP_ERR_NOT_FOUND;       // No free channel on the port
+    }
+    port.installed = true;
+    port.channel = true;
+    port.running = false;
+    port.autoClear = config->auto_clear;
+    port.bufferCount = (int)config->dma_desc_num;
+    port.bufferFrames = (int)config->dma_frame_num;
+    port.ring = nullptr;
+    port.onSent = nullptr;
+    port.callbackContext = nullptr;
+    port.isrCore = Kernel::currentCore();
+    port.events = nullptr;
+    port.at = Kernel::FOREVER;
+    Kernel::addTimer(&port);
+    *tx = (i2s_chan_handle_t)&port;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_init_std_mode(i2s_chan_handle_t handle, const i2s_std_config_t* config) {
+    Kernel::Lock held(Kernel::mutex());
+    Port* port = portOf(handle);
+    if (!port || !config) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (port->ring || port->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    int bits = (int)config->slot_cfg.slot_bit_width > (int)config->slot_cfg.data_bit_width
+                   ? (int)config->slot_cfg.slot_bit_width : (int)config->slot_cfg.data_bit_width;
+    port->rate = config->clk_cfg.sample_rate_hz;
+    port->slotBytes = bits <= 8 ? 1 : bits <= 16 ? 2 : 4;
+    port->channels = config->slot_cfg.slot_mode == I2S_SLOT_MODE_STEREO ? 2 : 1;
+
+    // Zeroed, as the driver allocates them
+    port->ring = new uint8_t*[port->bufferCount];
+    for (int i = 0; i < port->bufferCount; i++) {
+        port->ring[i] = new uint8_t[port->bufferBytes()]();
+    }
+    port->played = new uint8_t[port->bufferBytes()]();
+    port->starvedBuffers = 0;
+    port->framesWritten = 0;
+    openWav(*port, (int)(port - ports));
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_register_event_callback(i2s_chan_handle_t handle, const i2s_event_callbacks_t* callbacks,
+                                              void* context) {
+    Kernel::Lock held(Kernel::mutex());
+    Port* port = portOf(handle);
+    if (!port || !callbacks) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (port->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    port->onSent = callbacks->on_sent;
+    port->callbackContext = context;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_enable(i2s_chan_handle_t handle) {
+    Kernel::Lock held(Kernel::mutex());
+    Port* port = portOf(handle);
+    if (!port || !port->ring || port->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    port->running = true;
+    restart(*port);
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_disable(i2s_chan_handle_t handle) {
+    Kernel::Lock held(Kernel::mutex());
+    Port* port = portOf(handle);
+    if (!port || !port->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    port->running = false;
+    port->at = Kernel::FOREVER;
+    return ESP_OK;
+}
+
+esp_err_t i2s_del_channel(i2s_chan_handle_t handle) {
+    Kernel::Lock held(Kernel::mutex());
+    Port* port = portOf(handle);
+    if (!port || port->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    port->installed = false;
+    return ESP_OK;
+}
+
+esp_err_t i2s_start(i2s_port_t index) {
+    Kernel::Lock held(Kernel::mutex());
+    Port& port = ports[index];
+    if (port.installed && !port.running) {
+        port.running = true;
+        restart(port);
+    }
+    return ESP_OK;
+}
+
+esp_err_t i2s_stop(i2s_port_t index) {
+    Kernel::Lock held(Kernel::mutex());
+    ports[index].running = false;
+    ports[index].at = Kernel::FOREVER;
+    return ESP_OK;
+}
+
+namespace sim {
+
+void i2sClose() {
+    for (Port& port : ports) {
+        if (port.wav) {
+            writeWavHeader(port);
+            fclose(port.wav);
+            port.wav = nullptr;
+        }
+    }
+}
+
+void printI2sStats(FILE* out) {
+    const Port& port = ports[I2S_NUM_0];
+    if (!port.installed) {
+        fprintf(out, "[SIM] I2S: never installed\n");
+        return;
+    }
+    if (port.channel) {
+        fprintf(out, "[SIM] I2S: %d Hz, %d-bit slots x %d, channel driver (%d x %d frames), %llu DMA buffers played\n",
+                (int)port.rate, port.slotBytes * 8, port.channels, port.bufferCount, port.bufferFrames,
+                (unsigned long long)port.buffersPlayed);
+        return;
+    }
+    fprintf(out, "[SIM] I2S: %d Hz, %d-bit slots x %d, %llu frames written, %llu DMA buffers played, %llu starved\n",
+            (int)port.rate, port.slotBytes * 8, port.channels, (unsigned long long)port.framesWritten,
+            (unsigned long long)port.buffersPlayed, (unsigned long long)port.starvedBuffers);
+}
+
+}   // namespace sim
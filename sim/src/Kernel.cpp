@@ -0,0 +1,203 @@
+#include "Kernel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace sim {
+
+std::mutex Kernel::lock;
+std::atomic<uint64_t> Kernel::now(0);
+int Kernel::running = 0;
+std::vector<Kernel::Task*> Kernel::all;
+std::vector<Timer*> Kernel::timers;
+bool Kernel::realtime = false;
+double Kernel::speed = 1.0;
+std::chrono::steady_clock::time_point Kernel::wallStart;
+
+thread_local Kernel::Task* Kernel::self = nullptr;
+thread_local int Kernel::isrDepth = 0;
+thread_local int Kernel::isrCore = 0;
+thread_local bool Kernel::firing = false;
+
+static Kernel::Task* newTask(const char* name, uint32_t stackBytes, uint32_t priority, int core) {
+    Kernel::Task* task = new Kernel::Task();
+    strncpy(task->name, name, sizeof(task->name) - 1);
+    task->name[sizeof(task->name) - 1] = '\0';
+    task->core = core;
+    task->priority = priority;
+    task->stackBytes = stackBytes;
+    task->seed = 0x9E3779B9u * (uint32_t)(Kernel::tasks().size() + 1);
+    task->notifyValue = 0;
+    task->notifyPending = false;
+    task->blocked = false;
+    task->deleted = false;
+    task->deadline = Kernel::FOREVER;
+    task->ready = nullptr;
+    task->readyContext = nullptr;
+    return task;
+}
+
+void Kernel::begin(bool paced, double rate) {
+    Lock held(lock);
+    realtime = paced;
+    speed = rate > 0.0 ? rate : 1.0;
+    wallStart = std::chrono::steady_clock::now();
+
+    // Arduino runs setup() and loop() in "loopTask" on core 1
+    Task* task = newTask("loopTask", 8192, 1, 1);
+    all.push_back(task);
+    running++;
+    self = task;
+}
+
+uint64_t Kernel::afterMs(uint32_t ms) {
+    if (ms == 0xFFFFFFFFu) {
+        return FOREVER;
+    }
+    return nowNs() + (uint64_t)ms * 1000000ull;
+}
+
+Kernel::Task* Kernel::create(void (*entry)(void*), const char* name, uint32_t stackBytes, void* parameter,
+                             uint32_t priority, int core) {
+    Lock held(lock);
+    Task* task = newTask(name, stackBytes, priority, core);
+    all.push_back(task);
+    running++;      // Runnable from now on: time can't move before it starts
+
+    std::thread([task, entry, parameter]() {
+        self = task;
+        entry(parameter);
+        exitCurrent();      // FreeRTOS would assert on a task function returning
+    }).detach();
+    return task;
+}
+
+void Kernel::exitCurrent() {
+    Lock held(lock);
+    self->deleted = true;
+    block(held, FOREVER, nullptr, nullptr);
+    // Not reached: nothing wakes a deleted task before the process exits
+    for (;;) {
+        self->wake.wait(held);
+    }
+}
+
+int Kernel::currentCore() {
+    if (isrDepth > 0) {
+        return isrCore;
+    }
+    return (self && self->core >= 0 && self->core < 2) ? self->core : 0;
+}
+
+void Kernel::enterIsr(int core) {
+    if (isrDepth++ == 0) {
+        isrCore = core;
+    }
+}
+
+void Kernel::exitIsr() {
+    isrDepth--;
+}
+
+bool Kernel::block(Lock& held, uint64_t deadline, Ready ready, void* context) {
+    Task* task = self;
+    if (!task) {
+        fprintf(stderr, "[SIM] blocking call from a thread that is not a task\n");
+        abort();
+    }
+
+    while (true) {
+        if (ready && ready(context)) {
+            return true;
+        }
+        if (nowNs() >= deadline) {
+            return false;
+        }
+
+        task->blocked = true;
+        task->deadline = deadline;
+        task->ready = ready;
+        task->readyContext = context;
+        if (--running == 0) {
+            advance(held);
+        }
+        while (task->blocked) {
+            task->wake.wait(held);
+        }
+        // Another task may have taken what woke us: check again
+    }
+}
+
+void Kernel::poke() {
+    uint64_t t = nowNs();
+    for (Task* task : all) {
+        if (!task->blocked || task->deleted) {
+            continue;
+        }
+        if (t >= task->deadline || (task->ready && task->ready(task->readyContext))) {
+            task->blocked = false;
+            running++;
+            task->wake.notify_one();
+        }
+    }
+}
+
+void Kernel::addTimer(Timer* timer) {
+    timers.push_back(timer);
+}
+
+void Kernel::advance(Lock& held) {
+    // Every task is blocked: jump to whatever happens next
+    while (running == 0) {
+        uint64_t next = FOREVER;
+        for (Task* task : all) {
+            if (task->blocked && !task->deleted && task->deadline < next) {
+                next = task->deadline;
+            }
+        }
+        for (Timer* timer : timers) {
+            if (timer->at < next) {
+                next = timer->at;
+            }
+        }
+        if (next == FOREVER) {
+            deadlock();
+        }
+
+        if (realtime) {
+            // Nothing else can change state while every task is blocked
+            held.unlock();
+            std::this_thread::sleep_until(wallStart + std::chrono::nanoseconds((uint64_t)(next / speed)));
+            held.lock();
+        }
+
+        if (next > nowNs()) {
+            now.store(next, std::memory_order_release);
+        }
+        for (Timer* timer : timers) {
+            while (timer->at <= next) {
+                uint64_t at = timer->at;
+                firing = true;
+                timer->fire(at);
+                firing = false;
+                if (timer->at == at) {
+                    timer->at = FOREVER;    // Didn't re-arm
+                }
+            }
+        }
+        poke();
+    }
+}
+
+void Kernel::deadlock() {
+    fprintf(stderr, "[SIM] Deadlock at %.3f s: every task is blocked with no timeout and no timer is armed\n",
+            nowNs() / 1e9);
+    for (Task* task : all) {
+        fprintf(stderr, "[SIM]   %-16s core %d %s\n", task->name, task->core,
+                task->deleted ? "deleted" : task->blocked ? "blocked" : "running");
+    }
+    fflush(stderr);
+    abort();
+}
+
+}   // namespace sim
@@ -0,0 +1,134 @@
+#ifndef SIM_KERNEL_H
+#define SIM_KERNEL_H
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Virtual-time scheduler under the simulated FreeRTOS
+ *
+ * Every task is a host thread. Tasks run freely (and truly in parallel)
+ * until they block in the kernel - vTaskDelay, a queue, a notification,
+ * i2s_write, an ADC read. Virtual time only moves when EVERY task is
+ * blocked: it then jumps to the nearest deadline or timer, fires the
+ * timers due (the I2S DMA, the ADC), and wakes whoever can run. So code
+ * takes no virtual time at all, and an hour of firmware runs as fast as
+ * the host can execute it - while millis(), tick timeouts, debounce and
+ * the DMA all stay consistent with each other. Realtime mode paces the
+ * jumps against the wall clock instead (for listening, or a live perf).
+ *
+ * One lock guards all kernel state, peripheral models included. Waking is
+ * done by the side that changes state (poke()), so a task the kernel
+ * counts as runnable is always really about to run - time can't slip
+ * past it.
+ *
+ * Not modelled: priorities, preemption and core pinning (two tasks
+ * "on core 1" may run at once; interrupt masking is per core, see
+ * Gpio.cpp). A task that busy-waits on another thread without
+ * blocking works; one that busy-waits on millis() would hang the clock.
+ */
+namespace sim {
+
+struct Timer {
+    uint64_t at;                                // Virtual ns, UINT64_MAX = idle
+    virtual ~Timer() {}
+    virtual void fire(uint64_t now) = 0;        // Kernel lock held; re-arm by setting `at`
+};
+
+class Kernel {
+public:
+    static const uint64_t FOREVER = UINT64_MAX;
+    typedef std::unique_lock<std::mutex> Lock;
+    typedef bool (*Ready)(void* context);
+
+    struct Task {
+        char name[16];
+        int core;
+        uint32_t priority;
+        uint32_t stackBytes;
+        uint32_t seed;                          // random() stream
+
+        // Notification (one slot, as configTASK_NOTIFICATION_ARRAY_ENTRIES = 1)
+        uint32_t notifyValue;
+        bool notifyPending;
+
+        // Blocking state, kernel lock held
+        bool blocked;
+        bool deleted;
+        uint64_t deadline;
+        Ready ready;
+        void* readyContext;
+        std::condition_variable wake;
+    };
+
+    static void begin(bool realtime, double speed);     // Registers the calling thread as loopTask
+    static std::mutex& mutex() { return lock; }
+
+    // Time, lock-free
+    static uint64_t nowNs() { return now.load(std::memory_order_acquire); }
+    static uint64_t afterMs(uint32_t ms);               // Deadline ms from now, FOREVER for portMAX_DELAY
+
+    // Tasks
+    static Task* create(void (*entry)(void*), const char* name, uint32_t stackBytes, void* parameter,
+                        uint32_t priority, int core);
+    static Task* current() { return self; }
+    static void exitCurrent();                          // Never returns
+    static int currentCore();                           // ISR core inside an ISR
+
+    /**
+     * Block the calling task until ready(context) or the deadline
+     *
+     * Kernel lock held. Returns true if ready, false on timeout.
+     */
+    static bool block(Lock& held, uint64_t deadline, Ready ready, void* context);
+
+    template <typename F>
+    static bool blockUntil(Lock& held, uint64_t deadline, F& ready) {
+        return block(held, deadline, [](void* c) { return (*static_cast<F*>(c))(); }, &ready);
+    }
+    static void sleepUntil(Lock& held, uint64_t deadline) { block(held, deadline, nullptr, nullptr); }
+
+    // Kernel lock held: wake every task whose condition now holds
+    static void poke();
+
+    // Kernel lock held
+    static void addTimer(Timer* timer);
+
+    // ISR context: ISRs run on the thread that raised them, as if on `core`
+    static void enterIsr(int core);
+    static void exitIsr();
+    static bool inIsr() { return isrDepth > 0; }
+
+    // A timer is firing on this thread, so the kernel lock is held: ISRs
+    // a peripheral model raises from fire() must not take it again
+    static bool inTimer() { return firing; }
+
+    static std::vector<Task*>& tasks() { return all; }
+
+private:
+    static std::mutex lock;
+    static std::atomic<uint64_t> now;
+    static int running;                     // Tasks not blocked in the kernel
+    static std::vector<Task*> all;
+    static std::vector<Timer*> timers;
+    static bool realtime;
+    static double speed;
+    static std::chrono::steady_clock::time_point wallStart;
+
+    static thread_local Task* self;
+    static thread_local int isrDepth;
+    static thread_local int isrCore;
+    static thread_local bool firing;
+
+    static void advance(Lock& held);
+    static void deadlock();
+};
+
+}   // namespace sim
+
+#endif
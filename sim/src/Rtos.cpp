@@ -0,0 +1,320 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "Kernel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using sim::Kernel;
+
+static inline Kernel::Task* taskOf(TaskHandle_t handle) {
+    return reinterpret_cast<Kernel::Task*>(handle);
+}
+
+static inline TaskHandle_t handleOf(Kernel::Task* task) {
+    return reinterpret_cast<TaskHandle_t>(task);
+}
+
+// ==========================================
+// TASKS
+// ==========================================
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth, void* parameters,
+                                   UBaseType_t priority, TaskHandle_t* created, BaseType_t core) {
+    int pinned = (core == 0 || core == 1) ? core : 0;
+    Kernel::Task* task = Kernel::create(code, name ? name : "", stackDepth, parameters, priority, pinned);
+    if (created) {
+        *created = handleOf(task);
+    }
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth, void* parameters,
+                       UBaseType_t priority, TaskHandle_t* created) {
+    return xTaskCreatePinnedToCore(code, name, stackDepth, parameters, priority, created, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task == nullptr || taskOf(task) == Kernel::current()) {
+        Kernel::exitCurrent();
+    }
+    // Deleting another task would need it to reach a kernel call first
+    fprintf(stderr, "[SIM] vTaskDelete(%s) from another task is not supported\n", taskOf(task)->name);
+    abort();
+}
+
+void vTaskDelay(TickType_t ticks) {
+    Kernel::Lock held(Kernel::mutex());
+    Kernel::sleepUntil(held, Kernel::afterMs(ticks));
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)(Kernel::nowNs() / 1000000ull);
+}
+
+TickType_t xTaskGetTickCountFromISR() {
+    return xTaskGetTickCount();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return handleOf(Kernel::current());
+}
+
+const char* pcTaskGetName(TaskHandle_t task) {
+    Kernel::Task* t = task ? taskOf(task) : Kernel::current();
+    return t ? t->name : "";
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    // Host stacks are not measured: report the whole stack as never used
+    Kernel::Task* t = task ? taskOf(task) : Kernel::current();
+    return t ? t->stackBytes : 0;
+}
+
+void simYield() {
+    std::this_thread::yield();
+}
+
+void simAssertFailed(const char* file, int line) {
+    fprintf(stderr, "[SIM] configASSERT failed at %s:%d\n", file, line);
+    abort();
+}
+
+BaseType_t xPortGetCoreID() {
+    return Kernel::currentCore();
+}
+
+BaseType_t xPortInIsrContext() {
+    return Kernel::inIsr() ? pdTRUE : pdFALSE;
+}
+
+// ISRs raised from a peripheral model's timer already hold the kernel lock
+static Kernel::Lock isrLock() {
+    if (Kernel::inTimer()) {
+        return Kernel::Lock(Kernel::mutex(), std::defer_lock);
+    }
+    return Kernel::Lock(Kernel::mutex());
+}
+
+// ==========================================
+// TASK NOTIFICATIONS
+// ==========================================
+static BaseType_t notifyLocked(Kernel::Task* task, uint32_t value, eNotifyAction action) {
+    BaseType_t result = pdPASS;
+    switch (action) {
+        case eNoAction:
+            break;
+        case eSetBits:
+            task->notifyValue |= value;
+            break;
+        case eIncrement:
+            task->notifyValue++;
+            break;
+        case eSetValueWithOverwrite:
+            task->notifyValue = value;
+            break;
+        case eSetValueWithoutOverwrite:
+            if (task->notifyPending) {
+                result = pdFAIL;
+            } else {
+                task->notifyValue = value;
+            }
+            break;
+    }
+    task->notifyPending = true;
+    Kernel::poke();
+    return result;
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action) {
+    Kernel::Lock held(Kernel::mutex());
+    return notifyLocked(taskOf(task), value, action);
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t* woken) {
+    if (woken) {
+        *woken = pdFALSE;
+    }
+    Kernel::Lock held = isrLock();
+    return notifyLocked(taskOf(task), value, action);
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    return xTaskNotify(task, 0, eIncrement);
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken) {
+    xTaskNotifyFromISR(task, 0, eIncrement, woken);
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clearOnEntry, uint32_t clearOnExit, uint32_t* value, TickType_t ticks) {
+    Kernel::Lock held(Kernel::mutex());
+    Kernel::Task* self = Kernel::current();
+
+    if (!self->notifyPending) {
+        self->notifyValue &= ~clearOnEntry;
+    }
+    auto pending = [self]() { return self->notifyPending; };
+    bool got = Kernel::blockUntil(held, Kernel::afterMs(ticks), pending);
+
+    if (value) {
+        *value = self->notifyValue;
+    }
+    if (!got) {
+        return pdFALSE;
+    }
+    self->notifyValue &= ~clearOnExit;
+    self->notifyPending = false;
+    return pdTRUE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    Kernel::Lock held(Kernel::mutex());
+    Kernel::Task* self = Kernel::current();
+
+    auto given = [self]() { return self->notifyValue != 0; };
+    Kernel::blockUntil(held, Kernel::afterMs(ticks), given);
+
+    uint32_t value = self->notifyValue;
+    if (value != 0) {
+        self->notifyValue = clearOnExit ? 0 : value - 1;
+    }
+    self->notifyPending = false;
+    return value;
+}
+
+// ==========================================
+// QUEUES
+// ==========================================
+struct QueueDefinition {
+    uint32_t length;
+    uint32_t itemSize;
+    uint32_t head;          // Oldest item
+    uint32_t count;
+    uint8_t* storage;
+
+    uint8_t* slot(uint32_t index) { return storage + ((head + index) % length) * itemSize; }
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    if (length == 0) {
+        return nullptr;
+    }
+    QueueDefinition* queue = new QueueDefinition();
+    queue->length = length;
+    queue->itemSize = itemSize;
+    queue->head = 0;
+    queue->count = 0;
+    queue->storage = new uint8_t[(size_t)length * (itemSize ? itemSize : 1)];
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    if (queue) {
+        delete[] queue->storage;
+        delete queue;
+    }
+}
+
+static BaseType_t sendLocked(Kernel::Lock& held, QueueHandle_t queue, const void* item, uint64_t deadline) {
+    auto space = [queue]() { return queue->count < queue->length; };
+    if (!Kernel::blockUntil(held, deadline, space)) {
+        return errQUEUE_FULL;
+    }
+    memcpy(queue->slot(queue->count), item, queue->itemSize);
+    queue->count++;
+    Kernel::poke();
+    return pdPASS;
+}
+
+static BaseType_t receiveLocked(Kernel::Lock& held, QueueHandle_t queue, void* item, uint64_t deadline, bool remove) {
+    auto data = [queue]() { return queue->count > 0; };
+    if (!Kernel::blockUntil(held, deadline, data)) {
+        return errQUEUE_EMPTY;
+    }
+    memcpy(item, queue->slot(0), queue->itemSize);
+    if (remove) {
+        queue->head = (queue->head + 1) % queue->length;
+        queue->count--;
+        Kernel::poke();
+    }
+    return pdPASS;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    Kernel::Lock held(Kernel::mutex());
+    return sendLocked(held, queue, item, Kernel::afterMs(ticks));
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    return xQueueSend(queue, item, ticks);
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* woken) {
+    if (woken) {
+        *woken = pdFALSE;
+    }
+    Kernel::Lock held = isrLock();
+    return sendLocked(held, queue, item, 0);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void* item) {
+    Kernel::Lock held(Kernel::mutex());
+    queue->count = 0;
+    return sendLocked(held, queue, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks) {
+    Kernel::Lock held(Kernel::mutex());
+    return receiveLocked(held, queue, item, Kernel::afterMs(ticks), true);
+}
+
+BaseType_t xQueueReceiveFromISR(QueueHandle_t queue, void* item, BaseType_t* woken) {
+    if (woken) {
+        *woken = pdFALSE;
+    }
+    Kernel::Lock held = isrLock();
+    return receiveLocked(held, queue, item, 0, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void* item, TickType_t ticks) {
+    Kernel::Lock held(Kernel::mutex());
+    return receiveLocked(held, queue, item, Kernel::afterMs(ticks), false);
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+    Kernel::Lock held(Kernel::mutex());
+    queue->head = 0;
+    queue->count = 0;
+    Kernel::poke();
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    Kernel::Lock held(Kernel::mutex());
+    return queue->count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) {
+    Kernel::Lock held(Kernel::mutex());
+    return queue->length - queue->count;
+}
+
+namespace sim {
+
+// Peripheral models post events with the kernel lock already held
+bool queueSendLocked(QueueHandle_t queue, const void* item, bool dropOldest) {
+    if (queue->count >= queue->length) {
+        if (!dropOldest) {
+            return false;
+        }
+        queue->head = (queue->head + 1) % queue->length;
+        queue->count--;
+    }
+    memcpy(queue->slot(queue->count), item, queue->itemSize);
+    queue->count++;
+    Kernel::poke();
+    return true;
+}
+
+}   // namespace sim
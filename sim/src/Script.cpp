@@ -0,0 +1,267 @@
+#include <Arduino.h>
+#include <string>
+#include <vector>
+#include "freertos/task.h"
+#include "Kernel.h"
+#include "Sim.h"
+
+using sim::Kernel;
+
+/**
+ * Input script (format in Sim.h)
+ *
+ * The whole file is parsed before the firmware boots, so a typo fails
+ * fast instead of an hour of virtual time in. It then runs as a task of
+ * its own on core 1 - like a hand on the controls - sleeping in virtual
+ * time between commands.
+ */
+namespace {
+
+enum Op { WAIT, AT, POT, PRESS, TURN, PIN, SERIAL_LINE, SCREEN, MARK, END };
+
+struct Command {
+    Op op;
+    int line;
+    long a;
+    long b;
+    long c;
+    long d;
+    std::string text;
+};
+
+std::vector<Command> commands;
+bool loaded = false;
+
+// Encoder: 4 transitions per detent, each held longer than its 2 ms debounce
+const uint32_t MIN_TRANSITION_MS = 3;
+
+void sleepMs(uint32_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+void sleepUntilMs(uint64_t ms) {
+    Kernel::Lock held(Kernel::mutex());
+    Kernel::sleepUntil(held, ms * 1000000ull);
+}
+
+bool parseLong(const char* text, long* value) {
+    char* end;
+    *value = strtol(text, &end, 0);
+    return end != text && *end == '\0';
+}
+
+int potPin(const char* name) {
+    if (strcmp(name, "pitch") == 0) {
+        return sim::PIN_POT_PITCH;
+    }
+    if (strcmp(name, "tone") == 0) {
+        return sim::PIN_POT_TONE;
+    }
+    long gpio;
+    return parseLong(name, &gpio) ? (int)gpio : -1;
+}
+
+bool parse(char* text, int lineNumber, Command* command) {
+    command->line = lineNumber;
+    command->a = command->b = command->c = command->d = 0;
+
+    char* args[5] = {};
+    int count = 0;
+    char* rest = nullptr;
+    for (char* token = strtok_r(text, " \t", &rest); token && count < 5; token = strtok_r(nullptr, " \t", &rest)) {
+        args[count++] = token;
+        if (count == 1 && (strcmp(token, "serial") == 0 || strcmp(token, "mark") == 0)) {
+            // Everything after the command is the text, spaces and all
+            while (rest && (*rest == ' ' || *rest == '\t')) {
+                rest++;
+            }
+            command->op = token[0] == 's' ? SERIAL_LINE : MARK;
+            command->text = rest ? rest : "";
+            return true;
+        }
+    }
+    const char* name = args[0];
+    long values[4] = {};
+    for (int i = 1; i < count; i++) {
+        if (!parseLong(args[i], &values[i - 1]) && !(i == 1 && strcmp(name, "pot") == 0)) {
+            return false;
+        }
+    }
+
+    if (strcmp(name, "wait") == 0 && count == 2) {
+        command->op = WAIT;
+        command->a = values[0];
+    } else if (strcmp(name, "at") == 0 && count == 2) {
+        command->op = AT;
+        command->a = values[0];
+    } else if (strcmp(name, "pot") == 0 && (count == 3 || count == 5)) {
+        command->op = POT;
+        command->a = potPin(args[1]);
+        command->b = values[1];
+        command->c = count == 5 ? values[2] : values[1];
+        command->d = count == 5 ? values[3] : 0;
+        if (command->a < 0) {
+            return false;
+        }
+    } else if ((strcmp(name, "press") == 0 || strcmp(name, "hold") == 0) && count <= 2) {
+        command->op = PRESS;
+        command->a = count == 2 ? values[0] : (name[0] == 'p' ? 80 : 1500);
+    } else if (strcmp(name, "turn") == 0 && (count == 2 || count == 3)) {
+        command->op = TURN;
+        command->a = values[0];
+        command->b = count == 3 ? values[1] : 40;
+    } else if (strcmp(name, "pin") == 0 && count == 3) {
+        command->op = PIN;
+        command->a = values[0];
+        command->b = values[1];
+    } else if (strcmp(name, "screen") == 0 && count == 1) {
+        command->op = SCREEN;
+    } else if (strcmp(name, "end") == 0 && count == 1) {
+        command->op = END;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void turn(long detents, long periodMs) {
+    // (CLK, DT) per detent: CW 11 -> 01 -> 00 -> 10 -> 11, CCW the reverse
+    static const uint8_t CW[4][2] = { {0, 1}, {0, 0}, {1, 0}, {1, 1} };
+    static const uint8_t CCW[4][2] = { {1, 0}, {0, 0}, {0, 1}, {1, 1} };
+    const uint8_t (*steps)[2] = detents > 0 ? CW : CCW;
+    uint32_t stepMs = (uint32_t)periodMs / 4;
+    if (stepMs < MIN_TRANSITION_MS) {
+        stepMs = MIN_TRANSITION_MS;
+    }
+
+    for (long n = detents > 0 ? detents : -detents; n > 0; n--) {
+        for (int i = 0; i < 4; i++) {
+            sim::setPin(sim::PIN_ENCODER_CLK, steps[i][0]);
+            sim::setPin(sim::PIN_ENCODER_DT, steps[i][1]);
+            sleepMs(stepMs);
+        }
+    }
+}
+
+void run(const Command& command) {
+    switch (command.op) {
+        case WAIT:
+            sleepMs((uint32_t)command.a);
+            break;
+
+        case AT:
+            sleepUntilMs((uint64_t)command.a);
+            break;
+
+        case POT: {
+            // Ramps move one step per millisecond
+            long from = command.b;
+            long to = command.c;
+            for (long t = 1; t < command.d; t++) {
+                sim::setAnalog((int)command.a, (uint16_t)constrain(from + (to - from) * t / command.d, 0, 4095));
+                sleepMs(1);
+            }
+            sim::setAnalog((int)command.a, (uint16_t)constrain(to, 0, 4095));
+            break;
+        }
+
+        case PRESS:
+            sim::setPin(sim::PIN_BUTTON, LOW);
+            sleepMs((uint32_t)command.a);
+            sim::setPin(sim::PIN_BUTTON, HIGH);
+            break;
+
+        case TURN:
+            turn(command.a, command.b);
+            break;
+
+        case PIN:
+            sim::setPin((int)command.a, command.b ? HIGH : LOW);
+            break;
+
+        case SERIAL_LINE:
+            sim::typeLine(command.text.c_str());
+            break;
+
+        case SCREEN:
+            sim::serialFlush();
+            sim::printScreen(stdout);
+            sim::serialFlush();
+            break;
+
+        case MARK:
+            Serial.printf("[SIM] ---- %s\n", command.text.c_str());
+            break;
+
+        case END:
+            sim::finish(0);
+    }
+}
+
+void scriptTask(void* parameter) {
+    for (const Command& command : commands) {
+        run(command);
+    }
+    if (sim::options.seconds <= 0.0) {
+        sleepMs(50);        // Let the last log lines drain
+        sim::finish(0);
+    }
+    vTaskDelete(nullptr);
+}
+
+void stopTask(void* parameter) {
+    sleepUntilMs((uint64_t)(sim::options.seconds * 1000.0));
+    sim::finish(0);
+}
+
+}   // namespace
+
+namespace sim {
+
+bool loadScript(const char* path) {
+    FILE* file = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "[SIM] Can't open script %s\n", path);
+        return false;
+    }
+
+    char line[512];
+    int lineNumber = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        char* comment = strchr(line, '#');
+        if (comment && strncmp(line, "serial", 6) != 0 && strncmp(line, "mark", 4) != 0) {
+            *comment = '\0';
+        }
+        line[strcspn(line, "\r\n")] = '\0';
+        char* text = line + strspn(line, " \t");
+        if (*text == '\0') {
+            continue;
+        }
+
+        Command command;
+        if (!parse(text, lineNumber, &command)) {
+            fprintf(stderr, "[SIM] %s:%d: can't parse \"%s\"\n", path, lineNumber, line);
+            ok = false;
+            continue;
+        }
+        commands.push_back(command);
+    }
+    if (file != stdin) {
+        fclose(file);
+    }
+    loaded = ok;
+    return ok;
+}
+
+void startScript() {
+    if (loaded) {
+        xTaskCreatePinnedToCore(scriptTask, "script", 4096, nullptr, 1, nullptr, 1);
+    }
+    if (options.seconds > 0.0) {
+        xTaskCreatePinnedToCore(stopTask, "stop", 2048, nullptr, 1, nullptr, 1);
+    }
+}
+
+}   // namespace sim
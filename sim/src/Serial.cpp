@@ -0,0 +1,153 @@
+#include <Arduino.h>
+#include <mutex>
+#include "Kernel.h"
+#include "Sim.h"
+
+/**
+ * Serial: output to stdout, prefixed with virtual time like the
+ * monitor's "time" filter; input is what the script types
+ */
+HardwareSerial Serial;
+
+static std::mutex outputLock;
+static bool lineStart = true;
+
+static std::mutex inputLock;
+static char input[1024];
+static size_t inputHead = 0;        // Next to read
+static size_t inputTail = 0;        // Next to write
+
+static void emit(const char* text, size_t length) {
+    std::lock_guard<std::mutex> guard(outputLock);
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] == '\r') {
+            continue;       // println()'s CR: plain newlines on the host
+        }
+        if (lineStart && sim::options.timestamps) {
+            uint64_t us = sim::Kernel::nowNs() / 1000;
+            fprintf(stdout, "%5lu.%03lu > ", (unsigned long)(us / 1000000), (unsigned long)(us / 1000 % 1000));
+        }
+        fputc(text[i], stdout);
+        lineStart = text[i] == '\n';
+    }
+}
+
+void HardwareSerial::begin(unsigned long baud) {
+}
+
+int HardwareSerial::available() {
+    std::lock_guard<std::mutex> guard(inputLock);
+    return (int)(inputTail - inputHead);
+}
+
+int HardwareSerial::read() {
+    std::lock_guard<std::mutex> guard(inputLock);
+    if (inputHead == inputTail) {
+        return -1;
+    }
+    return (uint8_t)input[inputHead++ % sizeof(input)];
+}
+
+int HardwareSerial::peek() {
+    std::lock_guard<std::mutex> guard(inputLock);
+    return inputHead == inputTail ? -1 : (uint8_t)input[inputHead % sizeof(input)];
+}
+
+int HardwareSerial::availableForWrite() {
+    return 256;
+}
+
+void HardwareSerial::flush() {
+    std::lock_guard<std::mutex> guard(outputLock);
+    fflush(stdout);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    char text = (char)c;
+    emit(&text, 1);
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    emit((const char*)buffer, size);
+    return size;
+}
+
+size_t HardwareSerial::print(const char* text) {
+    size_t length = strlen(text);
+    emit(text, length);
+    return length;
+}
+
+size_t HardwareSerial::print(char c) {
+    return write((uint8_t)c);
+}
+
+size_t HardwareSerial::print(int value) {
+    return printf("%d", value);
+}
+
+size_t HardwareSerial::print(unsigned int value) {
+    return printf("%u", value);
+}
+
+size_t HardwareSerial::print(long value) {
+    return printf("%ld", value);
+}
+
+size_t HardwareSerial::print(unsigned long value) {
+    return printf("%lu", value);
+}
+
+size_t HardwareSerial::print(double value, int digits) {
+    return printf("%.*f", digits, value);
+}
+
+size_t HardwareSerial::println() {
+    return print("\r\n");
+}
+
+size_t HardwareSerial::println(const char* text) {
+    return print(text) + println();
+}
+
+size_t HardwareSerial::println(int value) {
+    return print(value) + println();
+}
+
+size_t HardwareSerial::println(unsigned long value) {
+    return print(value) + println();
+}
+
+size_t HardwareSerial::printf(const char* format, ...) {
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0) {
+        return 0;
+    }
+    size_t written = (size_t)length < sizeof(buffer) ? (size_t)length : sizeof(buffer) - 1;
+    emit(buffer, written);
+    return written;
+}
+
+namespace sim {
+
+void typeLine(const char* line) {
+    std::lock_guard<std::mutex> guard(inputLock);
+    for (const char* c = line; *c; c++) {
+        if (inputTail - inputHead < sizeof(input) - 1) {
+            input[inputTail++ % sizeof(input)] = *c;
+        }
+    }
+    input[inputTail++ % sizeof(input)] = '\n';
+}
+
+void serialFlush() {
+    std::lock_guard<std::mutex> guard(outputLock);
+    fflush(stdout);
+}
+
+}   // namespace sim
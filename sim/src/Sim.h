@@ -0,0 +1,129 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+/**
+ * eduLAB host simulator - the whole firmware on Linux, in virtual time
+ *
+ * Build and run (host):
+ *   pio run -e native
+ *   .pio/build/native/program [options] [script]
+ *
+ *   pio run -e native-asan        same, with AddressSanitizer + UBSan
+ *   pio run -e native-tsan        same, with ThreadSanitizer
+ *   pio run -e native-zerocopy    zero-copy I2S output (EDULAB_I2S_ZERO_COPY)
+ *
+ * Options:
+ *   -o, --wav <file>     record the I2S output (format as configured by the
+ *                        firmware: rate, slot width, channels)
+ *   --frames <file>      append every frame the display shows to <file>, as a
+ *                        stream of PBM images ("# t=<ms>" in each header)
+ *   --samples <file>     sample bank image (tools/pack_samples) to serve as
+ *                        the "samples" flash partition
+ *   --headless           no OLED answers on the I2C bus
+ *   --trace <file>       write the scope profiler's capture (Chrome trace
+ *                        JSON) at exit; needs -D EDULAB_PROFILE, see
+ *                        lib/Profiler
+ *   --seconds <s>        stop after <s> seconds of virtual time (default: at
+ *                        the end of the script, or 10 s without one)
+ *   --realtime[=<x>]     pace virtual time at <x> times the wall clock
+ *                        (default: as fast as the host can run)
+ *   --seed <n>           random() seed
+ *   --raw                no virtual timestamps on serial output
+ *
+ * src/main.cpp is built unchanged: setup() and loop() run on the main
+ * thread ("loopTask", core 1) and every xTaskCreate() starts a host thread.
+ * The stand-in headers in sim/include replace the Arduino core, FreeRTOS,
+ * the IDF drivers and the Adafruit display libraries. Peripherals are
+ * models driven by virtual time (Kernel.h):
+ *
+ *   I2S      DMA ring of the configured depth, played one DMA buffer at a
+ *            time at the sample rate; TX_DONE events, auto-clear on
+ *            underrun, output recorded to WAV. Also the IDF 5 channel
+ *            driver: the firmware's buffers played in place, on_sent
+ *            callbacks as ISRs
+ *   ADC      continuous mode at the configured conversion rate, values
+ *            from the script's pot settings
+ *   GPIO     pin levels set by the script; edges run the attached ISRs
+ *   SSD1306  1-bit framebuffer drawn by an Adafruit_GFX stand-in (classic
+ *            5x7 font); "screen" in a script prints it
+ *   Serial   stdout; the script's "serial" lines are typed into it
+ *
+ * Script (one command per line, '#' comments, times in virtual ms):
+ *   wait <ms>                    let time pass
+ *   at <ms>                      wait until <ms> since boot
+ *   pot <pitch|tone|gpio> <0-4095> [<to> <ms>]   set, or ramp over <ms>
+ *   press [ms]                   short press of the encoder button (80)
+ *   hold [ms]                    long press (1500)
+ *   turn <detents> [ms]          encoder, negative = counter-clockwise,
+ *                                <ms> between detents (40)
+ *   pin <gpio> <0|1>             raw pin level
+ *   serial <line>                console command, e.g. "serial lat"
+ *   screen                       print the display as text
+ *   mark <text>                  print a marker into the output
+ *   end                          stop here
+ *
+ * The firmware can't tell it is simulated: code takes no virtual time, so
+ * load figures come from the host's cycle counter fallback (CycleCounter.h)
+ * and the audio task never underruns for lack of CPU.
+ */
+namespace sim {
+
+struct Options {
+    const char* wavPath;
+    const char* framesPath;
+    const char* samplesPath;
+    const char* tracePath;
+    bool headless;
+    double seconds;             // 0 = until the script ends
+    bool realtime;
+    double speed;
+    uint32_t seed;
+    bool timestamps;
+};
+
+extern Options options;
+
+// Pins from src/main.cpp (HARDWARE CONFIGURATION)
+static const int PIN_BUTTON = 15;
+static const int PIN_ENCODER_CLK = 6;
+static const int PIN_ENCODER_DT = 7;
+static const int PIN_POT_PITCH = 1;
+static const int PIN_POT_TONE = 2;
+
+// Gpio.cpp: any task, never with the kernel lock held (ISRs take it)
+void setPin(int pin, int level);
+void setAnalog(int pin, uint16_t value);
+uint16_t analogLevel(int pin);          // 12-bit
+
+// Rtos.cpp: post from a peripheral model, kernel lock held
+bool queueSendLocked(QueueHandle_t queue, const void* item, bool dropOldest);
+
+// Display.cpp
+bool displayPresent();
+void printScreen(FILE* out);
+void closeFrames();
+
+// Serial.cpp
+void typeLine(const char* line);
+void serialFlush();
+
+// I2s.cpp / Adc.cpp
+void i2sClose();                        // Kernel lock held
+void printI2sStats(FILE* out);
+void printAdcStats(FILE* out);
+
+// Script.cpp
+bool loadScript(const char* path);
+void startScript();
+
+// SimMain.cpp: flush outputs and exit; kernel lock held or not
+[[noreturn]] void finish(int status);
+
+}   // namespace sim
+
+#endif
@@ -0,0 +1,120 @@
+#include <Arduino.h>
+#include <unistd.h>
+#include "Kernel.h"
+#include "Sim.h"
+#include "Profiler.h"
+
+using sim::Kernel;
+
+/**
+ * Entry point: options, then the Arduino core's own sequence - setup()
+ * once, loop() forever - on the main thread as loopTask
+ */
+namespace sim {
+
+Options options = { nullptr, nullptr, nullptr, nullptr, false, 0.0, false, 1.0, 0, true };
+
+static void writeTrace() {
+#ifdef EDULAB_PROFILE
+    if (!options.tracePath) {
+        return;
+    }
+    FILE* file = fopen(options.tracePath, "w");
+    if (!file) {
+        fprintf(stderr, "[SIM] Can't write %s\n", options.tracePath);
+        return;
+    }
+    Profiler::writeTrace([](const char* text, void* context) { fputs(text, (FILE*)context); }, file);
+    fclose(file);
+#endif
+}
+
+void finish(int status) {
+    {
+        // Stop the clock: nothing fires while the outputs are closed
+        Kernel::Lock held(Kernel::mutex());
+        i2sClose();
+        closeFrames();
+        serialFlush();
+        writeTrace();
+
+        fprintf(stderr, "[SIM] Stopped at %.3f s virtual time\n", Kernel::nowNs() / 1e9);
+        printI2sStats(stderr);
+        printAdcStats(stderr);
+        fflush(stderr);
+    }
+    _exit(status);      // Tasks are still parked on the kernel: don't run static destructors under them
+}
+
+}   // namespace sim
+
+static void usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [options] [script|-]\n"
+            "  -o, --wav <file>     record the audio output\n"
+            "  --frames <file>      record every display frame (PBM stream)\n"
+            "  --samples <file>     sample bank image for the \"samples\" partition\n"
+            "  --headless           no display on the I2C bus\n"
+            "  --trace <file>       write the profiler capture (EDULAB_PROFILE builds)\n"
+            "  --seconds <s>        stop after <s> s of virtual time\n"
+            "  --realtime[=<x>]     pace virtual time at <x> times the wall clock\n"
+            "  --seed <n>           random() seed\n"
+            "  --raw                no virtual timestamps on serial output\n",
+            program);
+}
+
+int main(int argc, char** argv) {
+    using sim::options;
+    const char* script = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if ((strcmp(arg, "-o") == 0 || strcmp(arg, "--wav") == 0) && hasValue) {
+            options.wavPath = argv[++i];
+        } else if (strcmp(arg, "--frames") == 0 && hasValue) {
+            options.framesPath = argv[++i];
+        } else if (strcmp(arg, "--samples") == 0 && hasValue) {
+            options.samplesPath = argv[++i];
+        } else if (strcmp(arg, "--trace") == 0 && hasValue) {
+            options.tracePath = argv[++i];
+        } else if (strcmp(arg, "--headless") == 0) {
+            options.headless = true;
+        } else if (strcmp(arg, "--seconds") == 0 && hasValue) {
+            options.seconds = atof(argv[++i]);
+        } else if (strcmp(arg, "--realtime") == 0) {
+            options.realtime = true;
+        } else if (strncmp(arg, "--realtime=", 11) == 0) {
+            options.realtime = true;
+            options.speed = atof(arg + 11);
+        } else if (strcmp(arg, "--seed") == 0 && hasValue) {
+            options.seed = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        } else if (strcmp(arg, "--raw") == 0) {
+            options.timestamps = false;
+        } else if ((arg[0] != '-' || strcmp(arg, "-") == 0) && !script) {
+            script = arg;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (script && !sim::loadScript(script)) {
+        return 1;
+    }
+    if (!script && options.seconds <= 0.0) {
+        options.seconds = 10.0;
+    }
+
+    Kernel::begin(options.realtime, options.speed);
+#ifdef EDULAB_PROFILE
+    if (options.tracePath) {
+        Profiler::start();
+    }
+#endif
+    setup();
+    sim::startScript();
+    while (true) {
+        loop();
+    }
+}
@@ -5,6 +5,17 @@
 #include "Button.h"
 #include "RotaryEncoder.h"
 #include "Potentiometer.h"
+#include "PotSampler.h"
+#include "UiEvents.h"
+#include "AllocCounter.h"
+#include "Console.h"
+#include "Telemetry.h"
+#include "LatencyTrace.h"
+#include "Profiler.h"
+#include "Log.h"
+#ifdef EDULAB_BENCHMARKS
+#include "Benchmarks.h"
+#endif
 #include "../include/Utils.h"
 
 // FreeRTOS headers for task management (built into ESP32)
@@ -34,6 +45,7 @@ Button button(SW_PIN);
 RotaryEncoder encoder(PIN_CLK, PIN_DT);
 Potentiometer potPitch(POT_PIN_PITCH);
 Potentiometer potTone(POT_PIN_TONE);
+PotSampler potSampler;   // ADC continuous mode, feeds both pots
 
 // ==========================================
 // DUAL-CORE ARCHITECTURE
@@ -54,7 +66,7 @@ TaskHandle_t audioTaskHandle;
  * @param parameter - Unused (required by FreeRTOS signature)
  */
 void audioTask(void* parameter) {
-    Serial.println("[Audio Task] Started on Core 0");
+    LOG("[Audio Task] Started on Core %d", xPortGetCoreID());
     
     // Infinite loop - like loop() but dedicated to audio
     while (true) {
@@ -78,19 +90,15 @@ void audioTask(void* parameter) {
 // SETUP
 // ==========================================
 void setup() {
+    // Boot order is audio first: nothing here may block before the audio
+    // task is running. Console output goes through LOG, so no waiting for
+    // the USB host to enumerate either.
     Serial.begin(115200);
-    delay(500);
+    Log::begin();            // Deferred logging for ISRs and the audio task
     
-    Serial.println("eduLAB v4.0 - Dual-Core Architecture");
-    Serial.println("=====================================");
-    
-    // Initialize hardware
-    button.begin();
-    encoder.begin();
-    potPitch.begin();
-    potTone.begin();
-    
-    displayManager.begin();  // I2C + OLED + Splash screen
+    LOG("eduLAB v4.0 - Dual-Core Architecture");
+    LOG("=====================================");
+
     audioEngine.begin();     // I2S + Audio setup
     
     // Create audio task on Core 0
@@ -104,9 +112,46 @@ void setup() {
         0                    // Core ID: 0 (dedicated audio core)
     );
     
-    Serial.println("[Setup] Core 0: Audio Task (High Priority)");
-    Serial.println("[Setup] Core 1: UI/Display Loop (Normal Priority)");
-    Serial.println("=====================================");
+    // loop() runs in this same task; inputs wake it through task notifications
+    UiEvents::begin(xTaskGetCurrentTaskHandle());
+    AllocCounter::watch(xTaskGetCurrentTaskHandle());   // Display frames must not allocate
+
+    // Initialize hardware
+    button.begin();
+    encoder.begin();
+    potPitch.begin();
+    potTone.begin();
+    potSampler.attach(potPitch);
+    potSampler.attach(potTone);
+    potSampler.begin();      // ADC DMA + sampler task (Core 1)
+
+    // I2C + OLED + 2 s splash run on their own task, in parallel with audio.
+    // A missing OLED just leaves the display disabled.
+    displayManager.setScope(&audioEngine.getScopeTap());   // Scope/spectrum views
+    displayManager.beginAsync(1, 1);
+
+    // Serial commands ("help") and memory telemetry ("mem"), both low priority on Core 1
+    Console::begin();
+    Telemetry::begin();
+    LatencyTrace::begin();   // "lat": input in loop() -> block at the DAC
+#ifdef EDULAB_PROFILE
+    Profiler::begin();       // "prof": scope capture, dumped as a Chrome trace
+#endif
+    Telemetry::watchTask(audioTaskHandle);
+    Telemetry::watchTask(xTaskGetCurrentTaskHandle());
+    Telemetry::watchTask(audioEngine.getWorkerTask());
+    Telemetry::watchTask(potSampler.getTask());
+    Telemetry::watchTask(Log::getDrainTask());
+    Telemetry::watchTask(Console::getTask());
+    
+    LOG("[Setup] Core 0: Audio Task (High Priority)");
+    LOG("[Setup] Core 1: UI/Display Loop (Normal Priority)");
+    LOG("[Setup] Done at %lu ms", (unsigned long)millis());
+    LOG("=====================================");
+
+#ifdef EDULAB_BENCHMARKS
+    runBenchmarks();         // env:esp32-s3-bench only
+#endif
 }
 
 // ==========================================
@@ -117,19 +162,39 @@ void loop() {
     // This loop now ONLY handles UI and controls
     // Audio runs independently on Core 0
     // ==========================================
+
+    // 0. SLEEP UNTIL AN INPUT OR THE NEAREST DEADLINE
+    // Button/encoder ISRs and the pot sampler notify this task; the timeout
+    // covers debounce, long press, menu timeout and throttled display frames.
+    unsigned long now = millis();
+    unsigned long timeout = min(button.msUntilDeadline(now), stateMachine.msUntilTimeout(now));
+    timeout = min(timeout, displayManager.msUntilNextFrame(now));
+    uint32_t sources = UiEvents::wait(timeout);
+
+    // Time spent awake in here is Core 1 time the render worker can't have
+    static unsigned long busyUs = 0;
+    static unsigned long windowStartUs = micros();
+    unsigned long wakeUs = micros();
     
     // 1. UPDATE INPUTS
+    // (pots are sampled in the background by potSampler; update() only checks for new values)
     button.update();
     potPitch.update();
     potTone.update();
     
     // 2. HANDLE BUTTON EVENTS
+    if (sources & UiEvents::POT) {
+        LatencyTrace::mark(LatencyTrace::POT);
+    }
+
     if (button.wasLongPressed()) {
+        LatencyTrace::mark(LatencyTrace::BUTTON);
         stateMachine.onButtonLongPress();
         audioEngine.playFeedbackTone(500, 100);
     }
     
     if (button.wasShortPressed()) {
+    LatencyTrace::mark(LatencyTrace::BUTTON);
     stateMachine.onButtonShortPress();
     
     // Mute/Unmute gets a distinctive "double beep"
@@ -145,6 +210,7 @@ void loop() {
     // 3. HANDLE ENCODER MOVEMENT
     int direction = encoder.getDirection();
     if (direction != 0) {
+        LatencyTrace::mark(LatencyTrace::ENCODER);
         stateMachine.onEncoderMoved(direction);
     }
     
@@ -153,7 +219,7 @@ void loop() {
     
     // 5. CALCULATE FREQUENCY FOR DISPLAY
     int selectedMode = stateMachine.getMenu().getSelectedMode();
-    int maxFreq = (selectedMode == Menu::NOISE) ? 5000 : 20000;
+    int maxFreq = (selectedMode == Menu::NOISE || selectedMode == Menu::PLUCK) ? 5000 : 20000;
     float currentFrequency = mapLogarithmicAsymmetric(potPitch.getValue(), 20.0f, maxFreq);
     
     // 6. UPDATE DISPLAY
@@ -161,11 +227,27 @@ void loop() {
     // The I2C communication (which blocks for ~10ms) happens on Core 1,
     // while Core 0 continues generating audio smoothly.
     displayManager.update(stateMachine, (int)currentFrequency);
+
+    // Any input (pots included: volume up from zero) or state change may end
+    // the silence the audio task is parked on
+    static StateMachine::State lastState = StateMachine::MUTE;
+    static int lastMode = -1;
+    if (sources || stateMachine.getState() != lastState || selectedMode != lastMode) {
+        audioEngine.wake();
+        lastState = stateMachine.getState();
+        lastMode = selectedMode;
+    }
+
+    // 7. REPORT UI LOAD (lets the audio engine decide on dual-core rendering)
+    unsigned long doneUs = micros();
+    busyUs += doneUs - wakeUs;
+    if (doneUs - windowStartUs >= 250000UL) {
+        audioEngine.setUiLoad((uint32_t)((uint64_t)busyUs * 1000 / (doneUs - windowStartUs)));
+        busyUs = 0;
+        windowStartUs = doneUs;
+    }
     
-    // 7. AUDIO UPDATE - REMOVED!
+    // 8. AUDIO UPDATE - REMOVED!
     // audioEngine.update() has been moved to Core 0 (audioTask)
     // This separation is what eliminates the clicks/pops!
-    
-    // Small delay to yield CPU to other tasks (good practice)
-    delay(10);
 }
\ No newline at end of file
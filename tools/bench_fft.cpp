@@ -0,0 +1,95 @@
+/**
+ * bench_fft - accuracy and speed of the display's fixed-point FFT
+ *
+ * Build (host):
+ *   g++ -O2 -std=c++17 -I lib/AudioEngine tools/bench_fft.cpp \
+ *       lib/AudioEngine/Scope/FixedFft.cpp -o bench_fft
+ *
+ * Usage:
+ *   bench_fft [iterations]
+ *
+ * Compares FixedFft against a double-precision DFT of the same (windowed)
+ * input, then times window + transform + 64-bar magnitude pass, i.e. what
+ * DisplayManager::renderSpectrum() does per frame. The UI draws at most one
+ * frame per 50 ms; on the S3 the FFT should stay well under 1 ms of that.
+ * Host numbers are only a relative guide: scale by the clock ratio.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <complex>
+#include <algorithm>
+#include "Scope/FixedFft.h"
+
+static const int N = FixedFft::SIZE;
+
+// Two tones and a little noise, roughly what the synth puts out
+static void makeSignal(int16_t* out, unsigned seed) {
+    srand(seed);
+    for (int i = 0; i < N; i++) {
+        double t = (double)i / N;
+        double v = 14000.0 * sin(2.0 * M_PI * 9.3 * t) + 7000.0 * sin(2.0 * M_PI * 41.7 * t + 0.4)
+                 + (rand() % 801 - 400);
+        out[i] = (int16_t)lrint(v);
+    }
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 20000;
+    FixedFft fft;
+
+    // ---- Accuracy ----
+    int16_t re[N], im[N];
+    makeSignal(re, 1);
+    fft.applyWindow(re);
+    double input[N];
+    for (int i = 0; i < N; i++) {
+        input[i] = re[i];
+        im[i] = 0;
+    }
+    fft.transform(re, im);
+
+    double maxError = 0.0, maxMagnitude = 0.0, magnitudeError = 0.0;
+    for (int k = 0; k < N / 2; k++) {
+        std::complex<double> sum = 0.0;
+        for (int n = 0; n < N; n++) {
+            sum += input[n] * std::polar(1.0, -2.0 * M_PI * k * n / N);
+        }
+        sum /= N;       // FixedFft scales by 1/N
+        maxError = std::max(maxError, std::abs(sum - std::complex<double>(re[k], im[k])));
+        maxMagnitude = std::max(maxMagnitude, std::abs(sum));
+        magnitudeError = std::max(magnitudeError,
+                                  std::fabs(FixedFft::magnitude(re[k], im[k]) - std::abs(sum)));
+    }
+    printf("accuracy: max bin error %.2f LSB, peak bin %.0f, magnitude estimate off by <= %.0f\n",
+           maxError, maxMagnitude, magnitudeError);
+
+    // ---- Speed ----
+    int16_t frames[8][N];
+    for (int f = 0; f < 8; f++) {
+        makeSignal(frames[f], f + 2);
+    }
+
+    volatile uint32_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int it = 0; it < iterations; it++) {
+        const int16_t* frame = frames[it & 7];
+        for (int i = 0; i < N; i++) {
+            re[i] = frame[i];
+            im[i] = 0;
+        }
+        fft.applyWindow(re);
+        fft.transform(re, im);
+        uint32_t total = 0;
+        for (int k = 0; k < N / 2; k++) {
+            total += FixedFft::magnitude(re[k], im[k]);
+        }
+        sink = sink + total;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("speed: %d frames, %.2f us per frame (window + FFT + magnitudes)\n",
+           iterations, seconds * 1e6 / iterations);
+    return 0;
+}
@@ -0,0 +1,58 @@
+/**
+ * bench_fm - cost of the integer FM voice per algorithm
+ *
+ * Build (host):
+ *   g++ -O2 -std=c++17 -I lib/AudioEngine tools/bench_fm.cpp \
+ *       lib/AudioEngine/Fm/FmVoice.cpp -o bench_fm
+ *
+ * Usage:
+ *   bench_fm [blocks]
+ *
+ * Renders every algorithm for `blocks` audio blocks at the firmware's
+ * control rate (prepare() every 32 samples, like the engine) and prints
+ * ns per voice-sample and the share of one 44.1 kHz sample period one
+ * voice takes. Host numbers are a relative guide; benchmarkFm() in
+ * lib/Benchmarks gives cycles on the device.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include "Fm/FmVoice.h"
+#include "../include/Consts.h"
+
+int main(int argc, char** argv) {
+    const int blocks = argc > 1 ? atoi(argv[1]) : 20000;
+    const int controlRate = 32;
+    static float output[BLOCK_FRAMES];
+
+    FmVoice::buildSineTable();
+    printf("%-14s %6s %12s %14s\n", "algorithm", "ops", "ns/sample", "voices/core*");
+
+    volatile float sink = 0.0f;
+    for (int a = 0; a < FmVoice::ALG_COUNT; a++) {
+        FmVoice::Patch patch = FmVoice::PRESETS[3];     // 4 operators with envelopes
+        patch.algorithm = (FmVoice::Algorithm)a;
+        patch.feedback = 0.5f;
+
+        FmVoice voice;
+        voice.setPatch(patch);
+        voice.noteOn();
+
+        auto start = std::chrono::steady_clock::now();
+        for (int b = 0; b < blocks; b++) {
+            for (int offset = 0; offset < BLOCK_FRAMES; offset += controlRate) {
+                voice.prepare(220.0f, controlRate);
+                voice.render(output + offset, controlRate, 0.5f);
+            }
+            sink = sink + output[b & (BLOCK_FRAMES - 1)];
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        double nsPerSample = seconds * 1e9 / ((double)blocks * BLOCK_FRAMES);
+        double samplePeriodNs = 1e9 / SAMPLE_RATE;
+        printf("%-14s %6d %12.2f %14.0f\n", FmVoice::algorithmName(patch.algorithm),
+               FmVoice::operatorCount(patch.algorithm), nsPerSample, samplePeriodNs / nsPerSample);
+    }
+    printf("* at 100%% of one host core; scale by the clock ratio for the S3\n");
+    return 0;
+}
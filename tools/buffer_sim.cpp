@@ -0,0 +1,133 @@
+/**
+ * buffer_sim - replays synthetic load traces through the BufferController
+ *
+ * Build (host):
+ *   g++ -O2 -std=c++17 -I lib/AudioEngine tools/buffer_sim.cpp -o buffer_sim
+ *
+ * Usage:
+ *   buffer_sim [-v]
+ *
+ * Models the audio task against the I2S DMA: the task waits until no more
+ * than the level's queue depth is left, writes a block, then spends the
+ * trace's render time on the next one while the DMA keeps draining. If
+ * the queue runs dry the DMA plays silence - an underrun - and the
+ * controller is told. Render time per block is a fixed overhead plus a
+ * per-frame cost (so small blocks cost relatively more), plus the trace's
+ * stalls.
+ *
+ * Each scenario states where the level should settle and how many
+ * underruns and level changes are acceptable; exits non-zero if any is
+ * missed. -v prints every level change.
+ */
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include "Parallel/BufferController.h"
+
+struct Trace {
+    const char* name;
+    double seconds;
+    // Render time in us for a block of `frames` starting at time t (s)
+    double (*renderUs)(double t, int frames);
+    int settleMin;          // Expected final level range
+    int settleMax;
+    unsigned maxUnderruns;
+    unsigned maxChanges;
+};
+
+static const double US_PER_FRAME = 1e6 / SAMPLE_RATE;
+
+static double steady(double load, int frames) {
+    return 40.0 + load * frames * US_PER_FRAME;     // 40 us per-block overhead
+}
+
+static double light(double, int frames) { return steady(0.25, frames); }
+static double moderate(double, int frames) { return steady(0.60, frames); }
+
+// 25 % load plus a 5 ms stall once a second (flash write, long I2C transfer)
+static double stalls(double t, int frames) {
+    static double lastStall = -1.0;
+    double us = steady(0.25, frames);
+    if (t - lastStall >= 1.0) {
+        lastStall = t;
+        us += 5000.0;
+    }
+    return us;
+}
+
+// 25 % load plus a 4 ms stall every 30 s: too rare for the shrink window
+// to see, so only underruns (and their growing holds) keep the depth up
+static double rareStalls(double t, int frames) {
+    static double lastStall = 0.0;
+    double us = steady(0.25, frames);
+    if (t - lastStall >= 30.0) {
+        lastStall = t;
+        us += 4000.0;
+    }
+    return us;
+}
+
+// Light, then a heavy patch for a minute, then light again
+static double patchChange(double t, int frames) {
+    return (t >= 60.0 && t < 120.0) ? steady(0.90, frames) : steady(0.20, frames);
+}
+
+static bool run(const Trace& trace, bool verbose) {
+    BufferController controller;
+    double t = 0.0;
+    double queuedUs = 0.0;      // Audio in the DMA ring, in time
+    int level = controller.getLevel();
+
+    while (t < trace.seconds) {
+        int frames = controller.getBlockFrames();
+        double blockUs = frames * US_PER_FRAME;
+        double queueLimitUs = controller.getQueueFrames() * US_PER_FRAME;
+
+        // Wait until the ring has drained to the level's depth, then write
+        if (queuedUs > queueLimitUs) {
+            t += (queuedUs - queueLimitUs) / 1e6;
+            queuedUs = queueLimitUs;
+        }
+        queuedUs += blockUs;
+
+        // Render the next block while the DMA plays
+        double renderUs = trace.renderUs(t, controller.getBlockFrames());
+        t += renderUs / 1e6;
+        bool underrun = renderUs > queuedUs;
+        queuedUs = underrun ? 0.0 : queuedUs - renderUs;
+
+        uint32_t load = (uint32_t)(renderUs * 1000.0 / blockUs);
+        if (controller.report(frames, load, underrun) && verbose) {
+            printf("    %8.2f s  level %d -> %d%s\n", t, level, controller.getLevel(), underrun ? " (underrun)" : "");
+        }
+        level = controller.getLevel();
+    }
+
+    const BufferController::Level& l = BufferController::level(level);
+    double latencyMs = (l.blockFrames + l.queueFrames) * 1000.0 / SAMPLE_RATE;
+    bool ok = level >= trace.settleMin && level <= trace.settleMax &&
+              controller.getUnderruns() <= trace.maxUnderruns && controller.getChanges() <= trace.maxChanges;
+    printf("%-4s %-13s level %d (%3d + %3d frames, %4.1f ms)  underruns %3lu  changes %3lu\n",
+           ok ? "ok" : "FAIL", trace.name, level, l.blockFrames, l.queueFrames, latencyMs,
+           (unsigned long)controller.getUnderruns(), (unsigned long)controller.getChanges());
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    bool verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+
+    static const Trace traces[] = {
+        // name           seconds  render       settle  underruns  changes
+        { "light",         60.0,   light,        0, 0,     0,         4 },
+        { "moderate",      60.0,   moderate,     0, 0,     0,         4 },
+        { "stalls",       600.0,   stalls,       3, 3,     1,         1 },
+        { "rare-stalls", 1800.0,   rareStalls,   1, 2,    12,        26 },
+        { "patch-change", 180.0,   patchChange,  0, 0,     2,        12 },
+    };
+
+    bool ok = true;
+    for (const Trace& trace : traces) {
+        ok &= run(trace, verbose);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+/**
+ * dma_ring_sim - runs the zero-copy DmaRing against an emulated I2S DMA
+ *
+ * Build (host):
+ *   g++ -O2 -std=c++17 -I lib/AudioEngine tools/dma_ring_sim.cpp -o dma_ring_sim
+ *
+ * Usage:
+ *   dma_ring_sim [-v]
+ *
+ * Stands in for the hardware ring: BUFFERS buffers, allocated out of
+ * order so the ring has to learn their addresses from the events, played
+ * one per period. Each buffer is fetched half a period before it starts
+ * playing (the DMA reads ahead), and its "sent" event calls
+ * DmaRing::onSent() when it ends. The audio task acquires a buffer,
+ * spends the pattern's render time on it, then writes the block in one go
+ * and commits - so a block written after its buffer was fetched is lost.
+ *
+ * Every block carries its own frame numbers, which makes the check
+ * exact: the output must hold the rendered blocks whole and in order,
+ * with every block the ring committed as on time among them, and any
+ * silence inside it must show up in the ring's underrun count. A task
+ * waiting for a buffer must be notified by the next event. -v prints
+ * every underrun.
+ */
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+#include "Output/DmaRing.h"
+#include "../include/Consts.h"
+
+static const int BUFFERS = 4;
+static const int FRAMES = 128;                  // Per buffer, so per block
+static const double FETCH_AHEAD = 0.5;          // Periods
+static const double PERIOD_MS = FRAMES * 1000.0 / SAMPLE_RATE;
+
+struct Pattern {
+    const char* name;
+    int blocks;
+    // Render time of block b, in DMA periods
+    double (*renderPeriods)(int b);
+    uint32_t minUnderruns;
+    uint32_t maxUnderruns;
+};
+
+static uint32_t lcg = 1;
+static double uniform() {
+    lcg = lcg * 1664525u + 1013904223u;
+    return (lcg >> 8) / 16777216.0;
+}
+
+static double onTime(int) { return 0.4; }
+static double jittered(int b) { return b % 50 == 49 ? 1.9 : 0.2 + 0.5 * uniform(); }
+static double stalled(int b) { return b == 500 ? 12.0 : 0.4; }        // A flash write, or a park
+static double overloaded(int b) { return b >= 200 && b < 300 ? 1.3 : 0.5; }
+
+// The hardware side: a ring of buffers in memory order `slots`
+struct HostDma {
+    int32_t storage[BUFFERS][FRAMES];
+    int32_t* ring[BUFFERS];
+    std::vector<int32_t> output;
+    uint32_t fetched;           // Buffers fetched so far
+    uint32_t sent;              // Events so far
+
+    HostDma() : fetched(0), sent(0) {
+        memset(storage, 0, sizeof(storage));
+        static const int slots[BUFFERS] = { 2, 0, 3, 1 };
+        for (int i = 0; i < BUFFERS; i++) {
+            ring[i] = storage[slots[i]];
+        }
+    }
+
+    double nextFetch() const { return fetched - FETCH_AHEAD; }
+    double nextEvent() const { return sent + 1.0; }
+
+    // Runs the DMA up to time t (in periods). Returns true if an event
+    // asked to notify the task.
+    bool runUntil(double t, DmaRing& dmaRing) {
+        bool notified = false;
+        while (true) {
+            if (nextFetch() <= t && nextFetch() < nextEvent()) {
+                const int32_t* buffer = ring[fetched % BUFFERS];
+                output.insert(output.end(), buffer, buffer + FRAMES);
+                fetched++;
+            } else if (nextEvent() <= t) {
+                notified |= dmaRing.onSent(ring[sent % BUFFERS]);
+                sent++;
+            } else {
+                return notified;
+            }
+        }
+    }
+};
+
+static bool run(const Pattern& pattern, bool verbose) {
+    HostDma dma;
+    DmaRing dmaRing;
+    dmaRing.begin(BUFFERS, FRAMES * sizeof(int32_t));
+    lcg = 1;
+
+    std::vector<bool> committed;
+    double t = 0.0;
+    uint64_t aheadSum = 0;
+    bool missedWake = false;
+
+    for (int b = 0; b < pattern.blocks; b++) {
+        dma.runUntil(t, dmaRing);
+        int32_t* buffer = (int32_t*)dmaRing.acquire();
+        while (!buffer) {
+            dmaRing.prepareWait();
+            buffer = (int32_t*)dmaRing.acquire();
+            if (buffer) {
+                dmaRing.cancelWait();
+                break;
+            }
+            // Block until the next event, which must notify
+            t = dma.nextEvent();
+            missedWake |= !dma.runUntil(t, dmaRing);
+            buffer = (int32_t*)dmaRing.acquire();
+        }
+
+        t += pattern.renderPeriods(b);
+        dma.runUntil(t, dmaRing);
+        for (int i = 0; i < FRAMES; i++) {
+            buffer[i] = b * FRAMES + i + 1;
+        }
+        bool ok = dmaRing.commit();
+        committed.push_back(ok);
+        aheadSum += dmaRing.getBuffersAhead();
+        if (!ok && verbose) {
+            printf("    %9.2f ms  block %d underran\n", t * PERIOD_MS, b);
+        }
+    }
+    dma.runUntil(t + BUFFERS, dmaRing);
+
+    // Whole blocks in order, silence between them only
+    bool ordered = true;
+    uint32_t gapBuffers = 0;
+    int lastBlock = -1;
+    int pendingGap = 0;
+    std::vector<bool> played(pattern.blocks, false);
+    for (size_t p = 0; p + FRAMES <= dma.output.size(); p += FRAMES) {
+        const int32_t* frames = &dma.output[p];
+        if (frames[0] == 0) {
+            for (int i = 1; i < FRAMES; i++) {
+                ordered &= frames[i] == 0;
+            }
+            pendingGap += lastBlock >= 0 ? 1 : 0;
+            continue;
+        }
+        int block = (frames[0] - 1) / FRAMES;
+        for (int i = 0; i < FRAMES; i++) {
+            ordered &= frames[i] == block * FRAMES + i + 1;
+        }
+        ordered &= block > lastBlock && block < pattern.blocks;
+        if (ordered) {
+            played[block] = true;
+        }
+        lastBlock = block;
+        gapBuffers += pendingGap;
+        pendingGap = 0;
+    }
+
+    uint32_t lost = 0;
+    bool onTimePlayed = true;
+    for (int b = 0; b < pattern.blocks; b++) {
+        lost += played[b] ? 0 : 1;
+        onTimePlayed &= played[b] || !committed[b];
+    }
+
+    uint32_t underruns = dmaRing.getUnderruns();
+    bool reported = gapBuffers == 0 || underruns > 0;
+    bool ok = ordered && onTimePlayed && reported && !missedWake &&
+              underruns >= pattern.minUnderruns && underruns <= pattern.maxUnderruns;
+    double aheadMs = (double)aheadSum / pattern.blocks * PERIOD_MS;
+    printf("%-4s %-11s underruns %3lu  lost blocks %3lu  silent buffers %3lu  ahead %4.1f ms%s%s%s\n",
+           ok ? "ok" : "FAIL", pattern.name, (unsigned long)underruns, (unsigned long)lost,
+           (unsigned long)gapBuffers, aheadMs, ordered ? "" : "  (out of order)",
+           onTimePlayed ? "" : "  (on-time block lost)", missedWake ? "  (missed wake-up)" : "");
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    bool verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+
+    static const Pattern patterns[] = {
+        // name          blocks  render       underruns
+        { "on-time",      5000,  onTime,       0, 0 },
+        { "jittered",     5000,  jittered,     0, 0 },
+        { "stalled",      5000,  stalled,      1, 1 },
+        { "overloaded",   5000,  overloaded,   1, 100 },
+    };
+
+    bool ok = true;
+    for (const Pattern& pattern : patterns) {
+        ok &= run(pattern, verbose);
+    }
+    return ok ? 0 : 1;
+}
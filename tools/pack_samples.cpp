@@ -0,0 +1,304 @@
+/**
+ * pack_samples - build a sample bank image for the "samples" flash partition
+ *
+ * Build (host):
+ *   g++ -O2 -std=c++17 -I lib/AudioEngine/Sampler -I lib/AudioEngine/Codec \
+ *       tools/pack_samples.cpp -o pack_samples
+ *
+ * Usage:
+ *   pack_samples <out.bin> <file.wav>[:root=<Hz>][:loop=<start>,<end>][:adpcm][:wavetable=<len>] ...
+ *
+ *   WAV input must be 16-bit PCM; stereo is mixed down to mono.
+ *   root      - pitch of the recording (default 440 Hz)
+ *   loop      - loop points in frames (default: one-shot)
+ *   adpcm     - store as IMA-ADPCM (4 bits/sample, ~3.9:1)
+ *   wavetable - the file is a series of single cycles, <len> samples each.
+ *               Every cycle becomes one wavetable frame, resampled to
+ *               1024 samples and band-limited into one table per octave.
+ *
+ * Flash (partition offset from partitions_16MB_samples.csv):
+ *   python -m esptool --chip esp32s3 write_flash 0x610000 out.bin
+ *
+ * The same image can be opened on the host with SampleStore::openFile().
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <cmath>
+#include "SampleBank.h"
+#include "ImaAdpcm.h"
+
+// Must match Wavetable.h / Consts.h (not includable here: they pull in Arduino)
+static const int TABLE_SIZE = 1024;
+static const int MIP_LEVELS = 11;
+static const float BASE_FREQUENCY = 20.0f;
+static const float OUTPUT_RATE = 44100.0f;
+
+struct Input {
+    std::string path;
+    float root = 440.0f;
+    uint32_t loopStart = 0;
+    uint32_t loopEnd = 0;
+    uint32_t sampleRate = 0;
+    bool adpcm = false;
+    uint32_t cycleLength = 0;       // wavetable: samples per input cycle
+    uint16_t frameCount = 0;
+    std::vector<int16_t> pcm;       // After wavetable conversion: [frame][mip][TABLE_SIZE]
+    std::vector<uint8_t> encoded;
+};
+
+static uint32_t readLE32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+static uint16_t readLE16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+
+static bool loadWav(Input& input) {
+    FILE* file = fopen(input.path.c_str(), "rb");
+    if (!file) {
+        fprintf(stderr, "%s: cannot open\n", input.path.c_str());
+        return false;
+    }
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + n);
+    }
+    fclose(file);
+
+    if (bytes.size() < 12 || memcmp(&bytes[0], "RIFF", 4) != 0 || memcmp(&bytes[8], "WAVE", 4) != 0) {
+        fprintf(stderr, "%s: not a WAV file\n", input.path.c_str());
+        return false;
+    }
+
+    uint16_t channels = 0, bits = 0;
+    size_t pos = 12;
+    while (pos + 8 <= bytes.size()) {
+        uint32_t size = readLE32(&bytes[pos + 4]);
+        const uint8_t* body = &bytes[pos + 8];
+        if (pos + 8 + size > bytes.size()) break;
+
+        if (memcmp(&bytes[pos], "fmt ", 4) == 0 && size >= 16) {
+            if (readLE16(body) != 1) {
+                fprintf(stderr, "%s: only PCM WAV is supported\n", input.path.c_str());
+                return false;
+            }
+            channels = readLE16(body + 2);
+            input.sampleRate = readLE32(body + 4);
+            bits = readLE16(body + 14);
+        } else if (memcmp(&bytes[pos], "data", 4) == 0) {
+            if (bits != 16 || channels == 0) {
+                fprintf(stderr, "%s: need 16-bit PCM\n", input.path.c_str());
+                return false;
+            }
+            size_t frames = size / (2 * channels);
+            input.pcm.resize(frames);
+            for (size_t f = 0; f < frames; f++) {
+                int32_t sum = 0;
+                for (int c = 0; c < channels; c++) {
+                    sum += (int16_t)readLE16(body + (f * channels + c) * 2);
+                }
+                input.pcm[f] = (int16_t)(sum / channels);
+            }
+            return true;
+        }
+        pos += 8 + size + (size & 1);
+    }
+
+    fprintf(stderr, "%s: no data chunk\n", input.path.c_str());
+    return false;
+}
+
+static bool parseArgument(const char* arg, Input& input) {
+    std::string text(arg);
+    size_t colon = text.find(':');
+    input.path = text.substr(0, colon);
+
+    while (colon != std::string::npos) {
+        size_t next = text.find(':', colon + 1);
+        std::string option = text.substr(colon + 1, next == std::string::npos ? std::string::npos : next - colon - 1);
+        if (option.rfind("root=", 0) == 0) {
+            input.root = strtof(option.c_str() + 5, nullptr);
+        } else if (option.rfind("loop=", 0) == 0) {
+            if (sscanf(option.c_str() + 5, "%u,%u", &input.loopStart, &input.loopEnd) != 2) {
+                fprintf(stderr, "bad loop option: %s\n", option.c_str());
+                return false;
+            }
+        } else if (option == "adpcm") {
+            input.adpcm = true;
+        } else if (option.rfind("wavetable=", 0) == 0) {
+            input.cycleLength = (uint32_t)strtoul(option.c_str() + 10, nullptr, 10);
+            if (input.cycleLength < 2) {
+                fprintf(stderr, "bad wavetable option: %s\n", option.c_str());
+                return false;
+            }
+        } else {
+            fprintf(stderr, "unknown option: %s\n", option.c_str());
+            return false;
+        }
+        colon = next;
+    }
+    return true;
+}
+
+/**
+ * Turn consecutive single cycles into mipmapped wavetable frames
+ *
+ * Each cycle is analysed with a DFT and resynthesised at TABLE_SIZE once
+ * per mip level, keeping only the harmonics that stay below Nyquist at the
+ * top of that level's octave (same rule as Wavetable::buildFrame).
+ */
+static bool buildWavetable(Input& input) {
+    uint32_t frames = (uint32_t)input.pcm.size() / input.cycleLength;
+    if (frames < 1 || frames > 0xFFFF) {
+        fprintf(stderr, "%s: need at least one %u-sample cycle\n", input.path.c_str(), input.cycleLength);
+        return false;
+    }
+
+    int maxHarmonics = std::min<int>(input.cycleLength / 2, TABLE_SIZE / 2);
+    std::vector<int16_t> out((size_t)frames * MIP_LEVELS * TABLE_SIZE);
+    std::vector<double> re(maxHarmonics + 1), im(maxHarmonics + 1), work(TABLE_SIZE);
+
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        const int16_t* cycle = &input.pcm[(size_t)frame * input.cycleLength];
+        for (int h = 1; h <= maxHarmonics; h++) {
+            double sumRe = 0.0, sumIm = 0.0;
+            for (uint32_t n = 0; n < input.cycleLength; n++) {
+                double angle = 2.0 * M_PI * h * n / input.cycleLength;
+                sumRe += cycle[n] * cos(angle);
+                sumIm += cycle[n] * sin(angle);
+            }
+            re[h] = sumRe * 2.0 / input.cycleLength;
+            im[h] = sumIm * 2.0 / input.cycleLength;
+        }
+
+        double scale = 0.0;
+        for (int mip = 0; mip < MIP_LEVELS; mip++) {
+            double topFrequency = BASE_FREQUENCY * (double)(2 << mip);
+            int harmonics = std::max(1, std::min(maxHarmonics, (int)((OUTPUT_RATE / 2) / topFrequency)));
+
+            for (int i = 0; i < TABLE_SIZE; i++) {
+                double sum = 0.0;
+                for (int h = 1; h <= harmonics; h++) {
+                    double angle = 2.0 * M_PI * h * i / TABLE_SIZE;
+                    sum += re[h] * cos(angle) + im[h] * sin(angle);
+                }
+                work[i] = sum;
+            }
+
+            // Normalise on the richest level so all mips of a frame share one gain
+            if (mip == 0) {
+                double peak = 0.0;
+                for (double v : work) peak = std::max(peak, fabs(v));
+                scale = peak > 0.0 ? 32767.0 / peak : 0.0;
+            }
+
+            int16_t* table = &out[((size_t)frame * MIP_LEVELS + mip) * TABLE_SIZE];
+            for (int i = 0; i < TABLE_SIZE; i++) {
+                double value = std::max(-32767.0, std::min(32767.0, work[i] * scale));
+                table[i] = (int16_t)lrint(value);
+            }
+        }
+    }
+
+    input.pcm.swap(out);
+    input.frameCount = (uint16_t)frames;
+    input.loopStart = input.loopEnd = 0;
+    return true;
+}
+
+// TABLE_SIZE is a multiple of BLOCK_SAMPLES, so wavetable tables never share a block
+static void encodeAdpcm(Input& input) {
+    size_t count = input.pcm.size();
+    input.encoded.resize(ImaAdpcm::encodedBytes((uint32_t)count));
+
+    ImaAdpcm::State state = { count ? input.pcm[0] : 0, 0 };
+    for (size_t start = 0, block = 0; start < count; start += ImaAdpcm::BLOCK_SAMPLES, block++) {
+        int n = (int)std::min<size_t>(ImaAdpcm::BLOCK_SAMPLES, count - start);
+        ImaAdpcm::encodeBlock(&input.pcm[start], n, state, &input.encoded[block * ImaAdpcm::BLOCK_BYTES]);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <out.bin> <file.wav>[:root=Hz][:loop=start,end][:adpcm][:wavetable=len] ...\n",
+                argv[0]);
+        return 1;
+    }
+
+    std::vector<Input> inputs(argc - 2);
+    for (int i = 2; i < argc; i++) {
+        Input& input = inputs[i - 2];
+        if (!parseArgument(argv[i], input) || !loadWav(input)) {
+            return 1;
+        }
+        if (input.loopEnd > input.pcm.size() || input.loopStart > input.loopEnd) {
+            fprintf(stderr, "%s: loop points outside the sample\n", input.path.c_str());
+            return 1;
+        }
+        if (input.cycleLength && !buildWavetable(input)) {
+            return 1;
+        }
+        if (input.adpcm) {
+            encodeAdpcm(input);
+        }
+    }
+
+    SampleBankHeader header = {};
+    header.magic = SAMPLE_BANK_MAGIC;
+    header.version = SAMPLE_BANK_VERSION;
+    header.count = (uint16_t)inputs.size();
+
+    std::vector<SampleInfo> infos(inputs.size());
+    uint32_t offset = sizeof(SampleBankHeader) + infos.size() * sizeof(SampleInfo);
+
+    for (size_t i = 0; i < inputs.size(); i++) {
+        const Input& input = inputs[i];
+        SampleInfo& info = infos[i];
+        memset(&info, 0, sizeof(info));
+
+        std::string name = input.path.substr(input.path.find_last_of("/\\") + 1);
+        strncpy(info.name, name.c_str(), SAMPLE_NAME_LENGTH - 1);
+        offset = (offset + 3) & ~3u;
+        info.offset = offset;
+        info.length = (uint32_t)input.pcm.size();
+        info.sampleRate = input.sampleRate;
+        info.loopStart = input.loopStart;
+        info.loopEnd = input.loopEnd;
+        info.rootFrequency = input.root;
+        info.format = input.adpcm ? SAMPLE_FORMAT_IMA_ADPCM : SAMPLE_FORMAT_PCM16;
+        info.kind = input.frameCount ? SAMPLE_KIND_WAVETABLE : SAMPLE_KIND_SAMPLE;
+        info.frameCount = input.frameCount;
+        offset += input.adpcm ? (uint32_t)input.encoded.size() : info.length * sizeof(int16_t);
+    }
+
+    FILE* out = fopen(argv[1], "wb");
+    if (!out) {
+        fprintf(stderr, "%s: cannot write\n", argv[1]);
+        return 1;
+    }
+    fwrite(&header, sizeof(header), 1, out);
+    fwrite(infos.data(), sizeof(SampleInfo), infos.size(), out);
+
+    for (size_t i = 0; i < inputs.size(); i++) {
+        while ((uint32_t)ftell(out) < infos[i].offset) fputc(0, out);
+        if (inputs[i].adpcm) {
+            fwrite(inputs[i].encoded.data(), 1, inputs[i].encoded.size(), out);
+        } else {
+            fwrite(inputs[i].pcm.data(), sizeof(int16_t), inputs[i].pcm.size(), out);
+        }
+        if (infos[i].kind == SAMPLE_KIND_WAVETABLE) {
+            printf("%-16s %8u wavetable frames x %d mips%s\n", infos[i].name, infos[i].frameCount,
+                   MIP_LEVELS, inputs[i].adpcm ? ", ADPCM" : "");
+        } else {
+            printf("%-16s %8u frames @ %u Hz, root %.1f Hz%s%s\n", infos[i].name, infos[i].length,
+                   infos[i].sampleRate, infos[i].rootFrequency, infos[i].loopEnd ? ", looped" : "",
+                   inputs[i].adpcm ? ", ADPCM" : "");
+        }
+    }
+
+    printf("%ld bytes written to %s\n", ftell(out), argv[1]);
+    fclose(out);
+    return 0;
+}
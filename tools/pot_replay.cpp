@@ -0,0 +1,241 @@
+/**
+ * pot_replay - runs ADC traces through the potentiometer chain on the host
+ *
+ * Build (host):
+ *   g++ -O2 -std=c++17 -I lib/Potentiometer tools/pot_replay.cpp -o pot_replay
+ *
+ * Usage:
+ *   pot_replay [-v] [trace]
+ *
+ * Feeds raw 12-bit conversions for one channel (10 kHz, as PotSampler
+ * reads them) through the same 32x averaging and then PotFilter with the
+ * firmware's settings. The built-in traces are synthetic but noisy in the
+ * ways the board is: wideband ADC noise, mains hum, single-conversion
+ * spikes. Each states what the published value must do:
+ *   rest traces   no change once the filter has settled - a pot left
+ *                 alone must not jitter
+ *   step          no change before the step, the final value within the
+ *                 hysteresis of the target inside the time limit, and no
+ *                 overshoot past it
+ *   sweep         every change in the direction of travel
+ *   endpoints     0 and 4095 exactly reachable
+ * Exits non-zero if any is missed. -v prints every published change.
+ *
+ * With a file argument (one conversion per line, 10 kHz), replays a
+ * recorded trace instead and prints its changes and largest reversal.
+ */
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include "PotFilter.h"
+
+static const double CONVERSION_HZ = 10000.0;   // Per channel: 20 kHz over 2 pots
+static const int OVERSAMPLE = 32;              // PotSampler::OVERSAMPLE
+static const uint8_t SHIFT = 3;                // Potentiometer defaults
+static const int HYSTERESIS = 12;
+
+struct Change {
+    double t;               // s
+    int value;
+};
+
+// The sampler task's decimation followed by the filter
+static std::vector<Change> replay(const std::vector<int>& conversions, bool verbose) {
+    PotFilter filter(SHIFT, HYSTERESIS);
+    std::vector<Change> changes;
+    int32_t sum = 0;
+    int count = 0;
+    for (size_t i = 0; i < conversions.size(); i++) {
+        sum += conversions[i];
+        if (++count < OVERSAMPLE) {
+            continue;
+        }
+        int32_t sampleQ4 = (sum << PotFilter::FRAC_BITS) / count;
+        sum = 0;
+        count = 0;
+        if (filter.push(sampleQ4)) {
+            Change change = { (i + 1) / CONVERSION_HZ, filter.value() };
+            changes.push_back(change);
+            if (verbose) {
+                printf("    %8.1f ms  %4d\n", change.t * 1000.0, change.value);
+            }
+        }
+    }
+    return changes;
+}
+
+// ==========================================
+// SYNTHETIC TRACES
+// ==========================================
+static uint32_t lcg = 1;
+static double uniform() {
+    lcg = lcg * 1664525u + 1013904223u;
+    return (lcg >> 8) / 16777216.0;
+}
+
+static double gaussian() {
+    double sum = 0.0;
+    for (int i = 0; i < 12; i++) {
+        sum += uniform();
+    }
+    return sum - 6.0;
+}
+
+// target(t) plus noise of `sigma` LSB, `hum` LSB of 50 Hz and a spike
+// of up to +-`spike` LSB on one conversion in 500
+static std::vector<int> synthesize(double seconds, double (*target)(double), double sigma, double hum,
+                                   double spike) {
+    lcg = 1;
+    std::vector<int> conversions;
+    int total = (int)(seconds * CONVERSION_HZ);
+    for (int i = 0; i < total; i++) {
+        double t = i / CONVERSION_HZ;
+        double value = target(t) + sigma * gaussian() + hum * sin(2.0 * M_PI * 50.0 * t);
+        if (spike > 0.0 && uniform() < 1.0 / 500.0) {
+            value += (uniform() * 2.0 - 1.0) * spike;
+        }
+        int raw = (int)lround(value);
+        conversions.push_back(raw < 0 ? 0 : raw > PotFilter::MAX_VALUE ? PotFilter::MAX_VALUE : raw);
+    }
+    return conversions;
+}
+
+// The ADC reads flat 0 for the last ~100 mV before each rail and flat
+// 4095 near the top, so a pot's travel overshoots the code range a little
+// at both ends - ramps run past it and are clipped like the conversions
+static const double STEP_AT = 1.0;
+static double middle(double) { return 2048.0; }
+static double lowRest(double) { return 1500.0; }
+static double step(double t) { return t < STEP_AT ? 1000.0 : 3000.0; }
+static double sweep(double t) { return (t < 2.0 ? t / 2.0 : 1.0) * 4295.0 - 100.0; }
+static double approach(double t) { return t < 1.0 ? 60.0 - 120.0 * t : 4035.0 + 120.0 * (t - 1.0); }
+
+static bool check(const char* name, bool ok, const char* detail) {
+    printf("%-4s %-13s %s\n", ok ? "ok" : "FAIL", name, detail);
+    return ok;
+}
+
+// The first value is one decimated sample, so the filter may still move
+// once while it settles; after SETTLE_S it must hold still
+static bool rest(const char* name, double (*target)(double), double sigma, double hum, double spike,
+                 bool verbose) {
+    static const double SETTLE_S = 0.25;        // 10 time constants
+    std::vector<Change> changes = replay(synthesize(10.0, target, sigma, hum, spike), verbose);
+    int settling = 0;
+    int jitter = 0;
+    for (const Change& change : changes) {
+        settling += change.t < SETTLE_S ? 1 : 0;
+        jitter += change.t >= SETTLE_S ? 1 : 0;
+    }
+    char detail[96];
+    snprintf(detail, sizeof(detail), "%d changes at rest (want 0), %d while settling, value %d", jitter,
+             settling, changes.back().value);
+    return check(name, jitter == 0, detail);
+}
+
+static bool stepResponse(bool verbose) {
+    static const double LIMIT_MS = 150.0;
+    std::vector<Change> changes = replay(synthesize(2.0, step, 20.0, 10.0, 300.0), verbose);
+
+    bool quietBefore = true;
+    bool overshoot = false;
+    double settledMs = -1.0;
+    for (const Change& change : changes) {
+        if (change.t < STEP_AT) {
+            quietBefore &= &change == &changes[0];
+            continue;
+        }
+        overshoot |= change.value > 3000 + HYSTERESIS;
+        if (settledMs < 0.0 && abs(change.value - 3000) <= HYSTERESIS) {
+            settledMs = (change.t - STEP_AT) * 1000.0;
+        }
+    }
+    bool ok = quietBefore && !overshoot && settledMs >= 0.0 && settledMs <= LIMIT_MS &&
+              abs(changes.back().value - 3000) <= HYSTERESIS;
+    char detail[96];
+    snprintf(detail, sizeof(detail), "settled in %.1f ms (limit %.0f), final %d%s%s", settledMs, LIMIT_MS,
+             changes.back().value, quietBefore ? "" : ", moved before the step", overshoot ? ", overshoot" : "");
+    return check("step", ok, detail);
+}
+
+static bool sweepResponse(bool verbose) {
+    std::vector<Change> changes = replay(synthesize(3.0, sweep, 20.0, 10.0, 300.0), verbose);
+    int reversals = 0;
+    for (size_t i = 1; i < changes.size(); i++) {
+        reversals += changes[i].value < changes[i - 1].value ? 1 : 0;
+    }
+    bool ok = reversals == 0 && changes.back().value == PotFilter::MAX_VALUE;
+    char detail[96];
+    snprintf(detail, sizeof(detail), "%zu changes, %d reversals (want 0), final %d", changes.size(), reversals,
+             changes.back().value);
+    return check("sweep", ok, detail);
+}
+
+static bool endpoints(bool verbose) {
+    // Creeping into each rail: the last step onto 0 or 4095 is smaller
+    // than the hysteresis, and the endpoint rule must still let it through
+    std::vector<Change> changes = replay(synthesize(2.0, approach, 3.0, 0.0, 0.0), verbose);
+    bool low = false;
+    bool high = false;
+    for (const Change& change : changes) {
+        low |= change.t < 1.0 && change.value == 0;
+        high |= change.t >= 1.0 && change.value == PotFilter::MAX_VALUE;
+    }
+    char detail[96];
+    snprintf(detail, sizeof(detail), "0 %s, 4095 %s", low ? "reached" : "missed", high ? "reached" : "missed");
+    return check("endpoints", low && high, detail);
+}
+
+static int replayFile(const char* path, bool verbose) {
+    FILE* in = fopen(path, "r");
+    if (!in) {
+        fprintf(stderr, "Can't open %s\n", path);
+        return 1;
+    }
+    std::vector<int> conversions;
+    int raw;
+    while (fscanf(in, "%d", &raw) == 1) {
+        conversions.push_back(raw);
+    }
+    fclose(in);
+
+    std::vector<Change> changes = replay(conversions, verbose);
+    int largestReversal = 0;
+    for (size_t i = 2; i < changes.size(); i++) {
+        int before = changes[i - 1].value - changes[i - 2].value;
+        int now = changes[i].value - changes[i - 1].value;
+        if ((before > 0) != (now > 0)) {
+            int size = abs(now);
+            largestReversal = size > largestReversal ? size : largestReversal;
+        }
+    }
+    printf("%s: %zu conversions (%.2f s), %zu changes, largest reversal %d\n", path, conversions.size(),
+           conversions.size() / CONVERSION_HZ, changes.size(), largestReversal);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    bool verbose = false;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0) {
+            verbose = true;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (path) {
+        return replayFile(path, verbose);
+    }
+
+    bool ok = true;
+    //                name           target    sigma  hum   spike
+    ok &= rest("rest-quiet",  middle,   4.0,  0.0,    0.0, verbose);
+    ok &= rest("rest-noisy",  lowRest, 30.0, 20.0,  400.0, verbose);
+    ok &= stepResponse(verbose);
+    ok &= sweepResponse(verbose);
+    ok &= endpoints(verbose);
+    return ok ? 0 : 1;
+}
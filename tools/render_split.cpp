@@ -0,0 +1,231 @@
+/**
+ * render_split - host threads through the dual-core render split
+ *
+ * Build (host):
+ *   g++ -O2 -std=c++17 -pthread -I lib/AudioEngine tools/render_split.cpp -o render_split
+ *
+ * Usage:
+ *   render_split [blocks]
+ *
+ * Three checks, with std::thread standing in for the two cores:
+ *   barrier   two and three parties reuse one SpinBarrier for `blocks`
+ *             rounds (default 200000); after every round each party must
+ *             see what all the others wrote before it, and none may get
+ *             a round ahead
+ *   split     the engine's block loop: the main thread wakes a worker,
+ *             each renders its group of toy voices into a private buffer,
+ *             they join, and the sum must match a single-threaded render
+ *             sample for sample
+ *   policy    RenderPolicy in AUTO: voice threshold, UI load hysteresis,
+ *             backoff after late blocks lasting the same time at every
+ *             block size, and a mode requested from another thread taken
+ *             up on the next block
+ * Exits non-zero if any fails. Build with -fsanitize=thread to have the
+ * barrier's ordering checked as well.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "Parallel/SpinBarrier.h"
+#include "Parallel/RenderPolicy.h"
+
+static bool check(const char* name, bool ok, const char* detail) {
+    printf("%-4s %-14s %s\n", ok ? "ok" : "FAIL", name, detail);
+    return ok;
+}
+
+// ==========================================
+// BARRIER
+// ==========================================
+static bool barrierRounds(int parties, long rounds) {
+    SpinBarrier barrier(parties);
+    std::vector<long> written(parties, -1);     // Plain writes: the barrier must order them
+    std::atomic<bool> ok(true);
+
+    auto party = [&](int self) {
+        for (long round = 0; round < rounds; round++) {
+            written[self] = round;
+            barrier.arriveAndWait();
+            for (int other = 0; other < parties; other++) {
+                if (written[other] != round) {
+                    ok.store(false);
+                }
+            }
+            barrier.arriveAndWait();            // Nobody writes the next round before all have read
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < parties; i++) {
+        threads.emplace_back(party, i);
+    }
+    party(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    char name[32];
+    char detail[64];
+    snprintf(name, sizeof(name), "barrier-%d", parties);
+    snprintf(detail, sizeof(detail), "%ld rounds", rounds);
+    return check(name, ok.load(), detail);
+}
+
+// ==========================================
+// SPLIT RENDER
+// ==========================================
+static const int VOICES = 8;
+static const int FRAMES = 128;
+
+// A toy voice: deterministic, different per voice and block
+static float voiceSample(int voice, long block, int frame) {
+    return sinf(0.01f * (voice + 1) * (block * FRAMES + frame)) * (voice + 1) / VOICES;
+}
+
+static void renderGroup(int group, long block, float* out) {
+    for (int i = 0; i < FRAMES; i++) {
+        out[i] = 0.0f;
+    }
+    for (int voice = 0; voice < VOICES; voice++) {
+        if (RenderPolicy::groupOf(voice) != group) {
+            continue;
+        }
+        for (int i = 0; i < FRAMES; i++) {
+            out[i] += voiceSample(voice, block, i);
+        }
+    }
+}
+
+static bool splitRender(long blocks) {
+    SpinBarrier barrier(RenderPolicy::GROUPS);
+    float groups[RenderPolicy::GROUPS][FRAMES];
+    std::atomic<long> wake(-1);                 // Stands in for the worker's task notification
+    long mismatches = 0;
+
+    std::thread worker([&]() {
+        for (long block = 0; block < blocks; block++) {
+            while (wake.load(std::memory_order_acquire) != block) {
+                std::this_thread::yield();
+            }
+            renderGroup(1, block, groups[1]);
+            barrier.arriveAndWait();
+        }
+    });
+
+    float reference[RenderPolicy::GROUPS][FRAMES];
+    for (long block = 0; block < blocks; block++) {
+        wake.store(block, std::memory_order_release);
+        renderGroup(0, block, groups[0]);
+        barrier.arriveAndWait();
+
+        renderGroup(0, block, reference[0]);
+        renderGroup(1, block, reference[1]);
+        for (int i = 0; i < FRAMES; i++) {
+            if (groups[0][i] + groups[1][i] != reference[0][i] + reference[1][i]) {
+                mismatches++;
+            }
+        }
+    }
+    worker.join();
+
+    int perGroup[RenderPolicy::GROUPS] = { 0, 0 };
+    for (int voice = 0; voice < VOICES; voice++) {
+        perGroup[RenderPolicy::groupOf(voice)]++;
+    }
+
+    char detail[96];
+    snprintf(detail, sizeof(detail), "%ld blocks, %ld samples differ, voices %d + %d", blocks, mismatches,
+             perGroup[0], perGroup[1]);
+    return check("split", mismatches == 0 && perGroup[0] == perGroup[1], detail);
+}
+
+// ==========================================
+// POLICY
+// ==========================================
+// Frames from the first late report until decide() splits again
+static uint32_t backoffFrames(uint32_t blockFrames) {
+    RenderPolicy policy;
+    policy.request(RenderPolicy::AUTO);
+    policy.decide(4, 0, blockFrames);
+    for (int i = 0; i < RenderPolicy::MAX_LATE_BLOCKS; i++) {
+        policy.reportWorker(true);
+    }
+    uint32_t frames = 0;
+    while (!policy.decide(4, 0, blockFrames) && frames < SAMPLE_RATE * 60) {
+        frames += blockFrames;
+    }
+    return frames;
+}
+
+static bool policyChecks() {
+    bool ok = true;
+    char detail[96];
+
+    RenderPolicy policy;
+    bool defaultSingle = !policy.decide(8, 0, 128);
+    policy.request(RenderPolicy::AUTO);
+    bool fewVoices = !policy.decide(RenderPolicy::MIN_VOICES - 1, 0, 128);
+    bool enoughVoices = policy.decide(RenderPolicy::MIN_VOICES, 0, 128);
+    snprintf(detail, sizeof(detail), "default single %s, %d voices single %s, %d split %s",
+             defaultSingle ? "yes" : "no", RenderPolicy::MIN_VOICES - 1, fewVoices ? "yes" : "no",
+             RenderPolicy::MIN_VOICES, enoughVoices ? "yes" : "no");
+    ok &= check("policy-voices", defaultSingle && fewVoices && enoughVoices, detail);
+
+    // Busy above 300, idle again only below 150
+    static const uint32_t loads[] = { 100, 350, 200, 160, 140, 250 };
+    static const bool expected[] = { true, false, false, false, true, true };
+    bool hysteresis = true;
+    for (size_t i = 0; i < sizeof(loads) / sizeof(loads[0]); i++) {
+        hysteresis &= policy.decide(4, loads[i], 128) == expected[i];
+    }
+    ok &= check("policy-ui", hysteresis, "falls back above 30% UI load, returns below 15%");
+
+    // A few late blocks are tolerated; the run that triggers the backoff
+    // holds it for BACKOFF_FRAMES whatever the block size
+    policy.reportWorker(true);
+    policy.reportWorker(false);
+    bool tolerated = policy.decide(4, 0, 128);
+    uint32_t small = backoffFrames(64);
+    uint32_t large = backoffFrames(256);
+    bool timed = small >= RenderPolicy::BACKOFF_FRAMES && small < RenderPolicy::BACKOFF_FRAMES + 64 &&
+                 large >= RenderPolicy::BACKOFF_FRAMES && large < RenderPolicy::BACKOFF_FRAMES + 256;
+    snprintf(detail, sizeof(detail), "%.2f s at 64-frame blocks, %.2f s at 256%s", (double)small / SAMPLE_RATE,
+             (double)large / SAMPLE_RATE, tolerated ? "" : ", backed off on one late block");
+    ok &= check("policy-backoff", tolerated && timed, detail);
+
+    // Requested from the console task while the audio task decides. What
+    // decide() returns while the request is in flight may go either way,
+    // so only the decisions before the thread starts and after it has
+    // joined are checked; the ones in between give TSan the overlap
+    RenderPolicy shared;
+    bool before = !shared.decide(0, 0, 128);
+    std::atomic<bool> requested(false);
+    std::thread console([&]() {
+        shared.request(RenderPolicy::DUAL_CORE);
+        requested.store(true, std::memory_order_release);
+    });
+    long blocks = 0;
+    while (!requested.load(std::memory_order_acquire)) {
+        shared.decide(0, 0, 128);
+        blocks++;
+    }
+    console.join();
+    bool taken = shared.decide(0, 0, 128);
+    snprintf(detail, sizeof(detail), "single before, dual on the next block (%ld decided meanwhile)", blocks);
+    ok &= check("policy-request", before && taken, detail);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    long blocks = argc > 1 ? atol(argv[1]) : 200000;
+
+    bool ok = true;
+    ok &= barrierRounds(2, blocks);
+    ok &= barrierRounds(3, blocks / 4);
+    ok &= splitRender(blocks / 10);
+    ok &= policyChecks();
+    return ok ? 0 : 1;
+}
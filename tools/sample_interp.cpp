@@ -0,0 +1,121 @@
+/**
+ * sample_interp - checks SamplePlayer's interpolation at full scale
+ *
+ * Build (host):
+ *   g++ -O2 -std=c++17 -fsanitize=undefined -I lib/AudioEngine tools/sample_interp.cpp \
+ *       lib/AudioEngine/Sampler/SamplePlayer.cpp -o sample_interp
+ *
+ * Usage:
+ *   sample_interp [-v]
+ *
+ * Plays worst-case PCM16 data - neighbours at opposite full scale, so
+ * b - a reaches +-65535 - at a spread of pitches, looped and one-shot,
+ * and compares every output with linear interpolation computed in double
+ * at the player's own position. Output must stay within the 16-bit
+ * fraction's rounding (2 LSB) of it and inside the two source samples.
+ * Build with -fsanitize=undefined to have any overflow in the fixed-point
+ * path reported as well. -v prints the worst error of each case.
+ */
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include "Sampler/SamplePlayer.h"
+#include "../include/Consts.h"
+
+struct Case {
+    const char* name;
+    int pattern;            // 0: +FS/-FS square, 1: -FS/+FS pairs, 2: FS square held 3 frames
+    float ratio;            // Playback frequency / root
+    bool looped;
+};
+
+static int16_t patternSample(int pattern, uint32_t i) {
+    switch (pattern) {
+        case 0:  return (i & 1) ? -32768 : 32767;
+        case 1:  return (i & 2) ? 32767 : -32768;
+        default: return ((i / 3) & 1) ? -32768 : 32767;
+    }
+}
+
+static bool run(const Case& c, bool verbose) {
+    static const uint32_t LENGTH = 1000;
+    std::vector<int16_t> data(LENGTH);
+    for (uint32_t i = 0; i < LENGTH; i++) {
+        data[i] = patternSample(c.pattern, i);
+    }
+
+    SampleInfo info;
+    memset(&info, 0, sizeof(info));
+    info.length = LENGTH;
+    info.sampleRate = SAMPLE_RATE;
+    info.rootFrequency = 440.0f;
+    info.format = SAMPLE_FORMAT_PCM16;
+    if (c.looped) {
+        info.loopStart = 1;         // Wraps from -FS/+FS onto the other sign
+        info.loopEnd = LENGTH - 2;
+    }
+
+    SamplePlayer player;
+    player.setSample(&info, (const uint8_t*)data.data());
+    player.setFrequency(440.0f * c.ratio);
+    player.trigger();
+
+    // Mirror of the player's position, 32.32, stepped as setFrequency() does
+    const uint64_t increment = (uint64_t)((double)(440.0f * c.ratio) / 440.0f * 1.0f * 4294967296.0);
+    uint64_t position = 0;
+    double worst = 0.0;
+    bool bounded = true;
+    int samples = 0;
+    while (player.isPlaying() && samples < 20000) {
+        uint32_t index = (uint32_t)(position >> 32);
+        uint32_t next = index + 1;
+        if (c.looped && next >= info.loopEnd) {
+            next = info.loopStart;
+        }
+        double a = data[index];
+        double b = data[next];
+        double t = (double)(uint32_t)position / 4294967296.0;
+        double expected = a + (b - a) * t;
+
+        double value = player.getSample() * 32768.0;
+        double error = fabs(value - expected);
+        worst = error > worst ? error : worst;
+        bounded &= value >= (a < b ? a : b) && value <= (a < b ? b : a);
+
+        position += increment;
+        if (c.looped) {
+            while ((uint32_t)(position >> 32) >= info.loopEnd) {
+                position -= (uint64_t)(info.loopEnd - info.loopStart) << 32;
+            }
+        }
+        samples++;
+    }
+
+    bool ok = worst <= 2.0 && bounded && samples > 0;
+    printf("%-4s %-20s %5d samples", ok ? "ok" : "FAIL", c.name, samples);
+    if (verbose || !ok) {
+        printf("  worst error %.3f LSB%s", worst, bounded ? "" : "  (outside the source samples)");
+    }
+    printf("\n");
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    bool verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+
+    static const Case cases[] = {
+        // name                 pattern  ratio      looped
+        { "square-slow",          0,     0.0137f,   false },
+        { "square-near-unity",    0,     0.99991f,  true  },
+        { "pairs-detuned",        1,     1.4983f,   true  },
+        { "held-low",             2,     0.25003f,  true  },
+        { "square-fast",          0,     3.7771f,   true  },
+    };
+
+    bool ok = true;
+    for (const Case& c : cases) {
+        ok &= run(c, verbose);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+/**
+ * seq_timing - checks that sequencer steps land on the exact sample
+ *
+ * Build (host):
+ *   g++ -O2 -std=c++17 -I lib/AudioEngine tools/seq_timing.cpp \
+ *       lib/AudioEngine/Sequencer/Sequencer.cpp -o seq_timing
+ *
+ * Usage:
+ *   seq_timing [hours]
+ *
+ * Runs the Sequencer block by block for `hours` of audio (default 6) at
+ * several tempos, with the block size changing as it goes, and compares
+ * every note-on against the exact step start floor(k * rate * 60000 /
+ * (milliBpm * stepsPerBeat)) computed in 64-bit integers. Gate releases
+ * are checked against their step too. Exits non-zero on the first sample
+ * that is off.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include "Sequencer/Sequencer.h"
+
+static bool run(uint32_t milliBpm, uint32_t stepsPerBeat, uint32_t gatePermille, double hours) {
+    Sequencer sequencer;
+    sequencer.setTempo(milliBpm, stepsPerBeat);
+    sequencer.setGate(gatePermille);
+    sequencer.setMode(Sequencer::ARP_UP);       // No rests: every step is a note-on
+
+    const uint64_t numerator = (uint64_t)SAMPLE_RATE * 60000u;
+    const uint64_t denominator = (uint64_t)milliBpm * stepsPerBeat;
+    const uint64_t wholeStep = numerator / denominator;
+    const uint64_t gateSamples = wholeStep * gatePermille / 1000;
+    const uint64_t total = (uint64_t)(hours * 3600.0 * SAMPLE_RATE);
+
+    // Block sizes the engine could use, cycled so offsets cover every phase
+    static const int blockSizes[] = {BLOCK_FRAMES, 64, 256, 37, 512, 1};
+    Sequencer::Event events[Sequencer::MAX_EVENTS];
+
+    uint64_t sample = 0;
+    uint64_t step = 0;
+    uint64_t releases = 0;
+    int block = 0;
+    while (sample < total) {
+        int frames = blockSizes[block++ % 6];
+        int count = sequencer.process(frames, events, Sequencer::MAX_EVENTS);
+        for (int i = 0; i < count; i++) {
+            uint64_t at = sample + events[i].offset;
+            if (events[i].noteOn) {
+                uint64_t expected = step * numerator / denominator;
+                if (at != expected) {
+                    printf("FAIL %u.%03u BPM /%u: step %llu at sample %llu, expected %llu\n",
+                           milliBpm / 1000, milliBpm % 1000, stepsPerBeat,
+                           (unsigned long long)step, (unsigned long long)at, (unsigned long long)expected);
+                    return false;
+                }
+                step++;
+            } else {
+                uint64_t expected = (step - 1) * numerator / denominator + gateSamples;
+                if (at != expected) {
+                    printf("FAIL %u.%03u BPM /%u: release %llu at sample %llu, expected %llu\n",
+                           milliBpm / 1000, milliBpm % 1000, stepsPerBeat,
+                           (unsigned long long)(step - 1), (unsigned long long)at, (unsigned long long)expected);
+                    return false;
+                }
+                releases++;
+            }
+        }
+        sample += frames;
+    }
+
+    printf("ok   %3u.%03u BPM /%-2u gate %4u: %llu steps, %llu releases over %.1f h, all on the sample\n",
+           milliBpm / 1000, milliBpm % 1000, stepsPerBeat, gatePermille,
+           (unsigned long long)step, (unsigned long long)releases, hours);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const double hours = argc > 1 ? atof(argv[1]) : 6.0;
+
+    bool ok = true;
+    ok &= run(120000, 4, 500, hours);       // 5512.5 samples per step
+    ok &= run(133000, 4, 250, hours);       // Non-terminating fraction
+    ok &= run(97531, 3, 900, hours);
+    ok &= run(400000, 16, 100, hours);      // Shortest step the clock allows
+    ok &= run(20000, 1, 990, hours);        // Longest
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+/**
+ * trace_extract - cuts a "prof dump" Chrome trace out of a serial log
+ *
+ * Build (host):
+ *   g++ -O2 -std=c++17 tools/trace_extract.cpp -o trace_extract
+ *
+ * Usage:
+ *   trace_extract [log] > trace.json
+ *
+ * Reads the log (default stdin), finds the last BEGIN TRACE / END TRACE
+ * pair printed by "prof dump" (env:esp32-s3-profile) and writes the JSON
+ * between them. Line prefixes added by the monitor's "time" filter
+ * ("12:34:56.789 > ") or the simulator ("  1.234 > ") are removed. Open
+ * the result in chrome://tracing or ui.perfetto.dev.
+ */
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+static const char* stripPrefix(const char* line) {
+    // Digits, ':', '.' and spaces, then "> "
+    const char* c = line;
+    while (*c == ' ' || *c == ':' || *c == '.' || (*c >= '0' && *c <= '9')) {
+        c++;
+    }
+    if (c != line && c[0] == '>' && c[1] == ' ') {
+        return c + 2;
+    }
+    return line;
+}
+
+int main(int argc, char** argv) {
+    FILE* in = argc > 1 ? fopen(argv[1], "r") : stdin;
+    if (!in) {
+        fprintf(stderr, "Can't open %s\n", argv[1]);
+        return 1;
+    }
+
+    std::string trace;
+    std::string current;
+    bool inside = false;
+    bool complete = false;
+    char line[1024];
+    while (fgets(line, sizeof(line), in)) {
+        const char* text = stripPrefix(line);
+        if (strstr(text, "----- BEGIN TRACE -----") == text) {
+            inside = true;
+            current.clear();
+        } else if (strstr(text, "----- END TRACE -----") == text) {
+            if (inside) {
+                trace = current;
+                complete = true;
+            }
+            inside = false;
+        } else if (inside) {
+            current += text;
+        }
+    }
+    if (in != stdin) {
+        fclose(in);
+    }
+
+    if (!complete) {
+        fprintf(stderr, "No complete trace in the log (run \"prof start\", then \"prof dump\")\n");
+        return 1;
+    }
+    fputs(trace.c_str(), stdout);
+    return 0;
+}